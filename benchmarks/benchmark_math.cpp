@@ -0,0 +1,325 @@
+/**
+ * @file benchmark_math.cpp
+ * @brief Compares scalar and SIMD versions of the Math layer kernels.
+ *
+ * Each kernel runs once with Vector<3> and Point<3>, one primitive at a
+ * time, and once with Simd::Vector3x4, four primitives per call. Both
+ * versions perform the same operations on the same data, so their results
+ * are checked to match before the timings are printed.
+ *
+ * Build with -mavx or -march=native to measure the AVX code path; other
+ * x86-64 builds use SSE2.
+ */
+
+#include "Math/Point.hpp"
+#include "Math/Vector.hpp"
+#include "Math/Vector3x4.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using Raytracer::Math::Point;
+using Raytracer::Math::Vector;
+using Raytracer::Math::Simd::Double4;
+using Raytracer::Math::Simd::Vector3x4;
+
+constexpr std::size_t PRIMITIVE_COUNT = 4096;
+constexpr std::size_t RAY_COUNT = 256;
+constexpr std::size_t WIDTH = Double4::WIDTH;
+constexpr int REPEATS = 7;
+constexpr double T_MIN = 1e-4;
+constexpr double T_MAX = 1e9;
+
+/**
+ * @struct Triangles
+ * @brief Triangles stored both one by one and four per block.
+ */
+struct Triangles {
+  std::vector<Point<3>> v0;
+  std::vector<Vector<3>> e1;
+  std::vector<Vector<3>> e2;
+  std::vector<std::array<std::array<double, WIDTH>, 9>> blocks;
+};
+
+/**
+ * @struct Spheres
+ * @brief Spheres stored both one by one and four per block.
+ */
+struct Spheres {
+  std::vector<Point<3>> centers;
+  std::vector<double> radii;
+  std::vector<std::array<std::array<double, WIDTH>, 4>> blocks;
+};
+
+/**
+ * @struct Rays
+ * @brief Ray origins and directions aimed at the primitives.
+ */
+struct Rays {
+  std::vector<Point<3>> origins;
+  std::vector<Vector<3>> directions;
+};
+
+Triangles makeTriangles(std::mt19937 &rng) {
+  std::uniform_real_distribution<double> position(-1.0, 1.0);
+  std::uniform_real_distribution<double> edge(-0.5, 0.5);
+  Triangles triangles;
+  triangles.blocks.resize(PRIMITIVE_COUNT / WIDTH);
+  for (std::size_t i = 0; i < PRIMITIVE_COUNT; ++i) {
+    triangles.v0.emplace_back(position(rng), position(rng), position(rng));
+    triangles.e1.emplace_back(edge(rng), edge(rng), edge(rng));
+    triangles.e2.emplace_back(edge(rng), edge(rng), edge(rng));
+    auto &block = triangles.blocks[i / WIDTH];
+    for (std::size_t axis = 0; axis < 3; ++axis) {
+      block[axis][i % WIDTH] = triangles.v0[i].m_components[axis];
+      block[3 + axis][i % WIDTH] = triangles.e1[i].m_components[axis];
+      block[6 + axis][i % WIDTH] = triangles.e2[i].m_components[axis];
+    }
+  }
+  return triangles;
+}
+
+Spheres makeSpheres(std::mt19937 &rng) {
+  std::uniform_real_distribution<double> position(-1.0, 1.0);
+  std::uniform_real_distribution<double> radius(0.05, 0.3);
+  Spheres spheres;
+  spheres.blocks.resize(PRIMITIVE_COUNT / WIDTH);
+  for (std::size_t i = 0; i < PRIMITIVE_COUNT; ++i) {
+    spheres.centers.emplace_back(position(rng), position(rng), position(rng));
+    spheres.radii.push_back(radius(rng));
+    auto &block = spheres.blocks[i / WIDTH];
+    for (std::size_t axis = 0; axis < 3; ++axis) {
+      block[axis][i % WIDTH] = spheres.centers[i].m_components[axis];
+    }
+    block[3][i % WIDTH] = spheres.radii[i];
+  }
+  return spheres;
+}
+
+Rays makeRays(std::mt19937 &rng) {
+  std::uniform_real_distribution<double> spread(-1.0, 1.0);
+  Rays rays;
+  for (std::size_t i = 0; i < RAY_COUNT; ++i) {
+    rays.origins.emplace_back(spread(rng), spread(rng), -5.0);
+    rays.directions.push_back(
+        Vector<3>(spread(rng) * 0.2, spread(rng) * 0.2, 1.0).normalize());
+  }
+  return rays;
+}
+
+/**
+ * @brief Möller–Trumbore test of a ray against one triangle.
+ * @return true if the ray hits the triangle within its distance range.
+ */
+bool hitTriangle(const Point<3> &origin, const Vector<3> &direction,
+                 const Point<3> &v0, const Vector<3> &e1,
+                 const Vector<3> &e2) {
+  Vector<3> p = direction.cross(e2);
+  double det = e1.dot(p);
+  if (std::abs(det) < 1e-8) {
+    return false;
+  }
+  double invDet = 1.0 / det;
+  Vector<3> s = origin - v0;
+  double u = s.dot(p) * invDet;
+  if (u < 0.0 || u > 1.0) {
+    return false;
+  }
+  Vector<3> q = s.cross(e1);
+  double v = direction.dot(q) * invDet;
+  if (v < 0.0 || u + v > 1.0) {
+    return false;
+  }
+  double t = e2.dot(q) * invDet;
+  return t > T_MIN && t < T_MAX;
+}
+
+/**
+ * @brief Möller–Trumbore test of a ray against four triangles.
+ * @return One bit per triangle the ray hits within its distance range.
+ */
+unsigned hitTriangles(const Vector3x4 &origin, const Vector3x4 &direction,
+                      const std::array<std::array<double, WIDTH>, 9> &block) {
+  const Vector3x4 v0 =
+      Vector3x4::load(block[0].data(), block[1].data(), block[2].data());
+  const Vector3x4 e1 =
+      Vector3x4::load(block[3].data(), block[4].data(), block[5].data());
+  const Vector3x4 e2 =
+      Vector3x4::load(block[6].data(), block[7].data(), block[8].data());
+
+  Vector3x4 p = direction.cross(e2);
+  Double4 det = e1.dot(p);
+  Double4 valid = det.abs() >= Double4(1e-8);
+  Double4 invDet = Double4(1.0) / det;
+  Vector3x4 s = origin - v0;
+  Double4 u = s.dot(p) * invDet;
+  valid = valid & (u >= Double4(0.0)) & (u <= Double4(1.0));
+  Vector3x4 q = s.cross(e1);
+  Double4 v = direction.dot(q) * invDet;
+  valid = valid & (v >= Double4(0.0)) & (u + v <= Double4(1.0));
+  Double4 t = e2.dot(q) * invDet;
+  valid = valid & (t > Double4(T_MIN)) & (t < Double4(T_MAX));
+  return valid.mask();
+}
+
+/**
+ * @brief Test a ray against one sphere, as SpherePlugin does.
+ * @return true if the nearer root lies within the ray's distance range.
+ */
+bool hitSphere(const Point<3> &origin, const Vector<3> &direction,
+               const Point<3> &center, double radius) {
+  Vector<3> oc = origin - center;
+  double a = direction.dot(direction);
+  double b = 2.0 * oc.dot(direction);
+  double c = oc.dot(oc) - radius * radius;
+  double delta = b * b - 4 * a * c;
+  if (delta < 0) {
+    return false;
+  }
+  double t = (-b - std::sqrt(delta)) / (2.0 * a);
+  return t >= T_MIN && t <= T_MAX;
+}
+
+/**
+ * @brief Test a ray against four spheres.
+ * @return One bit per sphere whose nearer root lies within the range.
+ */
+unsigned hitSpheres(const Vector3x4 &origin, const Vector3x4 &direction,
+                    const std::array<std::array<double, WIDTH>, 4> &block) {
+  const Vector3x4 center =
+      Vector3x4::load(block[0].data(), block[1].data(), block[2].data());
+  const Double4 radius = Double4::load(block[3].data());
+
+  Vector3x4 oc = origin - center;
+  Double4 a = direction.dot(direction);
+  Double4 b = Double4(2.0) * oc.dot(direction);
+  Double4 c = oc.dot(oc) - radius * radius;
+  Double4 delta = b * b - Double4(4.0) * a * c;
+  Double4 valid = delta >= Double4(0.0);
+  Double4 t = (Double4(0.0) - b - delta.sqrt()) / (Double4(2.0) * a);
+  valid = valid & (t >= Double4(T_MIN)) & (t <= Double4(T_MAX));
+  return valid.mask();
+}
+
+/**
+ * @brief Time one run of a workload.
+ * @param work Workload returning the number of tests it performed and the
+ * number of hits it found.
+ * @return Tests per second and hits.
+ */
+template <typename Work> std::pair<double, std::size_t> rate(Work &&work) {
+  auto start = std::chrono::steady_clock::now();
+  const auto [tests, hits] = work();
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return {static_cast<double>(tests) / elapsed.count(), hits};
+}
+
+/**
+ * @brief Run a scalar and a SIMD workload alternately and print the best
+ * rate of each.
+ *
+ * Runs alternate so that frequency changes or noisy neighbours hit both
+ * alike.
+ * @param name Name of the kernel.
+ * @param scalar Workload processing one primitive at a time.
+ * @param simd Workload processing four primitives at a time.
+ * @return false if the workloads disagree on the number of hits.
+ */
+template <typename Scalar, typename Simd>
+bool compare(const char *name, Scalar &&scalar, Simd &&simd) {
+  double scalarRate = 0.0;
+  double simdRate = 0.0;
+  std::size_t scalarHits = 0;
+  std::size_t simdHits = 0;
+  for (int i = 0; i < REPEATS; ++i) {
+    auto [scalarResult, scalarCount] = rate(scalar);
+    auto [simdResult, simdCount] = rate(simd);
+    scalarRate = std::max(scalarRate, scalarResult);
+    simdRate = std::max(simdRate, simdResult);
+    scalarHits = scalarCount;
+    simdHits = simdCount;
+  }
+  std::printf("%20s %14.0f %14.0f %8.2f\n", name, scalarRate, simdRate,
+              simdRate / scalarRate);
+  if (scalarHits != simdHits) {
+    std::fprintf(stderr, "%s: %zu scalar hits, %zu SIMD hits\n", name,
+                 scalarHits, simdHits);
+    return false;
+  }
+  return true;
+}
+
+} // namespace
+
+int main() {
+  std::mt19937 rng(7);
+  const Triangles triangles = makeTriangles(rng);
+  const Spheres spheres = makeSpheres(rng);
+  const Rays rays = makeRays(rng);
+  bool agree = true;
+
+  std::printf("%20s %14s %14s %8s\n", "kernel", "scalar /s", "simd /s",
+              "speedup");
+
+  agree &= compare(
+      "ray-triangle",
+      [&] {
+        std::size_t hits = 0;
+        for (std::size_t r = 0; r < RAY_COUNT; ++r) {
+          for (std::size_t i = 0; i < PRIMITIVE_COUNT; ++i) {
+            hits += hitTriangle(rays.origins[r], rays.directions[r],
+                                triangles.v0[i], triangles.e1[i],
+                                triangles.e2[i]);
+          }
+        }
+        return std::pair(RAY_COUNT * PRIMITIVE_COUNT, hits);
+      },
+      [&] {
+        std::size_t hits = 0;
+        for (std::size_t r = 0; r < RAY_COUNT; ++r) {
+          const Vector3x4 origin(rays.origins[r]);
+          const Vector3x4 direction(rays.directions[r]);
+          for (const auto &block : triangles.blocks) {
+            hits += static_cast<std::size_t>(
+                std::popcount(hitTriangles(origin, direction, block)));
+          }
+        }
+        return std::pair(RAY_COUNT * PRIMITIVE_COUNT, hits);
+      });
+
+  agree &= compare(
+      "ray-sphere",
+      [&] {
+        std::size_t hits = 0;
+        for (std::size_t r = 0; r < RAY_COUNT; ++r) {
+          for (std::size_t i = 0; i < PRIMITIVE_COUNT; ++i) {
+            hits += hitSphere(rays.origins[r], rays.directions[r],
+                              spheres.centers[i], spheres.radii[i]);
+          }
+        }
+        return std::pair(RAY_COUNT * PRIMITIVE_COUNT, hits);
+      },
+      [&] {
+        std::size_t hits = 0;
+        for (std::size_t r = 0; r < RAY_COUNT; ++r) {
+          const Vector3x4 origin(rays.origins[r]);
+          const Vector3x4 direction(rays.directions[r]);
+          for (const auto &block : spheres.blocks) {
+            hits += static_cast<std::size_t>(
+                std::popcount(hitSpheres(origin, direction, block)));
+          }
+        }
+        return std::pair(RAY_COUNT * PRIMITIVE_COUNT, hits);
+      });
+
+  return agree ? 0 : 84;
+}
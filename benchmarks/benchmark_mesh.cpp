@@ -0,0 +1,200 @@
+/**
+ * @file benchmark_mesh.cpp
+ * @brief Measures ObjectPlugin ray throughput against mesh triangle count.
+ *
+ * Icospheres of increasing subdivision level are written to temporary OBJ
+ * files, loaded through ObjectPlugin and hit with random rays aimed at the
+ * mesh. Rays per second should fall roughly logarithmically with the
+ * triangle count.
+ *
+ * Every mesh is traced in double and in single precision. The table gives
+ * both throughputs, the memory of the triangle blocks and hierarchy per
+ * triangle, and the number of rays whose closest hit differs between the
+ * two modes.
+ */
+
+#include "../plugins/ObjectPlugin.hpp"
+#include "Core/Ray.hpp"
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using Raytracer::Math::Point;
+using Raytracer::Math::Vector;
+
+constexpr std::size_t RAY_COUNT = 200000;
+constexpr int MAX_LEVEL = 7;
+
+/**
+ * @brief Write a unit icosphere subdivided @p level times as an OBJ file.
+ * @param path Destination file.
+ * @param level Number of subdivisions.
+ */
+void writeIcosphere(const std::filesystem::path &path, int level) {
+  const double t = (1.0 + std::sqrt(5.0)) / 2.0;
+  std::vector<Point<3>> vertices = {
+      {-1.0, t, 0.0},  {1.0, t, 0.0},   {-1.0, -t, 0.0}, {1.0, -t, 0.0},
+      {0.0, -1.0, t},  {0.0, 1.0, t},   {0.0, -1.0, -t}, {0.0, 1.0, -t},
+      {t, 0.0, -1.0},  {t, 0.0, 1.0},   {-t, 0.0, -1.0}, {-t, 0.0, 1.0}};
+  std::vector<std::array<int, 3>> faces = {
+      {0, 11, 5}, {0, 5, 1},  {0, 1, 7},   {0, 7, 10}, {0, 10, 11},
+      {1, 5, 9},  {5, 11, 4}, {11, 10, 2}, {10, 7, 6}, {7, 1, 8},
+      {3, 9, 4},  {3, 4, 2},  {3, 2, 6},   {3, 6, 8},  {3, 8, 9},
+      {4, 9, 5},  {2, 4, 11}, {6, 2, 10},  {8, 6, 7},  {9, 8, 1}};
+
+  for (int l = 0; l < level; ++l) {
+    std::map<std::pair<int, int>, int> midpoints;
+    auto midpoint = [&](int a, int b) {
+      auto key = std::minmax(a, b);
+      auto it = midpoints.find(key);
+      if (it != midpoints.end()) {
+        return it->second;
+      }
+      const Point<3> &pa = vertices[a];
+      const Point<3> &pb = vertices[b];
+      vertices.emplace_back(
+          (pa.m_components[0] + pb.m_components[0]) / 2.0,
+          (pa.m_components[1] + pb.m_components[1]) / 2.0,
+          (pa.m_components[2] + pb.m_components[2]) / 2.0);
+      int index = static_cast<int>(vertices.size()) - 1;
+      midpoints.emplace(key, index);
+      return index;
+    };
+
+    std::vector<std::array<int, 3>> refined;
+    for (const auto &face : faces) {
+      int ab = midpoint(face[0], face[1]);
+      int bc = midpoint(face[1], face[2]);
+      int ca = midpoint(face[2], face[0]);
+      refined.push_back({face[0], ab, ca});
+      refined.push_back({face[1], bc, ab});
+      refined.push_back({face[2], ca, bc});
+      refined.push_back({ab, bc, ca});
+    }
+    faces = std::move(refined);
+  }
+
+  std::ofstream out(path);
+  for (const auto &vertex : vertices) {
+    Vector<3> direction(vertex.m_components[0], vertex.m_components[1],
+                        vertex.m_components[2]);
+    direction /= direction.length();
+    out << "v " << direction.m_components[0] << ' ' << direction.m_components[1]
+        << ' ' << direction.m_components[2] << '\n';
+  }
+  for (const auto &face : faces) {
+    out << "f " << face[0] + 1 << ' ' << face[1] + 1 << ' ' << face[2] + 1
+        << '\n';
+  }
+}
+
+/**
+ * @brief Generate random rays from a surrounding sphere towards the mesh.
+ * @return Rays aimed at the unit cube around the origin.
+ */
+std::vector<Raytracer::Core::Ray> makeRays() {
+  std::mt19937 rng(42);
+  std::normal_distribution<double> gaussian(0.0, 1.0);
+  std::uniform_real_distribution<double> jitter(-0.8, 0.8);
+
+  std::vector<Raytracer::Core::Ray> rays;
+  rays.reserve(RAY_COUNT);
+  for (std::size_t i = 0; i < RAY_COUNT; ++i) {
+    Vector<3> onSphere(gaussian(rng), gaussian(rng), gaussian(rng));
+    onSphere /= onSphere.length();
+    Point<3> origin = Point<3>(0.0, 0.0, 0.0) + onSphere * 3.0;
+    Point<3> target(jitter(rng), jitter(rng), jitter(rng));
+    rays.emplace_back(origin, target - origin);
+  }
+  return rays;
+}
+
+/**
+ * @brief Trace rays against a mesh.
+ * @param object Mesh to trace against.
+ * @param rays Rays to trace.
+ * @return Rays traced per second and the fraction of rays that hit.
+ */
+std::pair<double, double>
+measure(const ObjectPlugin &object,
+        const std::vector<Raytracer::Core::Ray> &rays) {
+  std::size_t hits = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (const auto &ray : rays) {
+    if (object.intersect(ray)) {
+      ++hits;
+    }
+  }
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return {static_cast<double>(rays.size()) / elapsed.count(),
+          static_cast<double>(hits) / static_cast<double>(rays.size())};
+}
+
+/**
+ * @brief Count the rays whose closest hit differs between two meshes.
+ * @param lhs First mesh.
+ * @param rhs Second mesh.
+ * @param rays Rays to trace.
+ * @return Number of rays hitting only one mesh or at different distances.
+ */
+std::size_t countMismatches(const ObjectPlugin &lhs, const ObjectPlugin &rhs,
+                            const std::vector<Raytracer::Core::Ray> &rays) {
+  std::size_t mismatches = 0;
+  for (const auto &ray : rays) {
+    const auto a = lhs.intersect(ray);
+    const auto b = rhs.intersect(ray);
+    if (a.has_value() != b.has_value() ||
+        (a && a->getDistance() != b->getDistance())) {
+      ++mismatches;
+    }
+  }
+  return mismatches;
+}
+
+} // namespace
+
+int main() {
+  const auto directory = std::filesystem::temp_directory_path();
+  const std::vector<Raytracer::Core::Ray> rays = makeRays();
+
+  std::printf("%10s %14s %14s %8s %10s %10s %8s %8s\n", "triangles",
+              "double rays/s", "single rays/s", "speedup", "double B/t",
+              "single B/t", "hit %", "differ");
+  for (int level = 0; level <= MAX_LEVEL; ++level) {
+    const auto path =
+        directory / ("raytracer_icosphere_" + std::to_string(level) + ".obj");
+    writeIcosphere(path, level);
+
+    ObjectPlugin object;
+    ObjectPlugin single;
+    single.setPrecision(ObjectPlugin::Precision::Single);
+    if (!object.loadFromFile(path.string()) ||
+        !single.loadFromFile(path.string())) {
+      std::fprintf(stderr, "Failed to load %s\n", path.c_str());
+      return 84;
+    }
+    auto [raysPerSecond, hitRate] = measure(object, rays);
+    auto [singleRaysPerSecond, singleHitRate] = measure(single, rays);
+    (void)singleHitRate;
+    const auto triangles = static_cast<double>(object.getTriangleCount());
+    std::printf("%10zu %14.0f %14.0f %8.2f %10.1f %10.1f %8.1f %8zu\n",
+                object.getTriangleCount(), raysPerSecond, singleRaysPerSecond,
+                singleRaysPerSecond / raysPerSecond,
+                static_cast<double>(object.getAccelerationBytes()) / triangles,
+                static_cast<double>(single.getAccelerationBytes()) / triangles,
+                hitRate * 100.0, countMismatches(object, single, rays));
+    std::filesystem::remove(path);
+  }
+  return 0;
+}
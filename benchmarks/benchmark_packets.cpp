@@ -0,0 +1,227 @@
+/**
+ * @file benchmark_packets.cpp
+ * @brief Compares single-ray and packet queries on camera and shadow rays.
+ *
+ * A field of spheres is viewed through a pinhole camera. Camera rays are
+ * traced one by one with findNearestIntersection() and eight at a time
+ * along each row with findNearestIntersections(); shadow rays from every
+ * lit hit towards one point light go through hasIntersection() and
+ * findOccluded() the same way. Both workloads report rays per second,
+ * shadow rays included.
+ */
+
+#include "../plugins/SpherePlugin.hpp"
+#include "Core/Intersection.hpp"
+#include "Core/Ray.hpp"
+#include "Core/Scene.hpp"
+#include "Math/Rectangle.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <optional>
+#include <random>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using Raytracer::Core::Intersection;
+using Raytracer::Core::Ray;
+using Raytracer::Core::Scene;
+using Raytracer::Math::Point;
+using Raytracer::Math::Vector;
+
+constexpr std::size_t WIDTH = 640;
+constexpr std::size_t HEIGHT = 360;
+constexpr std::size_t SPHERE_COUNT = 2000;
+constexpr int REPEATS = 7;
+constexpr double SHADOW_EPSILON = 1e-4;
+const Point<3> LIGHT_POSITION(0.0, 20.0, 0.0);
+
+/**
+ * @brief Fill a scene with randomly placed spheres in front of the camera.
+ * @param scene Scene to fill and compile.
+ */
+void buildScene(Scene &scene) {
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<double> lateral(-15.0, 15.0);
+  std::uniform_real_distribution<double> depth(8.0, 40.0);
+  std::uniform_real_distribution<double> radius(0.2, 1.0);
+
+  for (std::size_t i = 0; i < SPHERE_COUNT; ++i) {
+    auto sphere = std::make_unique<Raytracer::Plugins::SpherePlugin>();
+    sphere->setCenter(Point<3>(lateral(rng), lateral(rng), depth(rng)));
+    sphere->setRadius(radius(rng));
+    scene.addPrimitive("sphere" + std::to_string(i), std::move(sphere));
+  }
+  scene.setCamera(Raytracer::Core::Camera(
+      Point<3>(0.0, 0.0, 0.0),
+      Raytracer::Math::Rectangle3D(Point<3>(-1.0, -0.5625, 1.0),
+                                   Vector<3>(2.0, 0.0, 0.0),
+                                   Vector<3>(0.0, 1.125, 0.0)),
+      90.0 * M_PI / 180.0));
+  scene.compile();
+}
+
+/**
+ * @brief Generate the camera rays of the frame in row order.
+ * @param scene Scene whose camera is used.
+ * @return One ray per pixel.
+ */
+std::vector<Ray> cameraRays(const Scene &scene) {
+  using ClampedDouble = Raytracer::Utility::Clamped<double, 0.0, 1.0>;
+
+  std::vector<Ray> rays;
+  rays.reserve(WIDTH * HEIGHT);
+  for (std::size_t y = 0; y < HEIGHT; ++y) {
+    for (std::size_t x = 0; x < WIDTH; ++x) {
+      ClampedDouble u(static_cast<double>(x) / (WIDTH - 1));
+      ClampedDouble v(1.0 - static_cast<double>(y) / (HEIGHT - 1));
+      rays.push_back(scene.getCamera().ray(u, v));
+    }
+  }
+  return rays;
+}
+
+/**
+ * @brief Build the shadow ray a flat material casts from a hit.
+ * @param hit Surface hit by a camera ray.
+ * @param shadow Set to the ray towards the light.
+ * @return false if the surface faces away from the light.
+ */
+bool shadowRay(const Intersection &hit, Ray &shadow) {
+  Vector<3> toLight = LIGHT_POSITION - hit.getPoint();
+  toLight /= toLight.length();
+  if (hit.getNormal().dot(toLight) <= 0.0) {
+    return false;
+  }
+  Point<3> origin = hit.getPoint() + hit.getNormal() * SHADOW_EPSILON;
+  shadow = Ray(origin, toLight, SHADOW_EPSILON,
+               (LIGHT_POSITION - origin).length());
+  return true;
+}
+
+/**
+ * @brief Trace the frame one ray at a time.
+ * @param scene Scene to trace.
+ * @param rays Camera rays.
+ * @param shadows Whether lit hits also cast a shadow ray.
+ * @return Number of rays traced.
+ */
+std::size_t traceSingle(const Scene &scene, const std::vector<Ray> &rays,
+                        bool shadows) {
+  std::size_t traced = 0;
+  for (const Ray &ray : rays) {
+    std::optional<Intersection> hit = scene.findNearestIntersection(ray);
+    ++traced;
+    Ray shadow;
+    if (shadows && hit && shadowRay(*hit, shadow)) {
+      (void)scene.hasIntersection(shadow);
+      ++traced;
+    }
+  }
+  return traced;
+}
+
+/**
+ * @brief Trace the frame in packets of adjacent pixels.
+ * @param scene Scene to trace.
+ * @param rays Camera rays.
+ * @param shadows Whether lit hits also cast a shadow ray.
+ * @return Number of rays traced.
+ */
+std::size_t tracePackets(const Scene &scene, const std::vector<Ray> &rays,
+                         bool shadows) {
+  std::size_t traced = 0;
+  std::array<std::optional<Intersection>, Scene::PACKET_SIZE> hits;
+  std::array<Ray, Scene::PACKET_SIZE> shadowRays;
+
+  for (std::size_t first = 0; first < rays.size();
+       first += Scene::PACKET_SIZE) {
+    const std::size_t count =
+        std::min(Scene::PACKET_SIZE, rays.size() - first);
+    scene.findNearestIntersections(
+        std::span<const Ray>(rays).subspan(first, count), hits);
+    traced += count;
+    if (!shadows) {
+      continue;
+    }
+
+    std::size_t shadowCount = 0;
+    for (std::size_t lane = 0; lane < count; ++lane) {
+      if (hits[lane] && shadowRay(*hits[lane], shadowRays[shadowCount])) {
+        ++shadowCount;
+      }
+    }
+    (void)scene.findOccluded(
+        std::span<const Ray>(shadowRays.data(), shadowCount));
+    traced += shadowCount;
+  }
+  return traced;
+}
+
+/**
+ * @brief Time one run of a workload.
+ * @param trace Workload returning the number of rays it traced.
+ * @return Rays traced per second.
+ */
+template <typename Trace> double raysPerSecond(Trace &&trace) {
+  auto start = std::chrono::steady_clock::now();
+  const std::size_t traced = trace();
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return static_cast<double>(traced) / elapsed.count();
+}
+
+/**
+ * @brief Run both variants of a workload, keeping the fastest run of each.
+ *
+ * Runs alternate between the variants so that frequency changes or noisy
+ * neighbours hit both alike.
+ * @param scene Scene to trace.
+ * @param rays Camera rays.
+ * @param shadows Whether lit hits also cast a shadow ray.
+ * @return Best single-ray and packet rays per second.
+ */
+std::pair<double, double> measure(const Scene &scene,
+                                  const std::vector<Ray> &rays,
+                                  bool shadows) {
+  double single = 0.0;
+  double packet = 0.0;
+  for (int i = 0; i < REPEATS; ++i) {
+    single = std::max(single, raysPerSecond([&] {
+                        return traceSingle(scene, rays, shadows);
+                      }));
+    packet = std::max(packet, raysPerSecond([&] {
+                        return tracePackets(scene, rays, shadows);
+                      }));
+  }
+  return {single, packet};
+}
+
+} // namespace
+
+int main() {
+  Scene scene;
+  buildScene(scene);
+  if (!scene.isCompiled()) {
+    std::fprintf(stderr, "Failed to compile the scene\n");
+    return 84;
+  }
+  const std::vector<Ray> rays = cameraRays(scene);
+
+  std::printf("%16s %14s %14s %8s\n", "workload", "single rays/s",
+              "packet rays/s", "speedup");
+  for (bool shadows : {false, true}) {
+    auto [single, packet] = measure(scene, rays, shadows);
+    std::printf("%16s %14.0f %14.0f %8.2f\n",
+                shadows ? "primary+shadow" : "primary", single, packet,
+                packet / single);
+  }
+  return 0;
+}
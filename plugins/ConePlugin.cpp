@@ -1,5 +1,6 @@
 #include "ConePlugin.hpp"
 #include "Parser/SceneParser.hpp"
+#include <limits>
 
 namespace Raytracer::Plugins {
 
@@ -42,13 +43,27 @@ void ConePlugin::setAxisPositionRadiusHeight(const std::string &axis,
 
 std::optional<Core::Intersection>
 ConePlugin::intersect(const Core::Ray &ray) const noexcept {
-  Core::Ray localRay = getTransform().inverseTransformRay(ray);
+  Core::HitRecord hit;
+  if (!findHit(ray, hit)) {
+    return std::nullopt;
+  }
+  return computeIntersection(ray, hit);
+}
+
+int ConePlugin::getAxisIndex() const noexcept {
+  return m_axis.m_components[0] == 1.0
+             ? 0
+             : (m_axis.m_components[1] == 1.0 ? 1 : 2);
+}
+
+int ConePlugin::findSurface(const Core::Ray &localRay, double &bestT,
+                            bool anyHit) const noexcept {
   Math::Point<3> o = localRay.getOrigin();
   Math::Vector<3> d = localRay.getDirection();
+  const double minT = localRay.getMinDistance();
+  const double maxT = localRay.getMaxDistance();
 
-  int axisIdx = m_axis.m_components[0] == 1.0
-                    ? 0
-                    : (m_axis.m_components[1] == 1.0 ? 1 : 2);
+  int axisIdx = getAxisIndex();
 
   const auto &oa = o.m_components[axisIdx];
   const auto &da = d.m_components[axisIdx];
@@ -63,11 +78,8 @@ ConePlugin::intersect(const Core::Ray &ray) const noexcept {
   double B = 2.0 * (op1 * dp1 + op2 * dp2 - k2 * oa * da);
   double C = op1 * op1 + op2 * op2 - k2 * oa * oa;
 
-  double bestT = std::numeric_limits<double>::infinity();
-  Math::Point<3> bestPt;
-  Math::Vector<3> bestNormal;
-  Math::Point<2> bestUV;
-  bool isInside = false;
+  // Surface 0 is the lateral surface, surface 1 the base disc.
+  int bestSurface = -1;
 
   if (std::abs(A) > 1e-10) {
     double disc = B * B - 4.0 * A * C;
@@ -76,38 +88,16 @@ ConePlugin::intersect(const Core::Ray &ray) const noexcept {
       double tVals[2] = {(-B - sqrtDisc) / (2.0 * A),
                          (-B + sqrtDisc) / (2.0 * A)};
       for (double t : tVals) {
-        if (t < localRay.getMinDistance() || t > localRay.getMaxDistance() ||
-            t >= bestT)
+        if (t < minT || t > maxT || t >= bestT)
           continue;
-        Math::Point<3> p = localRay.at(t);
-        double axVal = p.m_components[axisIdx];
+        double axVal = localRay.at(t).m_components[axisIdx];
         if (axVal < 0.0 || axVal > m_height)
           continue;
 
         bestT = t;
-        bestPt = p;
-
-        Math::Vector<3> n{0.0, 0.0, 0.0};
-        double nz = -k2 * p.m_components[axisIdx];
-        n.m_components[axisIdx] = nz;
-        n.m_components[(axisIdx + 1) % 3] = p.m_components[(axisIdx + 1) % 3];
-        n.m_components[(axisIdx + 2) % 3] = p.m_components[(axisIdx + 2) % 3];
-        n /= n.length();
-        bestNormal = n;
-
-        double u;
-        if (axisIdx == 0)
-          u = std::atan2(p.m_components[2], p.m_components[1]) / (2 * M_PI);
-        else if (axisIdx == 1)
-          u = std::atan2(p.m_components[0], p.m_components[2]) / (2 * M_PI);
-        else
-          u = std::atan2(p.m_components[1], p.m_components[0]) / (2 * M_PI);
-        if (u < 0.0)
-          u += 1.0;
-
-        double v = axVal / m_height;
-        bestUV = Math::Point<2>{u, v};
-        isInside = false;
+        bestSurface = 0;
+        if (anyHit)
+          return bestSurface;
       }
     }
   }
@@ -115,69 +105,106 @@ ConePlugin::intersect(const Core::Ray &ray) const noexcept {
   if (std::abs(da) > 1e-10) {
     double t = (m_height - oa) / da;
 
-    if (t >= localRay.getMinDistance() && t <= localRay.getMaxDistance() &&
-        t < bestT) {
+    if (t >= minT && t <= maxT && t < bestT) {
       Math::Point<3> p = localRay.at(t);
 
       double dx = p.m_components[(axisIdx + 1) % 3];
       double dy = p.m_components[(axisIdx + 2) % 3];
       if (dx * dx + dy * dy <= m_radius * m_radius) {
         bestT = t;
-        bestPt = p;
-
-        bestNormal = Math::Vector<3>{0.0, 0.0, 0.0};
-        bestNormal.m_components[axisIdx] = 1.0;
-
-        double r = std::sqrt(dx * dx + dy * dy) / m_radius;
-        double ang = std::atan2(dy, dx) / (2 * M_PI);
-        if (ang < 0.0)
-          ang += 1.0;
-        bestUV = Math::Point<2>{r * std::cos(ang * 2 * M_PI),
-                                r * std::sin(ang * 2 * M_PI)};
-        isInside = da > 0.0;
+        bestSurface = 1;
       }
     }
   }
+  return bestSurface;
+}
+
+bool ConePlugin::findHit(const Core::Ray &ray,
+                         Core::HitRecord &hit) const noexcept {
+  double t = hit.t;
+  int surface = findSurface(getTransform().inverseTransformRay(ray), t, false);
+  if (surface < 0)
+    return false;
+  hit = Core::HitRecord{};
+  hit.t = t;
+  hit.primitive = this;
+  hit.index = static_cast<std::uint32_t>(surface);
+  return true;
+}
 
-  if (bestT < std::numeric_limits<double>::infinity()) {
-    Math::Point<3> worldPt = getTransform().transformPoint(bestPt);
-    Math::Vector<3> worldN = getTransform().transformNormal(bestNormal);
-    worldN /= worldN.length();
-    double worldDist = (worldPt - ray.getOrigin()).length();
+Core::Intersection
+ConePlugin::computeIntersection(const Core::Ray &ray,
+                                const Core::HitRecord &hit) const noexcept {
+  Core::Ray localRay = getTransform().inverseTransformRay(ray);
+  int axisIdx = getAxisIndex();
+  double da = localRay.getDirection().m_components[axisIdx];
+
+  Math::Point<3> p = localRay.at(hit.t);
+  Math::Vector<3> normal{0.0, 0.0, 0.0};
+  Math::Point<2> uv;
+  bool isInside = false;
 
-    return Core::Intersection(worldPt, worldN, getMaterial(), worldDist,
-                              isInside, bestUV);
+  if (hit.index == 0) {
+    double k = m_radius / m_height;
+    double k2 = k * k;
+    normal.m_components[axisIdx] = -k2 * p.m_components[axisIdx];
+    normal.m_components[(axisIdx + 1) % 3] = p.m_components[(axisIdx + 1) % 3];
+    normal.m_components[(axisIdx + 2) % 3] = p.m_components[(axisIdx + 2) % 3];
+    normal /= normal.length();
+
+    double u;
+    if (axisIdx == 0)
+      u = std::atan2(p.m_components[2], p.m_components[1]) / (2 * M_PI);
+    else if (axisIdx == 1)
+      u = std::atan2(p.m_components[0], p.m_components[2]) / (2 * M_PI);
+    else
+      u = std::atan2(p.m_components[1], p.m_components[0]) / (2 * M_PI);
+    if (u < 0.0)
+      u += 1.0;
+
+    uv = Math::Point<2>{u, p.m_components[axisIdx] / m_height};
+  } else {
+    double dx = p.m_components[(axisIdx + 1) % 3];
+    double dy = p.m_components[(axisIdx + 2) % 3];
+    normal.m_components[axisIdx] = 1.0;
+
+    double r = std::sqrt(dx * dx + dy * dy) / m_radius;
+    double ang = std::atan2(dy, dx) / (2 * M_PI);
+    if (ang < 0.0)
+      ang += 1.0;
+    uv = Math::Point<2>{r * std::cos(ang * 2 * M_PI),
+                        r * std::sin(ang * 2 * M_PI)};
+    isInside = da > 0.0;
   }
-  return std::nullopt;
+
+  Math::Point<3> worldPt = getTransform().transformPoint(p);
+  Math::Vector<3> worldN = getTransform().transformNormal(normal);
+  worldN /= worldN.length();
+  double worldDist = (worldPt - ray.getOrigin()).length();
+
+  return Core::Intersection(worldPt, worldN, getMaterial().get(), worldDist,
+                            isInside, uv);
+}
+
+bool ConePlugin::occluded(const Core::Ray &ray) const noexcept {
+  double t = std::numeric_limits<double>::infinity();
+  return findSurface(getTransform().inverseTransformRay(ray), t, true) >= 0;
 }
 
 Core::BoundingBox ConePlugin::getBoundingBox() const noexcept {
-  Math::Point<3> baseCenter = m_position + m_axis * m_height;
-
-  Math::Point<3> min, max;
-  if (m_axis.m_components[0] == 1.0) {
-    min = Math::Point<3>{m_position.m_components[0],
-                         baseCenter.m_components[1] - m_radius,
-                         baseCenter.m_components[2] - m_radius};
-    max = Math::Point<3>{baseCenter.m_components[0],
-                         baseCenter.m_components[1] + m_radius,
-                         baseCenter.m_components[2] + m_radius};
-  } else if (m_axis.m_components[1] == 1.0) {
-    min = Math::Point<3>{baseCenter.m_components[0] - m_radius,
-                         m_position.m_components[1],
-                         baseCenter.m_components[2] - m_radius};
-    max = Math::Point<3>{baseCenter.m_components[0] + m_radius,
-                         baseCenter.m_components[1],
-                         baseCenter.m_components[2] + m_radius};
-  } else {
-    min = Math::Point<3>{baseCenter.m_components[0] - m_radius,
-                         baseCenter.m_components[1] - m_radius,
-                         m_position.m_components[2]};
-    max = Math::Point<3>{baseCenter.m_components[0] + m_radius,
-                         baseCenter.m_components[1] + m_radius,
-                         baseCenter.m_components[2]};
+  // intersect() places the apex at the local origin and the base disc at
+  // m_height along the axis.
+  Math::Vector<3> extent{m_radius, m_radius, m_radius};
+  for (std::size_t i = 0; i < 3; ++i) {
+    if (m_axis.m_components[i] == 1.0) {
+      extent.m_components[i] = 0.0;
+    }
   }
-  return Core::BoundingBox(min, max);
+  Math::Point<3> baseCenter = Math::Point<3>{0.0, 0.0, 0.0} + m_axis * m_height;
+
+  Math::Point<3> min = Math::Point<3>{0.0, 0.0, 0.0} - extent;
+  Math::Point<3> max = baseCenter + extent;
+  return getTransform().transformBoundingBox(Core::BoundingBox(min, max));
 }
 
 } // namespace Raytracer::Plugins
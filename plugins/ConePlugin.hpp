@@ -41,6 +41,17 @@ public:
    */
   bool configure(const libconfig::Setting &config) override;
 
+  /**
+   * @brief Set the axis, apex position, radius and height of the Cone
+   * @param axis The axis direction ("X", "Y", or "Z")
+   * @param position The apex position
+   * @param radius The radius of the base
+   * @param height The height from apex to base
+   */
+  void setAxisPositionRadiusHeight(const std::string &axis,
+                                   const Math::Point<3> &position,
+                                   double radius, double height) noexcept;
+
   /**
    * @brief Calculate the axis-aligned bounding box for this Cone
    * @return The bounding box that represents this Cone
@@ -56,6 +67,32 @@ public:
   [[nodiscard]] std::optional<Core::Intersection>
   intersect(const Core::Ray &ray) const noexcept override;
 
+  /**
+   * @brief Check whether a ray hits this cone, without shading data
+   * @param ray The ray to test for intersection
+   * @return True if the ray hits the cone within its distance range
+   */
+  [[nodiscard]] bool occluded(const Core::Ray &ray) const noexcept override;
+
+  /**
+   * @brief Find the ray parameter of the closest hit with this cone
+   * @param ray The ray to test for intersection
+   * @param hit The closest hit so far, updated if this cone is closer
+   * @return True if the hit record was updated
+   */
+  [[nodiscard]] bool findHit(const Core::Ray &ray,
+                             Core::HitRecord &hit) const noexcept override;
+
+  /**
+   * @brief Compute the surface data of a hit found by findHit
+   * @param ray The ray that was passed to findHit
+   * @param hit The hit record filled in by this cone
+   * @return The intersection data at the hit
+   */
+  [[nodiscard]] Core::Intersection
+  computeIntersection(const Core::Ray &ray,
+                      const Core::HitRecord &hit) const noexcept override;
+
   /**
    * @brief Get the axis vector of the Cone
    * @return The normalized axis vector
@@ -66,15 +103,21 @@ public:
 
 private:
   /**
-   * @brief Set the axis, apex position, radius and height of the Cone
-   * @param axis The axis direction ("X", "Y", or "Z")
-   * @param position The apex position
-   * @param radius The radius of the base
-   * @param height The height from apex to base
+   * @brief Index of the coordinate the Cone axis is aligned with
+   * @return 0, 1 or 2 for the X, Y or Z axis
    */
-  void setAxisPositionRadiusHeight(const std::string &axis,
-                                   const Math::Point<3> &position,
-                                   double radius, double height) noexcept;
+  [[nodiscard]] int getAxisIndex() const noexcept;
+
+  /**
+   * @brief Find the surface of this Cone a local-space ray hits
+   * @param localRay The ray, in the Cone's local space
+   * @param bestT Hits must be closer than this, set to the hit found
+   * @param anyHit Stop at the first hit instead of the closest one
+   * @return 0 for the lateral surface, 1 for the base disc, -1 if nothing was
+   * hit
+   */
+  [[nodiscard]] int findSurface(const Core::Ray &localRay, double &bestT,
+                                bool anyHit) const noexcept;
 
   Math::Vector<3> m_axis{0.0, 1.0, 0.0};
   Math::Point<3> m_position{};
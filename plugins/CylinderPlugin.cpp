@@ -1,5 +1,6 @@
 #include "CylinderPlugin.hpp"
 #include "Parser/SceneParser.hpp"
+#include <limits>
 
 namespace Raytracer::Plugins {
 
@@ -51,158 +52,179 @@ const Math::Point<3> &CylinderPlugin::getPosition() const noexcept {
 
 [[nodiscard]] std::optional<Core::Intersection>
 CylinderPlugin::intersect(const Core::Ray &ray) const noexcept {
-  Core::Ray localRay = getTransform().inverseTransformRay(ray);
+  Core::HitRecord hit;
+  if (!findHit(ray, hit)) {
+    return std::nullopt;
+  }
+  return computeIntersection(ray, hit);
+}
+
+int CylinderPlugin::getAxisIndex() const noexcept {
+  if (m_normal.m_components[0] == 1.0)
+    return 0;
+  if (m_normal.m_components[1] == 1.0)
+    return 1;
+  return 2;
+}
+
+int CylinderPlugin::findSurface(const Core::Ray &localRay, double &bestT,
+                                bool anyHit) const noexcept {
   Math::Point<3> origin = localRay.getOrigin();
   Math::Vector<3> direction = localRay.getDirection();
   Math::Vector<3> oc = origin - m_position;
+  const double minT = localRay.getMinDistance();
+  const double maxT = localRay.getMaxDistance();
 
-  double bestT = std::numeric_limits<double>::infinity();
-  Math::Point<3> localIntersectionPoint;
-  Math::Vector<3> localNormal;
-  Math::Point<2> uvCoords;
-  bool isInside = false;
+  const int axisIndex = getAxisIndex();
+  const int first = (axisIndex + 1) % 3;
+  const int second = (axisIndex + 2) % 3;
 
-  int axisIndex = -1;
-  if (m_normal.m_components[0] == 1.0)
-    axisIndex = 0;
-  else if (m_normal.m_components[1] == 1.0)
-    axisIndex = 1;
-  else
-    axisIndex = 2;
-
-  double a, b, c;
-  if (axisIndex == 0) {
-    a = direction.m_components[1] * direction.m_components[1] +
-        direction.m_components[2] * direction.m_components[2];
-    b = 2.0 * (oc.m_components[1] * direction.m_components[1] +
-               oc.m_components[2] * direction.m_components[2]);
-    c = oc.m_components[1] * oc.m_components[1] +
-        oc.m_components[2] * oc.m_components[2] - m_radius * m_radius;
-  } else if (axisIndex == 1) {
-    a = direction.m_components[0] * direction.m_components[0] +
-        direction.m_components[2] * direction.m_components[2];
-    b = 2.0 * (oc.m_components[0] * direction.m_components[0] +
-               oc.m_components[2] * direction.m_components[2]);
-    c = oc.m_components[0] * oc.m_components[0] +
-        oc.m_components[2] * oc.m_components[2] - m_radius * m_radius;
-  } else {
-    a = direction.m_components[0] * direction.m_components[0] +
-        direction.m_components[1] * direction.m_components[1];
-    b = 2.0 * (oc.m_components[0] * direction.m_components[0] +
-               oc.m_components[1] * direction.m_components[1]);
-    c = oc.m_components[0] * oc.m_components[0] +
-        oc.m_components[1] * oc.m_components[1] - m_radius * m_radius;
-  }
+  // Surfaces are numbered 0 and 1 for the two side roots, then 2 and 3 for
+  // the bottom and top caps; computeIntersection() shades from that index.
+  int bestSurface = -1;
+
+  double a = direction.m_components[first] * direction.m_components[first] +
+             direction.m_components[second] * direction.m_components[second];
+  double b = 2.0 * (oc.m_components[first] * direction.m_components[first] +
+                    oc.m_components[second] * direction.m_components[second]);
+  double c = oc.m_components[first] * oc.m_components[first] +
+             oc.m_components[second] * oc.m_components[second] -
+             m_radius * m_radius;
 
   double delta = b * b - 4 * a * c;
   if (delta >= 0 && std::abs(a) > 1e-10) {
-    double t1 = (-b - std::sqrt(delta)) / (2.0 * a);
-    double t2 = (-b + std::sqrt(delta)) / (2.0 * a);
-
-    double candidateT[2] = {t1, t2};
+    double candidateT[2] = {(-b - std::sqrt(delta)) / (2.0 * a),
+                            (-b + std::sqrt(delta)) / (2.0 * a)};
     for (int i = 0; i < 2; i++) {
       double t = candidateT[i];
-
-      if (t >= localRay.getMinDistance() && t <= localRay.getMaxDistance() &&
-          t < bestT) {
-        Math::Point<3> point = localRay.at(t);
-        double axisValue =
-            point.m_components[axisIndex] - m_position.m_components[axisIndex];
-
+      if (t >= minT && t <= maxT && t < bestT) {
+        double axisValue = localRay.at(t).m_components[axisIndex] -
+                           m_position.m_components[axisIndex];
         if (axisValue >= -m_height / 2 && axisValue <= m_height / 2) {
           bestT = t;
-          localIntersectionPoint = point;
-
-          localNormal = Math::Vector<3>{0.0, 0.0, 0.0};
-          for (int j = 0; j < 3; j++) {
-            if (j != axisIndex) {
-              localNormal.m_components[j] =
-                  localIntersectionPoint.m_components[j] -
-                  m_position.m_components[j];
-            }
-          }
-          localNormal /= localNormal.length();
-
-          double u;
-          if (axisIndex == 0) {
-            u = std::atan2(localNormal.m_components[2],
-                           localNormal.m_components[1]) /
-                (2 * M_PI);
-          } else if (axisIndex == 1) {
-            u = std::atan2(localNormal.m_components[0],
-                           localNormal.m_components[2]) /
-                (2 * M_PI);
-          } else {
-            u = std::atan2(localNormal.m_components[1],
-                           localNormal.m_components[0]) /
-                (2 * M_PI);
+          bestSurface = i;
+          if (anyHit) {
+            return bestSurface;
           }
-          if (u < 0)
-            u += 1.0;
-
-          double v = (axisValue + m_height / 2) / m_height;
-
-          uvCoords = Math::Point<2>{u, v};
-          isInside = (i == 1);
         }
       }
     }
   }
 
-  for (int i = 0; i < 2; i++) {
-    double discPosition = m_position.m_components[axisIndex] +
-                          (i == 0 ? -m_height / 2 : m_height / 2);
-
-    if (std::abs(direction.m_components[axisIndex]) < 1e-10)
-      continue;
-
-    double t = (discPosition - origin.m_components[axisIndex]) /
-               direction.m_components[axisIndex];
-
-    if (t >= localRay.getMinDistance() && t <= localRay.getMaxDistance() &&
-        t < bestT) {
-      Math::Point<3> point = localRay.at(t);
-
-      double dx = point.m_components[(axisIndex + 1) % 3] -
-                  m_position.m_components[(axisIndex + 1) % 3];
-      double dy = point.m_components[(axisIndex + 2) % 3] -
-                  m_position.m_components[(axisIndex + 2) % 3];
-      double distanceSquared = dx * dx + dy * dy;
+  if (std::abs(direction.m_components[axisIndex]) >= 1e-10) {
+    for (int i = 0; i < 2; i++) {
+      double discPosition = m_position.m_components[axisIndex] +
+                            (i == 0 ? -m_height / 2 : m_height / 2);
+      double t = (discPosition - origin.m_components[axisIndex]) /
+                 direction.m_components[axisIndex];
 
-      if (distanceSquared <= m_radius * m_radius) {
-        bestT = t;
-        localIntersectionPoint = point;
+      if (t >= minT && t <= maxT && t < bestT) {
+        Math::Point<3> point = localRay.at(t);
+        double dx = point.m_components[first] - m_position.m_components[first];
+        double dy =
+            point.m_components[second] - m_position.m_components[second];
+        if (dx * dx + dy * dy <= m_radius * m_radius) {
+          bestT = t;
+          bestSurface = 2 + i;
+          if (anyHit) {
+            return bestSurface;
+          }
+        }
+      }
+    }
+  }
+  return bestSurface;
+}
 
-        localNormal = Math::Vector<3>{0.0, 0.0, 0.0};
-        localNormal.m_components[axisIndex] = (i == 0) ? -1.0 : 1.0;
+[[nodiscard]] bool
+CylinderPlugin::findHit(const Core::Ray &ray,
+                        Core::HitRecord &hit) const noexcept {
+  double t = hit.t;
+  int surface = findSurface(getTransform().inverseTransformRay(ray), t, false);
+  if (surface < 0) {
+    return false;
+  }
+  hit = Core::HitRecord{};
+  hit.t = t;
+  hit.primitive = this;
+  hit.index = static_cast<std::uint32_t>(surface);
+  return true;
+}
 
-        double r = std::sqrt(distanceSquared) / m_radius;
-        double theta = std::atan2(dy, dx) / (2 * M_PI);
-        if (theta < 0)
-          theta += 1.0;
+[[nodiscard]] Core::Intersection
+CylinderPlugin::computeIntersection(const Core::Ray &ray,
+                                    const Core::HitRecord &hit) const noexcept {
+  Core::Ray localRay = getTransform().inverseTransformRay(ray);
+  Math::Vector<3> direction = localRay.getDirection();
+  Math::Point<3> localIntersectionPoint = localRay.at(hit.t);
+  Math::Vector<3> localNormal{0.0, 0.0, 0.0};
+  Math::Point<2> uvCoords;
+  bool isInside = false;
 
-        uvCoords = Math::Point<2>{r * std::cos(theta * 2 * M_PI),
-                                  r * std::sin(theta * 2 * M_PI)};
-        isInside = (direction.m_components[axisIndex] *
-                        localNormal.m_components[axisIndex] >
-                    0);
+  const int axisIndex = getAxisIndex();
+  if (hit.index < 2) {
+    double axisValue = localIntersectionPoint.m_components[axisIndex] -
+                       m_position.m_components[axisIndex];
+    for (int j = 0; j < 3; j++) {
+      if (j != axisIndex) {
+        localNormal.m_components[j] = localIntersectionPoint.m_components[j] -
+                                      m_position.m_components[j];
       }
     }
-  }
+    localNormal /= localNormal.length();
+
+    double u;
+    if (axisIndex == 0) {
+      u = std::atan2(localNormal.m_components[2], localNormal.m_components[1]) /
+          (2 * M_PI);
+    } else if (axisIndex == 1) {
+      u = std::atan2(localNormal.m_components[0], localNormal.m_components[2]) /
+          (2 * M_PI);
+    } else {
+      u = std::atan2(localNormal.m_components[1], localNormal.m_components[0]) /
+          (2 * M_PI);
+    }
+    if (u < 0)
+      u += 1.0;
 
-  if (bestT < std::numeric_limits<double>::infinity()) {
-    Math::Point<3> worldIntersectionPoint =
-        getTransform().transformPoint(localIntersectionPoint);
-    Math::Vector<3> worldNormal = getTransform().transformNormal(localNormal);
-    worldNormal /= worldNormal.length();
-    double worldDistance = (worldIntersectionPoint - ray.getOrigin()).length();
+    double v = (axisValue + m_height / 2) / m_height;
 
-    return Core::Intersection(worldIntersectionPoint, worldNormal,
-                              this->getMaterial(), worldDistance, isInside,
-                              uvCoords);
+    uvCoords = Math::Point<2>{u, v};
+    isInside = (hit.index == 1);
+  } else {
+    double dx = localIntersectionPoint.m_components[(axisIndex + 1) % 3] -
+                m_position.m_components[(axisIndex + 1) % 3];
+    double dy = localIntersectionPoint.m_components[(axisIndex + 2) % 3] -
+                m_position.m_components[(axisIndex + 2) % 3];
+    localNormal.m_components[axisIndex] = (hit.index == 2) ? -1.0 : 1.0;
+
+    double r = std::sqrt(dx * dx + dy * dy) / m_radius;
+    double theta = std::atan2(dy, dx) / (2 * M_PI);
+    if (theta < 0)
+      theta += 1.0;
+
+    uvCoords = Math::Point<2>{r * std::cos(theta * 2 * M_PI),
+                              r * std::sin(theta * 2 * M_PI)};
+    isInside = (direction.m_components[axisIndex] *
+                    localNormal.m_components[axisIndex] >
+                0);
   }
 
-  return std::nullopt;
+  Math::Point<3> worldIntersectionPoint =
+      getTransform().transformPoint(localIntersectionPoint);
+  Math::Vector<3> worldNormal = getTransform().transformNormal(localNormal);
+  worldNormal /= worldNormal.length();
+  double worldDistance = (worldIntersectionPoint - ray.getOrigin()).length();
+
+  return Core::Intersection(worldIntersectionPoint, worldNormal,
+                            this->getMaterial().get(), worldDistance, isInside,
+                            uvCoords);
+}
+
+[[nodiscard]] bool
+CylinderPlugin::occluded(const Core::Ray &ray) const noexcept {
+  double t = std::numeric_limits<double>::infinity();
+  return findSurface(getTransform().inverseTransformRay(ray), t, true) >= 0;
 }
 
 [[nodiscard]] Core::BoundingBox
@@ -232,7 +254,7 @@ CylinderPlugin::getBoundingBox() const noexcept {
                          m_position.m_components[2] + m_height / 2};
   }
 
-  return Core::BoundingBox(min, max);
+  return getTransform().transformBoundingBox(Core::BoundingBox(min, max));
 }
 
 } // namespace Raytracer::Plugins
@@ -73,6 +73,32 @@ public:
   [[nodiscard]] std::optional<Core::Intersection>
   intersect(const Core::Ray &ray) const noexcept override;
 
+  /**
+   * @brief Check whether a ray hits this Cylinder, without shading data
+   * @param ray The ray to test for intersection
+   * @return True if the ray hits the Cylinder within its distance range
+   */
+  [[nodiscard]] bool occluded(const Core::Ray &ray) const noexcept override;
+
+  /**
+   * @brief Find the ray parameter of the closest hit with this Cylinder
+   * @param ray The ray to test for intersection
+   * @param hit The closest hit so far, updated if this Cylinder is closer
+   * @return True if the hit record was updated
+   */
+  [[nodiscard]] bool findHit(const Core::Ray &ray,
+                             Core::HitRecord &hit) const noexcept override;
+
+  /**
+   * @brief Compute the surface data of a hit found by findHit
+   * @param ray The ray that was passed to findHit
+   * @param hit The hit record filled in by this Cylinder
+   * @return The intersection data at the hit
+   */
+  [[nodiscard]] Core::Intersection
+  computeIntersection(const Core::Ray &ray,
+                      const Core::HitRecord &hit) const noexcept override;
+
   /**
    * @brief Calculate the axis-aligned bounding box for this Cylinder
    * @return The bounding box that represents this infinite Cylinder
@@ -80,6 +106,23 @@ public:
   [[nodiscard]] Core::BoundingBox getBoundingBox() const noexcept override;
 
 private:
+  /**
+   * @brief Index of the coordinate the Cylinder axis is aligned with
+   * @return 0, 1 or 2 for the X, Y or Z axis
+   */
+  [[nodiscard]] int getAxisIndex() const noexcept;
+
+  /**
+   * @brief Find the surface of this Cylinder a local-space ray hits
+   * @param localRay The ray, in the Cylinder's local space
+   * @param bestT Hits must be closer than this, set to the hit found
+   * @param anyHit Stop at the first hit instead of the closest one
+   * @return 0 or 1 for a side root, 2 or 3 for the bottom or top cap, -1 if
+   * nothing was hit
+   */
+  [[nodiscard]] int findSurface(const Core::Ray &localRay, double &bestT,
+                                bool anyHit) const noexcept;
+
   Math::Vector<3> m_normal{0.0, 0.0, 0.0};
   Math::Point<3> m_position{0.0, 0.0, 0.0};
   double m_radius{1.0};
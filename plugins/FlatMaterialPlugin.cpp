@@ -1,5 +1,6 @@
 #include "FlatMaterialPlugin.hpp"
 #include "Core/Color.hpp"
+#include "Core/ShadowBatch.hpp"
 #include "Parser/SceneParser.hpp"
 #include "Plugin/MaterialPlugin.hpp"
 namespace Raytracer::Plugins {
@@ -28,32 +29,67 @@ bool FlatMaterialPlugin::configure(const libconfig::Setting &config) {
   return true;
 }
 
-Core::Color FlatMaterialPlugin::computeColor(
+Core::ScatterResult FlatMaterialPlugin::scatter(
     const Core::Intersection &intersection,
     [[maybe_unused]] const Core::Ray &ray,
-    const std::vector<std::shared_ptr<Core::ILight>> &lights,
-    const Core::Scene &scene) const {
-  Core::Color finalColor = Core::Black;
+    const std::vector<const Core::ILight *> &lights, const Core::Scene &scene,
+    Core::RenderContext &context) const {
+  // Terms are summed unclamped and the renderer clamps the whole path once,
+  // so weighted light samples are not clipped one by one. The wavefront
+  // path collects the terms and traces their shadow rays as packets;
+  // otherwise each one is added, or dropped, right away.
+  Core::Radiance sum{};
+  Core::ShadowBatch *batch = context.shadows;
+  auto addTerm = [&](const Core::Radiance &term) {
+    if (batch) {
+      batch->add(term);
+    } else {
+      for (std::size_t c = 0; c < sum.size(); ++c) {
+        sum[c] += term[c];
+      }
+    }
+  };
+  auto addPositional = [&](const Core::ILight &light,
+                           const Core::IPositionalLight &positionalLight,
+                           double weight) {
+    Core::Ray shadowRay;
+    std::optional<Core::Radiance> term =
+        shadePositional(intersection, positionalLight, weight, shadowRay);
+    if (!term) {
+      return;
+    }
+    if (batch) {
+      batch->add(*term, shadowRay, light);
+    } else if (!scene.hasIntersection(shadowRay, light)) {
+      addTerm(*term);
+    }
+  };
+
+  const Core::LightTree &lightTree = scene.getLightTree();
+  const std::size_t sampleCount = scene.getLightSampleCount();
+  const bool sampleLights = sampleCount > 0 && !lightTree.empty();
+  const std::vector<const Core::ILight *> &evaluated =
+      sampleLights ? lightTree.getOtherLights() : lights;
 
-  for (const auto &light : lights) {
+  for (const auto &light : evaluated) {
     const Math::Vector<3> &normal = intersection.getNormal();
 
     if (auto ambientLight =
-            std::dynamic_pointer_cast<Core::IAmbientLight>(light)) {
+            dynamic_cast<const Core::IAmbientLight *>(light)) {
       double ambientIntensity = ambientLight->getIntensity();
       const Core::Color &lightColor = ambientLight->getColor();
       Core::Color ambientColor = getAmbientColor();
 
-      Core::Color ambComp{ambientColor.getR() * getAmbientCoefficient() *
-                              ambientIntensity * lightColor.getR() / 255.0,
-                          ambientColor.getG() * getAmbientCoefficient() *
-                              ambientIntensity * lightColor.getG() / 255.0,
-                          ambientColor.getB() * getAmbientCoefficient() *
-                              ambientIntensity * lightColor.getB() / 255.0};
-      finalColor = finalColor.add(ambComp);
+      Core::Radiance ambComp{ambientColor.getR() * getAmbientCoefficient() *
+                                 ambientIntensity * lightColor.getR() / 255.0,
+                             ambientColor.getG() * getAmbientCoefficient() *
+                                 ambientIntensity * lightColor.getG() / 255.0,
+                             ambientColor.getB() * getAmbientCoefficient() *
+                                 ambientIntensity * lightColor.getB() / 255.0};
+      addTerm(ambComp);
 
     } else if (auto directionalLight =
-                   std::dynamic_pointer_cast<Core::IDirectionalLight>(light)) {
+                   dynamic_cast<const Core::IDirectionalLight *>(light)) {
       Math::Vector<3> lightDir = directionalLight->getDirection() * -1.0;
       double dotResult = normal.dot(lightDir);
 
@@ -63,53 +99,63 @@ Core::Color FlatMaterialPlugin::computeColor(
         double diffuseFactor =
             getDiffuseCoefficient() * dotResult * lightIntensity;
 
-        Core::Color diffuseComponent = getDiffuseColor();
-        diffuseComponent = Core::Color(
-            diffuseComponent.getR() * diffuseFactor * lightColor.getR() / 255.0,
-            diffuseComponent.getG() * diffuseFactor * lightColor.getG() / 255.0,
-            diffuseComponent.getB() * diffuseFactor * lightColor.getB() /
-                255.0);
-
-        finalColor = finalColor.add(diffuseComponent);
+        const Core::Color &diffuseColor = getDiffuseColor();
+        addTerm(Core::Radiance{
+            diffuseColor.getR() * diffuseFactor * lightColor.getR() / 255.0,
+            diffuseColor.getG() * diffuseFactor * lightColor.getG() / 255.0,
+            diffuseColor.getB() * diffuseFactor * lightColor.getB() / 255.0});
       }
     } else if (auto positionalLight =
-                   std::dynamic_pointer_cast<Core::IPositionalLight>(light)) {
-      Math::Vector<3> lightDir =
-          positionalLight->getDirectionFrom(intersection.getPoint());
-      double dotResult = normal.dot(lightDir);
+                   dynamic_cast<const Core::IPositionalLight *>(light)) {
+      addPositional(*light, *positionalLight, 1.0);
+    }
+  }
 
-      if (dotResult > 0.0) {
-        const double epsilon = 1e-4;
-        Math::Point<3> shadowRayOrigin =
-            intersection.getPoint() + normal * epsilon;
-        double distanceToLight =
-            (positionalLight->getPosition() - shadowRayOrigin).length();
-
-        Core::Ray shadowRay(shadowRayOrigin, lightDir, epsilon,
-                            distanceToLight);
-
-        bool inShadow = scene.hasIntersection(shadowRay);
-
-        if (!inShadow) {
-          double lightIntensity = positionalLight->getIntensity();
-          const Core::Color &lightColor = positionalLight->getColor();
-          double diffuseFactor =
-              getDiffuseCoefficient() * dotResult * lightIntensity;
-
-          Core::Color diffuseComponent = getDiffuseColor();
-          diffuseComponent =
-              Core::Color(diffuseComponent.getR() * diffuseFactor *
-                              lightColor.getR() / 255.0,
-                          diffuseComponent.getG() * diffuseFactor *
-                              lightColor.getG() / 255.0,
-                          diffuseComponent.getB() * diffuseFactor *
-                              lightColor.getB() / 255.0);
-          finalColor = finalColor.add(diffuseComponent);
-        }
-      }
+  // Sampled lights are weighted by the inverse of their probability so the
+  // unclamped sum matches the one over every light on average.
+  for (std::size_t i = 0; sampleLights && i < sampleCount; ++i) {
+    Core::LightTree::Sample sample = lightTree.sample(
+        intersection.getPoint(), intersection.getNormal(),
+        context.sampler.next1D());
+    if (!sample.light) {
+      continue;
     }
+    addPositional(*sample.light, *sample.positional,
+                  1.0 / (static_cast<double>(sampleCount) * sample.pdf));
+  }
+  return {sum};
+}
+
+std::optional<Core::Radiance> FlatMaterialPlugin::shadePositional(
+    const Core::Intersection &intersection,
+    const Core::IPositionalLight &positionalLight, double weight,
+    Core::Ray &shadowRay) const {
+  const Math::Vector<3> &normal = intersection.getNormal();
+  Math::Vector<3> lightDir =
+      positionalLight.getDirectionFrom(intersection.getPoint());
+  double dotResult = normal.dot(lightDir);
+
+  if (dotResult <= 0.0) {
+    return std::nullopt;
   }
-  return finalColor;
+
+  const double epsilon = 1e-4;
+  Math::Point<3> shadowRayOrigin = intersection.getPoint() + normal * epsilon;
+  double distanceToLight =
+      (positionalLight.getPosition() - shadowRayOrigin).length();
+
+  shadowRay = Core::Ray(shadowRayOrigin, lightDir, epsilon, distanceToLight);
+
+  double lightIntensity = positionalLight.getIntensity();
+  const Core::Color &lightColor = positionalLight.getColor();
+  double diffuseFactor =
+      getDiffuseCoefficient() * dotResult * lightIntensity * weight;
+
+  const Core::Color &diffuseColor = getDiffuseColor();
+  return Core::Radiance{
+      diffuseColor.getR() * diffuseFactor * lightColor.getR() / 255.0,
+      diffuseColor.getG() * diffuseFactor * lightColor.getG() / 255.0,
+      diffuseColor.getB() * diffuseFactor * lightColor.getB() / 255.0};
 }
 
 } // namespace Raytracer::Plugins
@@ -42,17 +42,35 @@ public:
   bool configure(const libconfig::Setting &config) override;
 
   /**
-   * @brief Compute the color resulting from lighting at an intersection.
+   * @brief Shade an intersection and list the rays it spawns.
    * @param intersection Intersection information.
    * @param ray Incoming ray.
    * @param lights Lights affecting the intersection.
    * @param scene Scene containing all objects.
-   * @return Computed color.
+   * @param context State of the path, for random decisions.
+   * @return Color of the surface and spawned rays.
    */
-  [[nodiscard]] Core::Color
-  computeColor(const Core::Intersection &intersection, const Core::Ray &ray,
-               const std::vector<std::shared_ptr<Core::ILight>> &lights,
-               const Core::Scene &scene) const override;
+  [[nodiscard]] Core::ScatterResult
+  scatter(const Core::Intersection &intersection, const Core::Ray &ray,
+          const std::vector<const Core::ILight *> &lights,
+          const Core::Scene &scene,
+          Core::RenderContext &context) const override;
+
+private:
+  /**
+   * @brief Compute the diffuse light a positional light brings to a hit.
+   * @param intersection Intersection information.
+   * @param positionalLight Light to evaluate.
+   * @param weight Factor applied to the contribution.
+   * @param shadowRay Filled with the ray deciding whether the light is
+   * visible.
+   * @return Unclamped contribution of the light, std::nullopt if the surface
+   * faces away from it.
+   */
+  [[nodiscard]] std::optional<Core::Radiance>
+  shadePositional(const Core::Intersection &intersection,
+                  const Core::IPositionalLight &positionalLight,
+                  double weight, Core::Ray &shadowRay) const;
 };
 
 } // namespace Raytracer::Plugins
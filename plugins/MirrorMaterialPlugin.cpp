@@ -1,6 +1,8 @@
 #include "MirrorMaterialPlugin.hpp"
 #include "Parser/SceneParser.hpp"
 #include "Plugin/MaterialPlugin.hpp"
+#include <algorithm>
+#include <cmath>
 
 namespace Raytracer::Plugins {
 
@@ -29,25 +31,94 @@ bool MirrorMaterialPlugin::configure(const libconfig::Setting &config) {
     this->setReflectionCoefficient(reflCoef);
     this->setRefractionCoefficient(refrCoef);
     this->setRefractiveIndex(refrIndex);
+
+    bool stochastic = false;
+    if (config.lookupValue("stochastic", stochastic)) {
+      this->setStochastic(stochastic);
+    }
   } catch (const libconfig::SettingNotFoundException &) {
   }
   return true;
 }
-Core::Color MirrorMaterialPlugin::computeColor(
+Core::ScatterResult MirrorMaterialPlugin::scatter(
     const Core::Intersection &intersection, const Core::Ray &ray,
-    const std::vector<std::shared_ptr<Core::ILight>> &lights,
-    const Core::Scene &scene) const {
+    const std::vector<const Core::ILight *> & /* lights */,
+    const Core::Scene & /* scene */, Core::RenderContext &context) const {
+  Core::Color ambient = getAmbientColor() * getAmbientCoefficient();
   if (ray.getDepth() > 5) {
-    return getAmbientColor() * getAmbientCoefficient();
+    return {ambient.toRadiance()};
+  }
+
+  Core::ScatterResult result{
+      (ambient * m_reflectionCoefficient.get()).toRadiance()};
+  double reflectWeight =
+      getDiffuseCoefficient() * m_reflectionCoefficient.get();
+  double transmissionCoef = 0.8;
+  double refractWeight = transmissionCoef * m_refractionCoefficient.get();
+  std::optional<Core::Ray> refractRay = computeRefractedRay(intersection, ray);
+
+  if (!m_stochastic || !refractRay) {
+    result.addRay(computeReflectedRay(intersection, ray), reflectWeight);
+    if (refractRay) {
+      result.addRay(*refractRay, refractWeight, ambient,
+                    m_refractionCoefficient.get());
+    }
+    return result;
+  }
+
+  // Follow a single branch, picked in proportion to its Fresnel-weighted
+  // share and scaled by the inverse of its probability, so the expected
+  // color matches tracing both while each path stays linear.
+  double reflectance = computeReflectance(intersection, ray);
+  double reflectShare = reflectance * m_reflectionCoefficient.get();
+  double refractShare = (1.0 - reflectance) * m_refractionCoefficient.get();
+  if (reflectShare + refractShare <= 0.0) {
+    return result;
+  }
+  double reflectProbability = reflectShare / (reflectShare + refractShare);
+  if (reflectShare > 0.0 && refractShare > 0.0) {
+    reflectProbability =
+        std::clamp(reflectProbability, MIN_BRANCH_PROBABILITY,
+                   1.0 - MIN_BRANCH_PROBABILITY);
   }
-  return (computeReflectedColor(intersection, ray, lights, scene) * m_reflectionCoefficient.get())
-      .add(computeRefractedColor(intersection, ray, lights, scene) * m_refractionCoefficient.get());
+
+  if (context.sampler.next1D() < reflectProbability) {
+    result.addRay(computeReflectedRay(intersection, ray),
+                  reflectWeight / reflectProbability);
+  } else {
+    double inverse = 1.0 / (1.0 - reflectProbability);
+    result.addRay(*refractRay, refractWeight * inverse, ambient,
+                  m_refractionCoefficient.get() * inverse);
+  }
+  return result;
 }
 
-Core::Color MirrorMaterialPlugin::computeReflectedColor(
-    const Core::Intersection &intersection, const Core::Ray &ray,
-    const std::vector<std::shared_ptr<Core::ILight>> &lights,
-    const Core::Scene &scene) const {
+double MirrorMaterialPlugin::computeReflectance(
+    const Core::Intersection &intersection, const Core::Ray &ray) const {
+  Math::Vector<3> direction = ray.getDirection().normalize();
+  double cosi = -intersection.getNormal().dot(direction);
+  double eta = 1.0 / m_refractiveIndex;
+
+  if (cosi < 0) {
+    cosi = -cosi;
+    eta = 1 / eta;
+  }
+
+  // Schlick's approximation, evaluated on the side of the less dense medium.
+  if (eta > 1.0) {
+    double k = 1 - eta * eta * (1 - cosi * cosi);
+    if (k < 0) {
+      return 1.0;
+    }
+    cosi = std::sqrt(k);
+  }
+  double r0 = (1.0 - m_refractiveIndex) / (1.0 + m_refractiveIndex);
+  r0 *= r0;
+  return r0 + (1.0 - r0) * std::pow(1.0 - cosi, 5.0);
+}
+
+Core::Ray MirrorMaterialPlugin::computeReflectedRay(
+    const Core::Intersection &intersection, const Core::Ray &ray) const {
 
   Math::Vector<3> normal = intersection.getNormal();
   Math::Vector<3> reflectDir =
@@ -58,25 +129,11 @@ Core::Color MirrorMaterialPlugin::computeReflectedColor(
 
   Core::Ray reflectRay(offsetPoint, reflectDir, epsilon, ray.getMaxDistance());
   reflectRay.setDepth(ray.getDepth() + 1);
-
-  std::optional<Core::Intersection> newIntersection =
-      scene.findNearestIntersection(reflectRay);
-
-  if (!newIntersection) {
-    return getAmbientColor() * getAmbientCoefficient();
-  }
-
-  Core::Color reflectedColor = newIntersection->getMaterial()->computeColor(
-      newIntersection.value(), reflectRay, lights, scene);
-
-  return (reflectedColor * getDiffuseCoefficient())
-      .add(getAmbientColor() * getAmbientCoefficient());
+  return reflectRay;
 }
 
-Core::Color MirrorMaterialPlugin::computeRefractedColor(
-    const Core::Intersection &intersection, const Core::Ray &ray,
-    const std::vector<std::shared_ptr<Core::ILight>> &lights,
-    const Core::Scene &scene) const {
+std::optional<Core::Ray> MirrorMaterialPlugin::computeRefractedRay(
+    const Core::Intersection &intersection, const Core::Ray &ray) const {
   double eta = 1.0 / m_refractiveIndex;
 
   Math::Vector<3> normal = intersection.getNormal();
@@ -92,7 +149,7 @@ Core::Color MirrorMaterialPlugin::computeRefractedColor(
   double k = 1 - eta * eta * (1 - cosi * cosi);
 
   if (k < 0) {
-    return {0, 0, 0};
+    return std::nullopt;
   }
 
   Math::Vector<3> refractDir =
@@ -104,19 +161,7 @@ Core::Color MirrorMaterialPlugin::computeRefractedColor(
 
   Core::Ray refractRay(offsetPoint, refractDir, epsilon, ray.getMaxDistance());
   refractRay.setDepth(ray.getDepth() + 1);
-
-  std::optional<Core::Intersection> newIntersection =
-      scene.findNearestIntersection(refractRay);
-
-  if (!newIntersection) {
-    return getAmbientColor() * getAmbientCoefficient();
-  }
-
-  Core::Color refractedColor = newIntersection->getMaterial()->computeColor(
-      newIntersection.value(), refractRay, lights, scene);
-
-  double transmissionCoef = 0.8;
-  return refractedColor * transmissionCoef;
+  return refractRay;
 }
 
 } // namespace Raytracer::Plugins
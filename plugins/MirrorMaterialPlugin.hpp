@@ -1,5 +1,6 @@
 #pragma once
 #include "Plugin/MaterialPlugin.hpp"
+#include <optional>
 
 namespace Raytracer::Plugins {
 
@@ -42,44 +43,19 @@ public:
   bool configure(const libconfig::Setting &config) override;
 
   /**
-   * @brief Compute the color resulting from lighting at an intersection.
+   * @brief Shade an intersection and list the rays it spawns.
    * @param intersection Intersection information.
    * @param ray Incoming ray.
    * @param lights Lights affecting the intersection.
    * @param scene Scene containing all objects.
-   * @return Computed color.
+   * @param context State of the path, for random decisions.
+   * @return Color of the surface and spawned rays.
    */
-  [[nodiscard]] Core::Color
-  computeColor(const Core::Intersection &intersection, const Core::Ray &ray,
-               const std::vector<std::shared_ptr<Core::ILight>> &lights,
-               const Core::Scene &scene) const override;
-  private:
-
-  /**
-   * @brief Compute the color resulting from reflection at an intersection.
-   * @param intersection Intersection information.
-   * @param ray Incoming ray.
-   * @param lights Lights affecting the intersection.
-   * @param scene Scene containing all objects.
-   * @return Computed color.
-   */
-  [[nodiscard]] Core::Color computeReflectedColor(
-      const Core::Intersection &intersection, const Core::Ray &ray,
-      const std::vector<std::shared_ptr<Core::ILight>> &lights,
-      const Core::Scene &scene) const;
-
-  /**
-   * @brief Compute the color resulting from refraction at an intersection.
-   * @param intersection Intersection information.
-   * @param ray Incoming ray.
-   * @param lights Lights affecting the intersection.
-   * @param scene Scene containing all objects.
-   * @return Computed color.
-   */
-  [[nodiscard]] Core::Color computeRefractedColor(
-      const Core::Intersection &intersection, const Core::Ray &ray,
-      const std::vector<std::shared_ptr<Core::ILight>> &lights,
-      const Core::Scene &scene) const;
+  [[nodiscard]] Core::ScatterResult
+  scatter(const Core::Intersection &intersection, const Core::Ray &ray,
+          const std::vector<const Core::ILight *> &lights,
+          const Core::Scene &scene,
+          Core::RenderContext &context) const override;
 
   /**
    * @brief Set the reflection coefficient.
@@ -105,9 +81,50 @@ public:
     m_refractiveIndex = index;
   }
 
+  /**
+   * @brief Trace one branch per hit instead of both.
+   * @param stochastic true to pick reflection or refraction at random.
+   */
+  void setStochastic(bool stochastic) noexcept { m_stochastic = stochastic; }
+
+  /** Lowest probability of either branch, bounding the weight of a path. */
+  static constexpr double MIN_BRANCH_PROBABILITY = 0.05;
+
+private:
+  /**
+   * @brief Build the mirror ray leaving an intersection.
+   * @param intersection Intersection information.
+   * @param ray Incoming ray.
+   * @return Reflected ray.
+   */
+  [[nodiscard]] Core::Ray
+  computeReflectedRay(const Core::Intersection &intersection,
+                      const Core::Ray &ray) const;
+
+  /**
+   * @brief Build the transmitted ray leaving an intersection.
+   * @param intersection Intersection information.
+   * @param ray Incoming ray.
+   * @return Refracted ray, or nothing on total internal reflection.
+   */
+  [[nodiscard]] std::optional<Core::Ray>
+  computeRefractedRay(const Core::Intersection &intersection,
+                      const Core::Ray &ray) const;
+
+  /**
+   * @brief Compute the share of light reflected at an intersection.
+   * @param intersection Intersection information.
+   * @param ray Incoming ray.
+   * @return Fresnel reflectance in [0, 1], 1 on total internal reflection.
+   */
+  [[nodiscard]] double
+  computeReflectance(const Core::Intersection &intersection,
+                     const Core::Ray &ray) const;
+
   Utility::Clamped<double, 0.0, 1.0> m_reflectionCoefficient{0.0};
   Utility::Clamped<double, 0.0, 1.0> m_refractionCoefficient{0.0};
   double m_refractiveIndex{1.0};
+  bool m_stochastic{false};
 };
 
 } // namespace Raytracer::Plugins
@@ -1,10 +1,12 @@
 #include "ObjectPlugin.hpp"
 #include "Parser/SceneParser.hpp"
 #include <algorithm>
+#include <bit>
 #include <cmath>
 #include <fstream>
 #include <iostream>
 #include <sstream>
+#include <type_traits>
 
 std::unique_ptr<Raytracer::Plugin::PrimitivePlugin> ObjectPlugin::create() {
   return std::make_unique<ObjectPlugin>();
@@ -16,6 +18,17 @@ bool ObjectPlugin::configure(const libconfig::Setting &config) {
       return false;
     }
 
+    if (config.exists("precision")) {
+      std::string precision = config.lookup("precision").c_str();
+      if (precision == "single") {
+        m_precision = Precision::Single;
+      } else if (precision != "double") {
+        std::cerr << "Unknown precision in Object configuration: "
+                  << precision << std::endl;
+        return false;
+      }
+    }
+
     if (config.exists("file")) {
       std::string filename = config.lookup("file").c_str();
       if (!loadFromFile(filename)) {
@@ -100,110 +113,466 @@ bool ObjectPlugin::loadFromFile(const std::string &filename) {
     }
   }
 
+  buildTriangles();
   return !m_vertices.empty() && !m_faces.empty();
 }
 
-std::optional<Raytracer::Core::Intersection>
-ObjectPlugin::intersect(const Raytracer::Core::Ray &ray) const noexcept {
-  Raytracer::Core::Ray localRay = getTransform().inverseTransformRay(ray);
+void ObjectPlugin::buildTriangles() {
+  struct Fanned {
+    Raytracer::Math::Point<3> v0;
+    Raytracer::Math::Vector<3> e1;
+    Raytracer::Math::Vector<3> e2;
+    Triangle triangle;
+  };
+  std::vector<Fanned> fanned;
+  std::vector<Raytracer::Core::BoundingBox> bounds;
+
+  for (std::size_t f = 0; f < m_faces.size(); ++f) {
+    const auto &indices = m_faces[f].vertexIndices;
+    for (std::size_t i = 0; i + 2 < indices.size(); ++i) {
+      const auto &v0 = m_vertices[indices[0]];
+      const auto &v1 = m_vertices[indices[i + 1]];
+      const auto &v2 = m_vertices[indices[i + 2]];
+      fanned.push_back({v0, v1 - v0, v2 - v0,
+                        {static_cast<std::uint32_t>(f),
+                         static_cast<std::uint32_t>(i)}});
+
+      Raytracer::Math::Point<3> min = v0;
+      Raytracer::Math::Point<3> max = v0;
+      for (std::size_t axis = 0; axis < 3; ++axis) {
+        min.m_components[axis] =
+            std::min({v0.m_components[axis], v1.m_components[axis],
+                      v2.m_components[axis]});
+        max.m_components[axis] =
+            std::max({v0.m_components[axis], v1.m_components[axis],
+                      v2.m_components[axis]});
+      }
+      bounds.emplace_back(min, max);
+    }
+  }
+  m_triangleCount = fanned.size();
+  m_extent = 0.0;
+  for (const auto &vertex : m_vertices) {
+    for (double coordinate : vertex.m_components) {
+      m_extent = std::max(m_extent, std::abs(coordinate));
+    }
+  }
 
-  double closestT = std::numeric_limits<double>::infinity();
-  Raytracer::Math::Point<3> closestPoint;
-  Raytracer::Math::Vector<3> closestNormal;
-  Raytracer::Math::Point<2> closestUV;
-  bool isInside = false;
-
-  for (const auto &face : m_faces) {
-    if (face.vertexIndices.size() >= 3) {
-      for (size_t i = 0; i < face.vertexIndices.size() - 2; ++i) {
-        const auto &v0 = m_vertices[face.vertexIndices[0]];
-        const auto &v1 = m_vertices[face.vertexIndices[i + 1]];
-        const auto &v2 = m_vertices[face.vertexIndices[i + 2]];
-
-        Raytracer::Math::Vector<3> e1 = v1 - v0;
-        Raytracer::Math::Vector<3> e2 = v2 - v0;
-        Raytracer::Math::Vector<3> p = localRay.getDirection().cross(e2);
-        double det = e1.dot(p);
-
-        if (std::abs(det) < 1e-8) {
-          continue;
-        }
+  m_bvh.clear();
+  m_compactBvh.clear();
+  std::vector<std::uint32_t> order;
+  if (m_precision == Precision::Single) {
+    m_compactBvh.build(bounds, WIDTH);
+    order = m_compactBvh.linearizeItems(WIDTH);
+  } else {
+    m_bvh.build(bounds, WIDTH);
+    order = m_bvh.linearizeItems(WIDTH);
+  }
 
-        double invDet = 1.0 / det;
-        Raytracer::Math::Vector<3> t = localRay.getOrigin() - v0;
-        double u = t.dot(p) * invDet;
+  m_triangles.assign(order.size(), Triangle{0, 0});
+  auto fillBlocks = [&](auto &blocks) {
+    using Block = typename std::decay_t<decltype(blocks)>::value_type;
+    using Scalar = typename Block::Lanes::value_type;
+    blocks.assign((order.size() + WIDTH - 1) / WIDTH, Block{});
+    for (std::size_t i = 0; i < order.size(); ++i) {
+      if (order[i] == Raytracer::Core::BVH::NO_ITEM) {
+        continue;
+      }
+      const Fanned &source = fanned[order[i]];
+      Block &block = blocks[i / WIDTH];
+      m_triangles[i] = source.triangle;
+      for (std::size_t axis = 0; axis < 3; ++axis) {
+        block.v0[axis][i % WIDTH] =
+            static_cast<Scalar>(source.v0.m_components[axis]);
+        block.e1[axis][i % WIDTH] =
+            static_cast<Scalar>(source.e1.m_components[axis]);
+        block.e2[axis][i % WIDTH] =
+            static_cast<Scalar>(source.e2.m_components[axis]);
+      }
+    }
+  };
+  m_blocks.clear();
+  m_compactBlocks.clear();
+  if (m_precision == Precision::Single) {
+    fillBlocks(m_compactBlocks);
+  } else {
+    fillBlocks(m_blocks);
+  }
+}
 
-        if (u < 0.0 || u > 1.0) {
-          continue;
-        }
+void ObjectPlugin::setPrecision(Precision precision) {
+  m_precision = precision;
+  if (!m_faces.empty()) {
+    buildTriangles();
+  }
+}
 
-        Raytracer::Math::Vector<3> q = t.cross(e1);
-        double v = localRay.getDirection().dot(q) * invDet;
+std::size_t ObjectPlugin::getAccelerationBytes() const noexcept {
+  return m_blocks.size() * sizeof(TriangleBlock<double>) +
+         m_compactBlocks.size() * sizeof(TriangleBlock<float>) +
+         m_bvh.getNodes().size() * sizeof(Raytracer::Core::BVH::Node) +
+         m_compactBvh.getNodes().size() *
+             sizeof(Raytracer::Core::BasicBVH<float>::Node);
+}
 
-        if (v < 0.0 || u + v > 1.0) {
-          continue;
-        }
+const Raytracer::Math::Point<3> &
+ObjectPlugin::vertex(std::size_t index, std::size_t corner) const noexcept {
+  const Triangle &triangle = m_triangles[index];
+  const auto &indices = m_faces[triangle.face].vertexIndices;
+  return m_vertices[indices[corner == 0 ? 0 : triangle.corner + corner]];
+}
 
-        double t_hit = e2.dot(q) * invDet;
-
-        if (t_hit > localRay.getMinDistance() &&
-            t_hit < localRay.getMaxDistance() && t_hit < closestT) {
-          closestT = t_hit;
-          closestPoint = localRay.at(t_hit);
-
-          if (!face.normalIndices.empty() && face.normalIndices[0] > 0 &&
-              face.normalIndices[i + 1] > 0 && face.normalIndices[i + 2] > 0) {
-            Raytracer::Math::Vector<3> n0 = m_normals[face.normalIndices[0]];
-            Raytracer::Math::Vector<3> n1 =
-                m_normals[face.normalIndices[i + 1]];
-            Raytracer::Math::Vector<3> n2 =
-                m_normals[face.normalIndices[i + 2]];
-
-            closestNormal = n0 * (1.0 - u - v) + n1 * u + n2 * v;
-            closestNormal /= closestNormal.length();
-          } else {
-            closestNormal = e1.cross(e2);
-            closestNormal /= closestNormal.length();
-          }
+Raytracer::Math::Vector<3> ObjectPlugin::edge1(std::size_t index) const {
+  return vertex(index, 1) - vertex(index, 0);
+}
 
-          if (!face.textureIndices.empty() && face.textureIndices[0] > 0 &&
-              face.textureIndices[i + 1] > 0 &&
-              face.textureIndices[i + 2] > 0) {
-            Raytracer::Math::Point<2> uv0 = m_texCoords[face.textureIndices[0]];
-            Raytracer::Math::Point<2> uv1 =
-                m_texCoords[face.textureIndices[i + 1]];
-            Raytracer::Math::Point<2> uv2 =
-                m_texCoords[face.textureIndices[i + 2]];
-
-            closestUV = Raytracer::Math::Point<2>{
-                uv0.m_components[0] * (1.0 - u - v) + uv1.m_components[0] * u +
-                    uv2.m_components[0] * v,
-                uv0.m_components[1] * (1.0 - u - v) + uv1.m_components[1] * u +
-                    uv2.m_components[1] * v};
-          } else {
-            closestUV = Raytracer::Math::Point<2>{u, v};
-          }
+Raytracer::Math::Vector<3> ObjectPlugin::edge2(std::size_t index) const {
+  return vertex(index, 2) - vertex(index, 0);
+}
 
-          isInside = det < 0;
-        }
-      }
+unsigned ObjectPlugin::intersectTriangles(
+    const Raytracer::Math::Simd::Vector3x4 &origin,
+    const Raytracer::Math::Simd::Vector3x4 &direction,
+    const Raytracer::Core::Ray &ray, const TriangleBlock<double> &block,
+    Hits &hits) noexcept {
+  using Raytracer::Math::Simd::Double4;
+  using Raytracer::Math::Simd::Vector3x4;
+
+  const Vector3x4 e1 = Vector3x4::load(
+      block.e1[0].data(), block.e1[1].data(), block.e1[2].data());
+  const Vector3x4 e2 = Vector3x4::load(
+      block.e2[0].data(), block.e2[1].data(), block.e2[2].data());
+  const Vector3x4 v0 = Vector3x4::load(
+      block.v0[0].data(), block.v0[1].data(), block.v0[2].data());
+
+  Vector3x4 p = direction.cross(e2);
+  Double4 det = e1.dot(p);
+  Double4 valid = det.abs() >= Double4(1e-8);
+
+  Double4 invDet = Double4(1.0) / det;
+  Vector3x4 s = origin - v0;
+  Double4 u = s.dot(p) * invDet;
+  valid = valid & (u >= Double4(0.0)) & (u <= Double4(1.0));
+
+  Vector3x4 q = s.cross(e1);
+  Double4 v = direction.dot(q) * invDet;
+  valid = valid & (v >= Double4(0.0)) & (u + v <= Double4(1.0));
+
+  Double4 t = e2.dot(q) * invDet;
+  valid = valid & (t > Double4(ray.getMinDistance())) &
+          (t < Double4(ray.getMaxDistance()));
+
+  t.store(hits.t.data());
+  u.store(hits.u.data());
+  v.store(hits.v.data());
+  return valid.mask();
+}
+
+unsigned ObjectPlugin::filterTriangles(
+    const Raytracer::Math::Simd::Vector3x4f &origin,
+    const Raytracer::Math::Simd::Vector3x4f &direction, float tLow,
+    float tHigh, float scale, const TriangleBlock<float> &block) noexcept {
+  using Raytracer::Math::Simd::Float4;
+  using Raytracer::Math::Simd::Vector3x4f;
+
+  const Vector3x4f e1 = Vector3x4f::load(
+      block.e1[0].data(), block.e1[1].data(), block.e1[2].data());
+  const Vector3x4f e2 = Vector3x4f::load(
+      block.e2[0].data(), block.e2[1].data(), block.e2[2].data());
+  const Vector3x4f v0 = Vector3x4f::load(
+      block.v0[0].data(), block.v0[1].data(), block.v0[2].data());
+
+  // A null determinant makes the coordinates infinite or NaN, which every
+  // comparison below rejects.
+  Vector3x4f p = direction.cross(e2);
+  Float4 invDet = Float4(1.0f) / e1.dot(p);
+  Float4 edges = e1.x.abs() + e1.y.abs() + e1.z.abs() + e2.x.abs() +
+                 e2.y.abs() + e2.z.abs();
+  Float4 tolerance = Float4(scale) * edges * invDet.abs();
+  Float4 low = Float4(0.0f) - tolerance;
+  Float4 high = Float4(1.0f) + tolerance;
+  Vector3x4f s = origin - v0;
+  Float4 u = s.dot(p) * invDet;
+  Float4 valid = (u >= low) & (u <= high);
+
+  Vector3x4f q = s.cross(e1);
+  Float4 v = direction.dot(q) * invDet;
+  valid = valid & (v >= low) & (u + v <= high);
+
+  Float4 t = e2.dot(q) * invDet;
+  valid = valid & (t > Float4(tLow)) & (t < Float4(tHigh));
+  return valid.mask();
+}
+
+bool ObjectPlugin::intersectTriangle(const Raytracer::Core::Ray &ray,
+                                     std::size_t index, double &t, double &u,
+                                     double &v) const noexcept {
+  const Raytracer::Math::Vector<3> direction = ray.getDirection();
+  const Raytracer::Math::Vector<3> e1 = edge1(index);
+  const Raytracer::Math::Vector<3> e2 = edge2(index);
+
+  Raytracer::Math::Vector<3> p = direction.cross(e2);
+  double det = e1.dot(p);
+  if (std::abs(det) < 1e-8) {
+    return false;
+  }
+
+  double invDet = 1.0 / det;
+  Raytracer::Math::Vector<3> s = ray.getOrigin() - vertex(index, 0);
+  u = s.dot(p) * invDet;
+  if (u < 0.0 || u > 1.0) {
+    return false;
+  }
+
+  Raytracer::Math::Vector<3> q = s.cross(e1);
+  v = direction.dot(q) * invDet;
+  if (v < 0.0 || u + v > 1.0) {
+    return false;
+  }
+
+  t = e2.dot(q) * invDet;
+  return t > ray.getMinDistance() && t < ray.getMaxDistance();
+}
+
+double ObjectPlugin::coordinateScale(
+    const Raytracer::Core::Ray &ray) const noexcept {
+  double farthest = 0.0;
+  for (double coordinate : ray.getOrigin().m_components) {
+    farthest = std::max(farthest, std::abs(coordinate));
+  }
+  return m_extent + farthest;
+}
+
+double ObjectPlugin::singlePrecisionSlack(
+    const Raytracer::Core::Ray &ray) const noexcept {
+  return SINGLE_PRECISION_TOLERANCE * coordinateScale(ray) /
+         ray.getDirection().length();
+}
+
+float ObjectPlugin::barycentricScale(
+    const Raytracer::Core::Ray &ray) const noexcept {
+  return static_cast<float>(BARYCENTRIC_TOLERANCE * coordinateScale(ray) *
+                            ray.getDirection().length());
+}
+
+std::optional<Raytracer::Core::Intersection>
+ObjectPlugin::intersect(const Raytracer::Core::Ray &ray) const noexcept {
+  Raytracer::Core::HitRecord hit;
+  if (!findHit(ray, hit)) {
+    return std::nullopt;
+  }
+  return computeIntersection(ray, hit);
+}
+
+bool ObjectPlugin::findHit(const Raytracer::Core::Ray &ray,
+                           Raytracer::Core::HitRecord &hit) const noexcept {
+  Raytracer::Core::Ray localRay = getTransform().inverseTransformRay(ray);
+
+  // Equal distances keep the triangle that comes first in file order, as a
+  // linear scan over the faces would.
+  constexpr double pruneSlack = 1.0 + 1e-9;
+  double closestT = hit.t;
+  std::uint32_t closestTriangle = 0;
+  double closestU = 0.0;
+  double closestV = 0.0;
+  bool found = false;
+
+  auto consider = [&](std::uint32_t item, double t, double u, double v,
+                      double &tMax) {
+    if (t < closestT ||
+        (found && t == closestT && precedes(item, closestTriangle))) {
+      closestT = t;
+      closestTriangle = item;
+      closestU = u;
+      closestV = v;
+      found = true;
+      tMax = std::min(tMax, t * pruneSlack);
     }
+  };
+
+  if (m_precision == Precision::Single) {
+    const Raytracer::Math::Simd::Vector3x4f origin(localRay.getOrigin());
+    const Raytracer::Math::Simd::Vector3x4f direction(localRay.getDirection());
+    const double slack = singlePrecisionSlack(localRay);
+    const auto tLow = static_cast<float>(localRay.getMinDistance() - slack);
+    const float scale = barycentricScale(localRay);
+
+    m_compactBvh.traverseLeaves(
+        localRay, [&](std::span<const std::uint32_t> items, double &tMax) {
+          if (!found) {
+            tMax = std::min(tMax, closestT * pruneSlack);
+          }
+          for (std::size_t first = 0; first < items.size(); first += WIDTH) {
+            const std::size_t count = std::min(WIDTH, items.size() - first);
+            unsigned lanes =
+                filterTriangles(origin, direction, tLow,
+                                static_cast<float>(closestT + slack), scale,
+                                m_compactBlocks[items[first] / WIDTH]) &
+                ((1u << count) - 1);
+            while (lanes != 0) {
+              const auto lane =
+                  static_cast<std::size_t>(std::countr_zero(lanes));
+              lanes &= lanes - 1;
+              const std::uint32_t item = items[first + lane];
+              double t = 0.0;
+              double u = 0.0;
+              double v = 0.0;
+              if (intersectTriangle(localRay, item, t, u, v)) {
+                consider(item, t, u, v, tMax);
+              }
+            }
+          }
+          return false;
+        });
+  } else {
+    const Raytracer::Math::Simd::Vector3x4 origin(localRay.getOrigin());
+    const Raytracer::Math::Simd::Vector3x4 direction(localRay.getDirection());
+
+    m_bvh.traverseLeaves(
+        localRay, [&](std::span<const std::uint32_t> items, double &tMax) {
+          if (!found) {
+            tMax = std::min(tMax, closestT * pruneSlack);
+          }
+          for (std::size_t first = 0; first < items.size(); first += WIDTH) {
+            const std::size_t count = std::min(WIDTH, items.size() - first);
+            Hits hits;
+            unsigned lanes =
+                intersectTriangles(origin, direction, localRay,
+                                   m_blocks[items[first] / WIDTH], hits) &
+                ((1u << count) - 1);
+            while (lanes != 0) {
+              const auto lane =
+                  static_cast<std::size_t>(std::countr_zero(lanes));
+              lanes &= lanes - 1;
+              consider(items[first + lane], hits.t[lane], hits.u[lane],
+                       hits.v[lane], tMax);
+            }
+          }
+          return false;
+        });
   }
 
-  if (closestT < std::numeric_limits<double>::infinity()) {
-    Raytracer::Math::Point<3> worldPoint =
-        getTransform().transformPoint(closestPoint);
-    Raytracer::Math::Vector<3> worldNormal =
-        getTransform().transformNormal(closestNormal);
-    worldNormal /= worldNormal.length();
+  if (!found) {
+    return false;
+  }
+  hit = Raytracer::Core::HitRecord{};
+  hit.t = closestT;
+  hit.primitive = this;
+  hit.index = closestTriangle;
+  hit.u = closestU;
+  hit.v = closestV;
+  return true;
+}
 
-    double worldDist = (worldPoint - ray.getOrigin()).length();
+Raytracer::Core::Intersection ObjectPlugin::computeIntersection(
+    const Raytracer::Core::Ray &ray,
+    const Raytracer::Core::HitRecord &hit) const noexcept {
+  Raytracer::Core::Ray localRay = getTransform().inverseTransformRay(ray);
+  const Triangle &triangle = m_triangles[hit.index];
+  const Face &face = m_faces[triangle.face];
+  const std::size_t i = triangle.corner;
+  const double u = hit.u;
+  const double v = hit.v;
+  const Raytracer::Math::Vector<3> e1 = edge1(hit.index);
+  const Raytracer::Math::Vector<3> e2 = edge2(hit.index);
+  const double det = e1.dot(localRay.getDirection().cross(e2));
+
+  Raytracer::Math::Point<3> closestPoint = localRay.at(hit.t);
+  Raytracer::Math::Vector<3> closestNormal;
+  Raytracer::Math::Point<2> closestUV;
+
+  if (!face.normalIndices.empty() && face.normalIndices[0] > 0 &&
+      face.normalIndices[i + 1] > 0 && face.normalIndices[i + 2] > 0) {
+    Raytracer::Math::Vector<3> n0 = m_normals[face.normalIndices[0]];
+    Raytracer::Math::Vector<3> n1 = m_normals[face.normalIndices[i + 1]];
+    Raytracer::Math::Vector<3> n2 = m_normals[face.normalIndices[i + 2]];
+
+    closestNormal = n0 * (1.0 - u - v) + n1 * u + n2 * v;
+    closestNormal /= closestNormal.length();
+  } else {
+    closestNormal = e1.cross(e2);
+    closestNormal /= closestNormal.length();
+  }
 
-    return Raytracer::Core::Intersection(worldPoint, worldNormal, getMaterial(),
-                                         worldDist, isInside, closestUV);
+  if (!face.textureIndices.empty() && face.textureIndices[0] > 0 &&
+      face.textureIndices[i + 1] > 0 && face.textureIndices[i + 2] > 0) {
+    Raytracer::Math::Point<2> uv0 = m_texCoords[face.textureIndices[0]];
+    Raytracer::Math::Point<2> uv1 = m_texCoords[face.textureIndices[i + 1]];
+    Raytracer::Math::Point<2> uv2 = m_texCoords[face.textureIndices[i + 2]];
+
+    closestUV = Raytracer::Math::Point<2>{
+        uv0.m_components[0] * (1.0 - u - v) + uv1.m_components[0] * u +
+            uv2.m_components[0] * v,
+        uv0.m_components[1] * (1.0 - u - v) + uv1.m_components[1] * u +
+            uv2.m_components[1] * v};
+  } else {
+    closestUV = Raytracer::Math::Point<2>{u, v};
   }
 
-  return std::nullopt;
+  Raytracer::Math::Point<3> worldPoint =
+      getTransform().transformPoint(closestPoint);
+  Raytracer::Math::Vector<3> worldNormal =
+      getTransform().transformNormal(closestNormal);
+  worldNormal /= worldNormal.length();
+
+  double worldDist = (worldPoint - ray.getOrigin()).length();
+
+  return Raytracer::Core::Intersection(worldPoint, worldNormal,
+                                       getMaterial().get(), worldDist, det < 0,
+                                       closestUV);
+}
+
+bool ObjectPlugin::occluded(const Raytracer::Core::Ray &ray) const noexcept {
+  Raytracer::Core::Ray localRay = getTransform().inverseTransformRay(ray);
+
+  if (m_precision == Precision::Single) {
+    const Raytracer::Math::Simd::Vector3x4f origin(localRay.getOrigin());
+    const Raytracer::Math::Simd::Vector3x4f direction(localRay.getDirection());
+    const double slack = singlePrecisionSlack(localRay);
+    const auto tLow = static_cast<float>(localRay.getMinDistance() - slack);
+    const auto tHigh = static_cast<float>(localRay.getMaxDistance() + slack);
+    const float scale = barycentricScale(localRay);
+
+    return m_compactBvh.traverseLeaves(
+        localRay, [&](std::span<const std::uint32_t> items, double &) {
+          for (std::size_t first = 0; first < items.size(); first += WIDTH) {
+            const std::size_t count = std::min(WIDTH, items.size() - first);
+            unsigned lanes =
+                filterTriangles(origin, direction, tLow, tHigh, scale,
+                                m_compactBlocks[items[first] / WIDTH]) &
+                ((1u << count) - 1);
+            while (lanes != 0) {
+              const auto lane =
+                  static_cast<std::size_t>(std::countr_zero(lanes));
+              lanes &= lanes - 1;
+              double t = 0.0;
+              double u = 0.0;
+              double v = 0.0;
+              if (intersectTriangle(localRay, items[first + lane], t, u, v)) {
+                return true;
+              }
+            }
+          }
+          return false;
+        });
+  }
+
+  const Raytracer::Math::Simd::Vector3x4 origin(localRay.getOrigin());
+  const Raytracer::Math::Simd::Vector3x4 direction(localRay.getDirection());
+
+  return m_bvh.traverseLeaves(
+      localRay, [&](std::span<const std::uint32_t> items, double &) {
+        for (std::size_t first = 0; first < items.size(); first += WIDTH) {
+          const std::size_t count = std::min(WIDTH, items.size() - first);
+          Hits hits;
+          if ((intersectTriangles(origin, direction, localRay,
+                                  m_blocks[items[first] / WIDTH], hits) &
+               ((1u << count) - 1)) != 0) {
+            return true;
+          }
+        }
+        return false;
+      });
 }
 
 Raytracer::Core::BoundingBox ObjectPlugin::getBoundingBox() const noexcept {
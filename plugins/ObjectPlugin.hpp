@@ -1,5 +1,9 @@
 #pragma once
+#include "Core/BVH.hpp"
+#include "Math/Vector3x4.hpp"
 #include "Plugin/PrimitivePlugin.hpp"
+#include <array>
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -10,6 +14,19 @@
  */
 class ObjectPlugin : public Raytracer::Plugin::PrimitivePlugin {
 public:
+  /**
+   * @enum Precision
+   * @brief Precision of the data tested against rays.
+   *
+   * In single precision the triangle blocks and the hierarchy nodes take
+   * half the memory and triangles are tested with float lanes, with
+   * tolerances wide enough to keep every triangle the ray may hit. Each of
+   * those candidates is then tested again in double precision from the
+   * vertices, so hits are the ones double precision finds, save for rays
+   * almost parallel to a triangle that float rounding can lose.
+   */
+  enum class Precision { Double, Single };
+
   /**
    * @brief Default Constructor
    */
@@ -48,6 +65,34 @@ public:
   [[nodiscard]] std::optional<Raytracer::Core::Intersection>
   intersect(const Raytracer::Core::Ray &ray) const noexcept override;
 
+  /**
+   * @brief Check whether a ray hits this Object, without shading data
+   * @param ray The ray to test for intersection
+   * @return True if the ray hits the Object within its distance range
+   */
+  [[nodiscard]] bool
+  occluded(const Raytracer::Core::Ray &ray) const noexcept override;
+
+  /**
+   * @brief Find the ray parameter of the closest hit with this Object
+   * @param ray The ray to test for intersection
+   * @param hit The closest hit so far, updated if this Object is closer
+   * @return True if the hit record was updated
+   */
+  [[nodiscard]] bool
+  findHit(const Raytracer::Core::Ray &ray,
+          Raytracer::Core::HitRecord &hit) const noexcept override;
+
+  /**
+   * @brief Compute the surface data of a hit found by findHit
+   * @param ray The ray that was passed to findHit
+   * @param hit The hit record filled in by this Object
+   * @return The intersection data at the hit
+   */
+  [[nodiscard]] Raytracer::Core::Intersection computeIntersection(
+      const Raytracer::Core::Ray &ray,
+      const Raytracer::Core::HitRecord &hit) const noexcept override;
+
   /**
    * @brief Calculate the axis-aligned bounding box for this Object
    * @return The bounding box that represents this Object
@@ -63,6 +108,28 @@ public:
    */
   bool loadFromFile(const std::string &filename);
 
+  /**
+   * @brief Set the precision of the data tested against rays.
+   *
+   * The triangle data is rebuilt if a mesh is already loaded.
+   * @param precision New precision, Precision::Double by default.
+   */
+  void setPrecision(Precision precision);
+
+  /**
+   * @brief Get the memory held by the data tested against rays.
+   * @return Size in bytes of the triangle blocks and hierarchy nodes.
+   */
+  [[nodiscard]] std::size_t getAccelerationBytes() const noexcept;
+
+  /**
+   * @brief Get the number of triangles obtained by fanning the faces.
+   * @return Triangle count of the loaded mesh.
+   */
+  [[nodiscard]] std::size_t getTriangleCount() const noexcept {
+    return m_triangleCount;
+  }
+
 private:
   struct Face {
     std::vector<int> vertexIndices;
@@ -70,10 +137,204 @@ private:
     std::vector<int> textureIndices;
   };
 
+  /**
+   * @struct Triangle
+   * @brief Face corner a triangle was fanned from.
+   *
+   * The triangle uses the face vertices 0, @c corner + 1 and @c corner + 2.
+   */
+  struct Triangle {
+    std::uint32_t face;
+    std::uint32_t corner;
+  };
+
+  /** Number of triangles tested together. */
+  static constexpr std::size_t WIDTH = Raytracer::Math::Simd::Double4::WIDTH;
+
+  /**
+   * Tolerance of the single-precision test on the ray parameter, relative
+   * to its scale.
+   */
+  static constexpr double SINGLE_PRECISION_TOLERANCE = 1e-3;
+
+  /**
+   * Tolerance of the single-precision test on barycentric coordinates,
+   * relative to the scale of their rounding error: the magnitude of the
+   * coordinates times the edge lengths over the determinant.
+   */
+  static constexpr double BARYCENTRIC_TOLERANCE = 1e-5;
+
+  /**
+   * @struct TriangleBlock
+   * @brief Four triangles stored one axis per array, with their edges
+   * precomputed.
+   * @tparam T The type of the coordinates.
+   *
+   * Every BVH leaf starts a new block, so the triangles of a leaf are tested
+   * four at a time with aligned loads. Unused lanes are zero: their
+   * determinant is null and they never hit.
+   */
+  template <typename T> struct TriangleBlock {
+    using Lanes = std::array<T, WIDTH>;
+
+    std::array<Lanes, 3> v0{};
+    std::array<Lanes, 3> e1{};
+    std::array<Lanes, 3> e2{};
+  };
+
+  /**
+   * @struct Hits
+   * @brief Per-lane results of intersectTriangles().
+   */
+  struct Hits {
+    std::array<double, WIDTH> t;
+    std::array<double, WIDTH> u;
+    std::array<double, WIDTH> v;
+  };
+
+  /**
+   * @brief Fan every face into triangles and build the triangle BVH.
+   *
+   * Triangles are stored in the order of the BVH leaves, so each leaf
+   * covers consecutive entries of m_triangles starting a block of m_blocks,
+   * or of m_compactBlocks in single precision.
+   */
+  void buildTriangles();
+
+  /**
+   * @brief Möller–Trumbore test of an object-space ray against a block.
+   *
+   * Each lane goes through the same operations as a scalar test would, so
+   * hits and their parameters do not depend on how triangles are grouped.
+   * @param origin Ray origin, in every lane.
+   * @param direction Ray direction, in every lane.
+   * @param ray Ray in object space, for its distance range.
+   * @param block Triangles to test.
+   * @param hits Set to the ray parameter and barycentric coordinates of
+   * every lane.
+   * @return One bit per lane whose triangle the ray hits within its range.
+   */
+  [[nodiscard]] static unsigned
+  intersectTriangles(const Raytracer::Math::Simd::Vector3x4 &origin,
+                     const Raytracer::Math::Simd::Vector3x4 &direction,
+                     const Raytracer::Core::Ray &ray,
+                     const TriangleBlock<double> &block, Hits &hits) noexcept;
+
+  /**
+   * @brief Single-precision test of an object-space ray against a block.
+   *
+   * Accepts every lane whose barycentric coordinates are within their
+   * rounding error of the triangle, so the lanes it rejects are misses in
+   * double precision too. That error grows with the coordinates the test
+   * subtracts and with the edges, and shrinks as the determinant grows, so
+   * small triangles and far rays get a wider margin.
+   * @param origin Ray origin, in every lane.
+   * @param direction Ray direction, in every lane.
+   * @param tLow Smallest ray parameter to accept.
+   * @param tHigh Largest ray parameter to accept.
+   * @param scale Margin per unit of edge length over the determinant, from
+   * barycentricScale().
+   * @param block Triangles to test.
+   * @return One bit per lane whose triangle the ray may hit.
+   */
+  [[nodiscard]] static unsigned
+  filterTriangles(const Raytracer::Math::Simd::Vector3x4f &origin,
+                  const Raytracer::Math::Simd::Vector3x4f &direction,
+                  float tLow, float tHigh, float scale,
+                  const TriangleBlock<float> &block) noexcept;
+
+  /**
+   * @brief Möller–Trumbore test of an object-space ray against a triangle.
+   *
+   * Same operations as one lane of intersectTriangles(), on the vertices.
+   * @param ray Ray in object space.
+   * @param index Index of the triangle.
+   * @param t Set to the ray parameter of the hit.
+   * @param u Set to the first barycentric coordinate of the hit.
+   * @param v Set to the second barycentric coordinate of the hit.
+   * @return true if the ray hits the triangle within its range.
+   */
+  [[nodiscard]] bool intersectTriangle(const Raytracer::Core::Ray &ray,
+                                       std::size_t index, double &t, double &u,
+                                       double &v) const noexcept;
+
+  /**
+   * @brief Get a vertex of a triangle.
+   * @param index Index of the triangle.
+   * @param corner 0, 1 or 2.
+   * @return Face vertex 0 for corner 0, face vertex @c corner + @p corner
+   * otherwise.
+   */
+  [[nodiscard]] const Raytracer::Math::Point<3> &
+  vertex(std::size_t index, std::size_t corner) const noexcept;
+
+  /**
+   * @brief Get the first edge of a triangle.
+   * @param index Index of the triangle.
+   * @return Edge from vertex 0 to vertex @c corner + 1.
+   */
+  [[nodiscard]] Raytracer::Math::Vector<3> edge1(std::size_t index) const;
+
+  /**
+   * @brief Get the second edge of a triangle.
+   * @param index Index of the triangle.
+   * @return Edge from vertex 0 to vertex @c corner + 2.
+   */
+  [[nodiscard]] Raytracer::Math::Vector<3> edge2(std::size_t index) const;
+
+  /**
+   * @brief Bound the rounding of the ray parameter in single precision.
+   *
+   * The error grows with the coordinates the test subtracts, those of the
+   * ray origin and of the mesh.
+   * @param ray Ray in object space.
+   * @return Margin to add around the range of the single-precision test.
+   */
+  [[nodiscard]] double
+  singlePrecisionSlack(const Raytracer::Core::Ray &ray) const noexcept;
+
+  /**
+   * @brief Bound the rounding of barycentric coordinates in single
+   * precision, before the per-triangle factor.
+   * @param ray Ray in object space.
+   * @return Value for the @p scale parameter of filterTriangles().
+   */
+  [[nodiscard]] float
+  barycentricScale(const Raytracer::Core::Ray &ray) const noexcept;
+
+  /**
+   * @brief Get the largest coordinate the single-precision test subtracts.
+   * @param ray Ray in object space.
+   * @return Largest absolute coordinate of the ray origin or the mesh.
+   */
+  [[nodiscard]] double
+  coordinateScale(const Raytracer::Core::Ray &ray) const noexcept;
+
+  /**
+   * @brief Check whether a triangle comes first in file order.
+   * @param lhs Index of a triangle.
+   * @param rhs Index of another triangle.
+   * @return true if @p lhs was fanned before @p rhs.
+   */
+  [[nodiscard]] bool precedes(std::uint32_t lhs,
+                              std::uint32_t rhs) const noexcept {
+    const Triangle &a = m_triangles[lhs];
+    const Triangle &b = m_triangles[rhs];
+    return a.face < b.face || (a.face == b.face && a.corner < b.corner);
+  }
+
   std::vector<Raytracer::Math::Point<3>> m_vertices;
   std::vector<Raytracer::Math::Vector<3>> m_normals;
   std::vector<Raytracer::Math::Point<2>> m_texCoords;
   std::vector<Face> m_faces;
+  std::vector<Triangle> m_triangles;
+  std::vector<TriangleBlock<double>> m_blocks;
+  std::vector<TriangleBlock<float>> m_compactBlocks;
+  std::size_t m_triangleCount{0};
+  double m_extent{0.0};
+  Precision m_precision{Precision::Double};
+  Raytracer::Core::BVH m_bvh;
+  Raytracer::Core::BasicBVH<float> m_compactBvh;
   std::string m_filename;
   std::string m_texture;
 };
\ No newline at end of file
@@ -45,19 +45,50 @@ const Math::Point<3> &PlanePlugin::getPosition() const noexcept {
 
 [[nodiscard]] std::optional<Core::Intersection>
 PlanePlugin::intersect(const Core::Ray &ray) const noexcept {
-  Core::Ray localRay = getTransform().inverseTransformRay(ray);
+  Core::HitRecord hit;
+  if (!findHit(ray, hit)) {
+    return std::nullopt;
+  }
+  return computeIntersection(ray, hit);
+}
+
+bool PlanePlugin::findDistance(const Core::Ray &localRay,
+                               double &bestT) const noexcept {
   double denominateur = m_normal.dot(localRay.getDirection());
   if (std::abs(denominateur) < 1e-8) {
-    return std::nullopt;
+    return false;
   }
 
   Math::Vector<3> vec = m_position - localRay.getOrigin();
   double t = vec.dot(m_normal) / denominateur;
-  if (t < localRay.getMinDistance() || t > localRay.getMaxDistance()) {
-    return std::nullopt;
+  if (t < localRay.getMinDistance() || t > localRay.getMaxDistance() ||
+      !(t < bestT)) {
+    return false;
   }
+  bestT = t;
+  return true;
+}
 
-  Math::Point<3> localIntersectionPoint = localRay.at(t);
+[[nodiscard]] bool PlanePlugin::findHit(const Core::Ray &ray,
+                                        Core::HitRecord &hit) const noexcept {
+  double t = hit.t;
+  if (!findDistance(getTransform().inverseTransformRay(ray), t)) {
+    return false;
+  }
+
+  hit = Core::HitRecord{};
+  hit.t = t;
+  hit.primitive = this;
+  return true;
+}
+
+[[nodiscard]] Core::Intersection
+PlanePlugin::computeIntersection(const Core::Ray &ray,
+                                 const Core::HitRecord &hit) const noexcept {
+  Core::Ray localRay = getTransform().inverseTransformRay(ray);
+  double denominateur = m_normal.dot(localRay.getDirection());
+
+  Math::Point<3> localIntersectionPoint = localRay.at(hit.t);
   bool isInside = denominateur > 0;
   Math::Vector<3> localNormal = isInside ? -m_normal : m_normal;
 
@@ -79,10 +110,16 @@ PlanePlugin::intersect(const Core::Ray &ray) const noexcept {
   double worldDistance = (worldIntersectionPoint - ray.getOrigin()).length();
 
   return Core::Intersection(worldIntersectionPoint, worldNormal,
-                            this->getMaterial(), worldDistance, isInside,
+                            this->getMaterial().get(), worldDistance, isInside,
                             Math::Point<2>{u, v});
 }
 
+[[nodiscard]] bool
+PlanePlugin::occluded(const Core::Ray &ray) const noexcept {
+  double t = std::numeric_limits<double>::infinity();
+  return findDistance(getTransform().inverseTransformRay(ray), t);
+}
+
 [[nodiscard]] Core::BoundingBox PlanePlugin::getBoundingBox() const noexcept {
   constexpr double inf = std::numeric_limits<double>::infinity();
   Math::Point<3> min, max;
@@ -70,6 +70,32 @@ public:
   [[nodiscard]] std::optional<Core::Intersection>
   intersect(const Core::Ray &ray) const noexcept override;
 
+  /**
+   * @brief Check whether a ray hits this plane, without shading data
+   * @param ray The ray to test for intersection
+   * @return True if the ray hits the plane within its distance range
+   */
+  [[nodiscard]] bool occluded(const Core::Ray &ray) const noexcept override;
+
+  /**
+   * @brief Find the ray parameter of the closest hit with this plane
+   * @param ray The ray to test for intersection
+   * @param hit The closest hit so far, updated if this plane is closer
+   * @return True if the hit record was updated
+   */
+  [[nodiscard]] bool findHit(const Core::Ray &ray,
+                             Core::HitRecord &hit) const noexcept override;
+
+  /**
+   * @brief Compute the surface data of a hit found by findHit
+   * @param ray The ray that was passed to findHit
+   * @param hit The hit record filled in by this plane
+   * @return The intersection data at the hit
+   */
+  [[nodiscard]] Core::Intersection
+  computeIntersection(const Core::Ray &ray,
+                      const Core::HitRecord &hit) const noexcept override;
+
   /**
    * @brief Calculate the axis-aligned bounding box for this plane
    * @return The bounding box that represents this infinite plane
@@ -77,6 +103,15 @@ public:
   [[nodiscard]] Core::BoundingBox getBoundingBox() const noexcept override;
 
 private:
+  /**
+   * @brief Find where a local-space ray crosses this Plane
+   * @param localRay The ray, in the Plane's local space
+   * @param bestT Hits must be closer than this, set to the hit found
+   * @return True if the ray crosses the Plane closer than bestT
+   */
+  [[nodiscard]] bool findDistance(const Core::Ray &localRay,
+                                  double &bestT) const noexcept;
+
   Math::Vector<3> m_normal{0.0, 0.0, 0.0};
   Math::Point<3> m_position{0.0, 0.0, 0.0};
 };
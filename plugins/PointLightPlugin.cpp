@@ -33,7 +33,7 @@ PointLightPlugin::computeIllumination(const Math::Point<3> &intersectionPoint,
   Core::Ray shadowRay(shadowRayOrigin, lightDirection, epsilon,
                       distanceToLight);
 
-  if (scene.hasIntersection(shadowRay)) {
+  if (scene.hasIntersection(shadowRay, *this)) {
     return 0.0;
   }
 
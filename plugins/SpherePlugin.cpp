@@ -1,5 +1,6 @@
 #include "SpherePlugin.hpp"
 #include "Parser/SceneParser.hpp"
+#include <limits>
 
 namespace Raytracer::Plugins {
 
@@ -36,7 +37,15 @@ const Math::Point<3> &SpherePlugin::getCenter() const noexcept {
 
 [[nodiscard]] std::optional<Core::Intersection>
 SpherePlugin::intersect(const Core::Ray &ray) const noexcept {
-  Core::Ray localRay = getTransform().inverseTransformRay(ray);
+  Core::HitRecord hit;
+  if (!findHit(ray, hit)) {
+    return std::nullopt;
+  }
+  return computeIntersection(ray, hit);
+}
+
+bool SpherePlugin::findDistance(const Core::Ray &localRay,
+                                double &bestT) const noexcept {
   Math::Vector<3> oc = localRay.getOrigin() - m_center;
 
   double a = localRay.getDirection().dot(localRay.getDirection());
@@ -45,7 +54,7 @@ SpherePlugin::intersect(const Core::Ray &ray) const noexcept {
 
   double delta = b * b - 4 * a * c;
   if (delta < 0) {
-    return std::nullopt;
+    return false;
   }
   double t1 = (-b - std::sqrt(delta)) / (2.0 * a);
   double t2 = (-b + std::sqrt(delta)) / (2.0 * a);
@@ -55,7 +64,7 @@ SpherePlugin::intersect(const Core::Ray &ray) const noexcept {
   bool t2Valid =
       t2 >= localRay.getMinDistance() && t2 <= localRay.getMaxDistance();
   if (!t1Valid && !t2Valid) {
-    return std::nullopt;
+    return false;
   }
 
   double t = 0.0;
@@ -67,7 +76,30 @@ SpherePlugin::intersect(const Core::Ray &ray) const noexcept {
     t = t2;
   }
 
-  Math::Point<3> localIntersectionPoint = localRay.at(t);
+  if (!(t < bestT)) {
+    return false;
+  }
+  bestT = t;
+  return true;
+}
+
+[[nodiscard]] bool SpherePlugin::findHit(const Core::Ray &ray,
+                                         Core::HitRecord &hit) const noexcept {
+  double t = hit.t;
+  if (!findDistance(getTransform().inverseTransformRay(ray), t)) {
+    return false;
+  }
+  hit = Core::HitRecord{};
+  hit.t = t;
+  hit.primitive = this;
+  return true;
+}
+
+[[nodiscard]] Core::Intersection
+SpherePlugin::computeIntersection(const Core::Ray &ray,
+                                  const Core::HitRecord &hit) const noexcept {
+  Core::Ray localRay = getTransform().inverseTransformRay(ray);
+  Math::Point<3> localIntersectionPoint = localRay.at(hit.t);
   Math::Vector<3> localDirToCenter =
       Math::Vector<3>(localIntersectionPoint - m_center);
   Math::Vector<3> localNormal = localDirToCenter / m_radius;
@@ -90,15 +122,21 @@ SpherePlugin::intersect(const Core::Ray &ray) const noexcept {
   double worldDistance = (worldIntersectionPoint - ray.getOrigin()).length();
 
   return Core::Intersection(worldIntersectionPoint, worldNormal,
-                            this->getMaterial(), worldDistance, isInside,
+                            this->getMaterial().get(), worldDistance, isInside,
                             Math::Point<2>{u, v});
 }
 
+[[nodiscard]] bool
+SpherePlugin::occluded(const Core::Ray &ray) const noexcept {
+  double t = std::numeric_limits<double>::infinity();
+  return findDistance(getTransform().inverseTransformRay(ray), t);
+}
+
 [[nodiscard]] Core::BoundingBox SpherePlugin::getBoundingBox() const noexcept {
   Math::Vector<3> radiusVec(m_radius, m_radius, m_radius);
   Math::Point<3> min = m_center - radiusVec;
   Math::Point<3> max = m_center + radiusVec;
-  return Core::BoundingBox(min, max);
+  return getTransform().transformBoundingBox(Core::BoundingBox(min, max));
 }
 
 } // namespace Raytracer::Plugins
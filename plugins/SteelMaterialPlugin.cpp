@@ -2,6 +2,7 @@
 #include "Parser/SceneParser.hpp"
 #include "Plugin/MaterialPlugin.hpp"
 #include "SteelMaterialPlugin.hpp"
+#include <cmath>
 
 namespace Raytracer::Plugins {
 
@@ -31,41 +32,46 @@ bool SteelMaterialPlugin::configure(const libconfig::Setting &config) {
   return true;
 }
 
-Math::Vector<3> SteelMaterialPlugin::randomInUnitSphere() const {
+Math::Vector<3>
+SteelMaterialPlugin::randomInUnitSphere(Core::Sampler &sampler) noexcept {
+  auto [brushY, brushZ] = sampler.next2D();
   Math::Vector<3> brushDirection;
   brushDirection.m_components[0] = 0.8;
-  brushDirection.m_components[1] = 0.1 * m_distribution(m_generator);
-  brushDirection.m_components[2] = 0.1 * m_distribution(m_generator);
+  brushDirection.m_components[1] = 0.1 * brushY;
+  brushDirection.m_components[2] = 0.1 * brushZ;
   double len = brushDirection.length();
   if (len > 0.0) {
     for (int i = 0; i < 3; i++) {
       brushDirection.m_components[i] /= len;
     }
   }
-  Math::Vector<3> randomNoise;
-  randomNoise = Math::Vector<3>(1.0, 1.0, 1.0);
-  while (randomNoise.squaredNorm() >= 1.0) {
-    randomNoise = Math::Vector<3>(m_distribution(m_generator) * 0.2,
-                                  m_distribution(m_generator) * 0.8,
-                                  m_distribution(m_generator) * 0.8);
+
+  // Points of the box outside the unit sphere are pulled back onto it
+  // instead of being redrawn, so the cost per bounce stays fixed.
+  auto [noiseY, noiseZ] = sampler.next2D();
+  Math::Vector<3> randomNoise(sampler.next1D() * 0.2, noiseY * 0.8,
+                              noiseZ * 0.8);
+  double squaredNorm = randomNoise.squaredNorm();
+  if (squaredNorm >= 1.0) {
+    randomNoise = randomNoise * (0.999 / std::sqrt(squaredNorm));
   }
 
   return brushDirection + randomNoise * 0.3;
 }
 
-Core::Color SteelMaterialPlugin::computeColor(
+Core::ScatterResult SteelMaterialPlugin::scatter(
     const Core::Intersection &intersection, const Core::Ray &ray,
-    const std::vector<std::shared_ptr<Core::ILight>> &lights,
-    const Core::Scene &scene) const {
+    const std::vector<const Core::ILight *> & /* lights */,
+    const Core::Scene & /* scene */, Core::RenderContext &context) const {
 
   if (ray.getDepth() > 5)
-    return getAmbientColor() * getAmbientCoefficient();
+    return {(getAmbientColor() * getAmbientCoefficient()).toRadiance()};
 
   Math::Vector<3> normal = intersection.getNormal();
   Math::Vector<3> reflectDir =
       ray.getDirection() - normal * 2.0 * normal.dot(ray.getDirection());
 
-  reflectDir = reflectDir + randomInUnitSphere() * m_fuzz;
+  reflectDir = reflectDir + randomInUnitSphere(context.sampler) * m_fuzz;
   reflectDir = reflectDir.normalize();
 
   double epsilon = 0.001;
@@ -74,28 +80,18 @@ Core::Color SteelMaterialPlugin::computeColor(
   Core::Ray reflectRay(offsetPoint, reflectDir, epsilon, ray.getMaxDistance());
   reflectRay.setDepth(ray.getDepth() + 1);
 
-  std::optional<Core::Intersection> newIntersection =
-      scene.findNearestIntersection(reflectRay);
-
   Core::Color aluminumBaseColor = getDiffuseColor() * 0.2;
 
   double specularIntensity =
       std::max(0.0, std::pow(-ray.getDirection().dot(reflectDir), 10.0)) * 0.4;
   Core::Color specularColor = Core::Color(255, 255, 255) * specularIntensity;
 
-  if (!newIntersection)
-    return aluminumBaseColor.add(specularColor)
-        .add(getAmbientColor() * getAmbientCoefficient());
-
-  Core::Color reflectedColor = newIntersection->getMaterial()->computeColor(
-      newIntersection.value(), reflectRay, lights, scene);
-
-  reflectedColor = reflectedColor * 0.7;
-
-  return (reflectedColor * getDiffuseCoefficient())
-      .add(specularColor)
-      .add(aluminumBaseColor)
-      .add(getAmbientColor() * getAmbientCoefficient());
+  Core::ScatterResult result{
+      aluminumBaseColor.add(specularColor)
+          .add(getAmbientColor() * getAmbientCoefficient())
+          .toRadiance()};
+  result.addRay(reflectRay, 0.7 * getDiffuseCoefficient());
+  return result;
 }
 
 } // namespace Raytracer::Plugins
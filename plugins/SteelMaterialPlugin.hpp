@@ -1,6 +1,5 @@
 #pragma once
 #include "Plugin/MaterialPlugin.hpp"
-#include <random>
 
 namespace Raytracer::Plugins {
 
@@ -43,28 +42,30 @@ public:
   bool configure(const libconfig::Setting &config) override;
 
   /**
-   * @brief Compute the color resulting from lighting at an intersection.
+   * @brief Shade an intersection and list the rays it spawns.
    * @param intersection Intersection information.
    * @param ray Incoming ray.
    * @param lights Lights affecting the intersection.
    * @param scene Scene containing all objects.
-   * @return Computed color.
+   * @param context State of the path, for random decisions.
+   * @return Color of the surface and spawned rays.
    */
-  [[nodiscard]] Core::Color
-  computeColor(const Core::Intersection &intersection, const Core::Ray &ray,
-               const std::vector<std::shared_ptr<Core::ILight>> &lights,
-               const Core::Scene &scene) const override;
+  [[nodiscard]] Core::ScatterResult
+  scatter(const Core::Intersection &intersection, const Core::Ray &ray,
+          const std::vector<const Core::ILight *> &lights,
+          const Core::Scene &scene,
+          Core::RenderContext &context) const override;
 
 private:
   /**
    * @brief Generate a random point in unit sphere for fuzz calculations.
+   * @param sampler Sampler of the current path.
    * @return A random vector inside unit sphere.
    */
-  [[nodiscard]] Math::Vector<3> randomInUnitSphere() const;
+  [[nodiscard]] static Math::Vector<3>
+  randomInUnitSphere(Core::Sampler &sampler) noexcept;
 
   double m_fuzz;
-  mutable std::mt19937 m_generator;
-  mutable std::uniform_real_distribution<double> m_distribution;
 };
 
 } // namespace Raytracer::Plugins
@@ -4,6 +4,7 @@
 #include "Factory/PrimitiveFactory.hpp"
 #include "Math/Point.hpp"
 #include "Parser/SceneParser.hpp"
+#include <algorithm>
 
 namespace Raytracer::Builder {
 
@@ -97,7 +98,17 @@ SceneBuilder::buildChildScenes(const libconfig::Setting &childScenes) {
     for (const auto &childScene : childScenes) {
       std::string id = childScene.getName();
 
+      std::string filename;
+      if (childScene.lookupValue("scene", filename)) {
+        if (auto prototype = loadPrototype(filename)) {
+          m_scene->addInstance(id, std::move(prototype),
+                               Parser::SceneParser::parseTransform(childScene));
+        }
+        continue;
+      }
+
       SceneBuilder childBuilder;
+      childBuilder.m_prototypes = m_prototypes;
       childBuilder.buildCamera(childScene.lookup("camera"))
           .buildPrimitives(childScene.lookup("primitives"))
           .buildLights(childScene.lookup("lights"));
@@ -112,4 +123,71 @@ SceneBuilder::buildChildScenes(const libconfig::Setting &childScenes) {
   }
   return *this;
 }
+
+SceneBuilder &
+SceneBuilder::buildPathTermination(const libconfig::Setting &config) {
+  Core::PathTermination termination;
+  double minContribution = 0.0;
+  int rouletteDepth = 0;
+  double rouletteThreshold = 0.0;
+
+  if (config.lookupValue("minContribution", minContribution)) {
+    termination.minContribution = std::max(minContribution, 0.0);
+  }
+  if (config.lookupValue("rouletteDepth", rouletteDepth)) {
+    termination.rouletteDepth =
+        static_cast<std::size_t>(std::max(rouletteDepth, 0));
+  }
+  if (config.lookupValue("rouletteThreshold", rouletteThreshold)) {
+    termination.rouletteThreshold = std::max(rouletteThreshold, 0.0);
+  }
+  m_scene->setPathTermination(termination);
+  return *this;
+}
+
+SceneBuilder &
+SceneBuilder::buildLightSampling(const libconfig::Setting &config) {
+  int count = 0;
+
+  if (config.lookupValue("count", count)) {
+    m_scene->setLightSampleCount(static_cast<std::size_t>(std::max(count, 0)));
+  }
+  return *this;
+}
+
+std::shared_ptr<const Core::Scene>
+SceneBuilder::loadPrototype(const std::string &filename) {
+  auto it = m_prototypes->find(filename);
+  if (it != m_prototypes->end()) {
+    return it->second;
+  }
+
+  // Registered before parsing so a file that includes itself is skipped
+  // instead of recursing forever.
+  (*m_prototypes)[filename] = nullptr;
+  try {
+    libconfig::Config config;
+    config.readFile(filename.c_str());
+
+    SceneBuilder builder;
+    builder.m_prototypes = m_prototypes;
+    builder.buildCamera(config.lookup("camera"))
+        .buildPrimitives(config.lookup("primitives"))
+        .buildLights(config.lookup("lights"));
+
+    if (config.exists("childScenes")) {
+      builder.buildChildScenes(config.lookup("childScenes"));
+    }
+
+    std::unique_ptr<Core::Scene> scene = builder.getResult();
+    scene->compile();
+    std::shared_ptr<const Core::Scene> prototype = std::move(scene);
+    (*m_prototypes)[filename] = prototype;
+    return prototype;
+  } catch (const libconfig::FileIOException &) {
+  } catch (const libconfig::ParseException &) {
+  } catch (const libconfig::SettingNotFoundException &) {
+  }
+  return nullptr;
+}
 } // namespace Raytracer::Builder
@@ -9,6 +9,8 @@
 #include "Core/Scene.hpp"
 #include "Parser/SceneParser.hpp"
 #include <libconfig.h++>
+#include <string>
+#include <unordered_map>
 namespace Raytracer::Builder {
 
 /**
@@ -39,10 +41,32 @@ public:
 
   /**
    * @brief Build child scenes from configuration
+   *
+   * A child scene given as a @c scene file path, with an optional position,
+   * rotation and scale, becomes an instance: every child loading the same
+   * file shares one parsed scene and its acceleration structure.
    * @param childScenes Configuration for child scenes
    */
   SceneBuilder &buildChildScenes(const libconfig::Setting &childScenes);
 
+  /**
+   * @brief Build the rules for terminating secondary rays
+   *
+   * Reads the optional @c minContribution, @c rouletteDepth and
+   * @c rouletteThreshold settings; missing ones keep their defaults.
+   * @param config The libconfig setting containing path termination
+   */
+  SceneBuilder &buildPathTermination(const libconfig::Setting &config);
+
+  /**
+   * @brief Build the light sampling settings
+   *
+   * Reads the optional @c count setting, the number of lights sampled per
+   * shading point; 0 or a missing setting evaluates every light.
+   * @param config The libconfig setting containing light sampling
+   */
+  SceneBuilder &buildLightSampling(const libconfig::Setting &config);
+
   /**
    * @brief Get the built scene
    */
@@ -51,6 +75,18 @@ public:
   }
 
 private:
+  using PrototypeCache =
+      std::unordered_map<std::string, std::shared_ptr<const Core::Scene>>;
+
+  /**
+   * @brief Load a scene file once and share it between instances.
+   * @param filename Path of the scene file.
+   * @return The compiled scene, nullptr if it could not be loaded.
+   */
+  std::shared_ptr<const Core::Scene> loadPrototype(const std::string &filename);
+
   std::unique_ptr<Core::Scene> m_scene;
+  std::shared_ptr<PrototypeCache> m_prototypes{
+      std::make_shared<PrototypeCache>()};
 };
 } // namespace Raytracer::Builder
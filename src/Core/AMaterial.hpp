@@ -52,17 +52,18 @@ public:
   AMaterial &operator=(AMaterial &&) = delete;
 
   /**
-   * @brief Compute the color resulting from lighting at an intersection.
+   * @brief Shade an intersection and list the rays it spawns.
    * @param intersection Intersection information.
    * @param ray Incoming ray.
    * @param lights Lights affecting the intersection.
    * @param scene Scene containing all objects.
-   * @return Computed color.
+   * @param context State of the path, for random decisions.
+   * @return Color of the surface and spawned rays.
    */
-  [[nodiscard]] Color
-  computeColor(const Intersection &intersection, const Ray &ray,
-               const std::vector<std::shared_ptr<ILight>> &lights,
-               const Scene &scene) const override = 0;
+  [[nodiscard]] ScatterResult
+  scatter(const Intersection &intersection, const Ray &ray,
+          const std::vector<const ILight *> &lights, const Scene &scene,
+          RenderContext &context) const override = 0;
 
   /**
    * @brief Get the diffuse color.
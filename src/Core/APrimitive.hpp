@@ -7,6 +7,8 @@
 
 #include "Core/IPrimitive.hpp"
 #include "Math/Transform.hpp"
+#include <atomic>
+#include <mutex>
 
 namespace Raytracer::Core {
 
@@ -37,7 +39,7 @@ public:
    */
   void setPosition(const Math::Point<3> &p) noexcept override {
     m_position = p;
-    updateTransform();
+    m_transformDirty.store(true, std::memory_order_release);
   }
 
   /**
@@ -46,7 +48,7 @@ public:
    */
   void setRotation(const Math::Vector<3> &r) noexcept override {
     m_rotation = r;
-    updateTransform();
+    m_transformDirty.store(true, std::memory_order_release);
   }
 
   /**
@@ -55,7 +57,7 @@ public:
    */
   void setScale(const Math::Vector<3> &s) noexcept override {
     m_scale = s;
-    updateTransform();
+    m_transformDirty.store(true, std::memory_order_release);
   }
 
   /**
@@ -65,7 +67,7 @@ public:
    */
   void setShear(const Math::Vector<6> &shear) noexcept override {
     m_shear = shear;
-    updateTransform();
+    m_transformDirty.store(true, std::memory_order_release);
   }
 
   /**
@@ -135,9 +137,20 @@ public:
 
   /**
    * @brief Get the current transformation.
+   *
+   * Setters only record their value; the transform is recomposed here, once
+   * after any number of edits. Concurrent callers are safe: the first one
+   * recomposes under a lock and the others then only pay for the check.
    * @return Reference to transform.
    */
   [[nodiscard]] const Math::Transform &getTransform() const noexcept {
+    if (m_transformDirty.load(std::memory_order_acquire)) {
+      std::lock_guard<std::mutex> lock(m_transformMutex);
+      if (m_transformDirty.load(std::memory_order_relaxed)) {
+        updateTransform();
+        m_transformDirty.store(false, std::memory_order_release);
+      }
+    }
     return m_transform;
   }
 
@@ -149,6 +162,56 @@ public:
   [[nodiscard]] std::optional<Intersection>
   intersect(const Ray &ray) const noexcept override = 0;
 
+  /**
+   * @brief Find the ray parameter of the closest hit.
+   *
+   * Falls back to intersect(); primitives override it together with
+   * computeIntersection() so candidates that end up hidden never pay for
+   * shading data.
+   * @param ray Ray to test.
+   * @param hit Closest hit so far, updated if this primitive is closer.
+   * @return true if @p hit was updated.
+   */
+  [[nodiscard]] bool findHit(const Ray &ray,
+                             HitRecord &hit) const noexcept override {
+    auto intersection = intersect(ray);
+    if (!intersection) {
+      return false;
+    }
+    double t = intersection->getDistance() / ray.getDirection().length();
+    if (!(t < hit.t)) {
+      return false;
+    }
+    hit = HitRecord{};
+    hit.t = t;
+    hit.primitive = this;
+    return true;
+  }
+
+  /**
+   * @brief Compute the surface data of a hit found by findHit().
+   * @param ray Ray that was passed to findHit().
+   * @param hit Record filled in by this primitive.
+   * @return Intersection data at the hit.
+   */
+  [[nodiscard]] Intersection computeIntersection(
+      const Ray &ray,
+      [[maybe_unused]] const HitRecord &hit) const noexcept override {
+    return intersect(ray).value_or(Intersection());
+  }
+
+  /**
+   * @brief Check whether a ray hits the primitive.
+   *
+   * Falls back to intersect(); primitives override it to skip computing the
+   * hit point, normal and texture coordinates.
+   * @param ray Ray to test.
+   * @return true if the ray hits the primitive within its distance range.
+   */
+  [[nodiscard]] bool occluded(const Ray &ray) const noexcept override {
+    return intersect(ray).has_value();
+  }
+
   /**
    * @brief Get the axis-aligned bounding box.
    * @return Bounding box of the primitive.
@@ -159,22 +222,31 @@ protected:
   /**
    * @brief Update the transformation based on position, rotation, and scale.
    */
-  void updateTransform() noexcept {
+  void updateTransform() const noexcept {
     Math::Transform rotation = Math::Transform::rotate(
         m_rotation.m_components[0], m_rotation.m_components[1],
         m_rotation.m_components[2]);
 
     Math::Transform scale = Math::Transform::scale(m_scale);
 
+    Math::Transform translation = Math::Transform::translate(
+        m_position.m_components[0], m_position.m_components[1],
+        m_position.m_components[2]);
+
+    bool sheared = false;
+    for (double amount : m_shear.m_components) {
+      sheared = sheared || amount != 0.0;
+    }
+    if (!sheared) {
+      m_transform = translation * rotation * scale;
+      return;
+    }
+
     Math::Transform shear = Math::Transform::shear(
         m_shear.m_components[0], m_shear.m_components[1],
         m_shear.m_components[2], m_shear.m_components[3],
         m_shear.m_components[4], m_shear.m_components[5]);
 
-    Math::Transform translation = Math::Transform::translate(
-        m_position.m_components[0], m_position.m_components[1],
-        m_position.m_components[2]);
-
     m_transform = translation * shear * rotation * scale;
   }
 
@@ -184,7 +256,9 @@ private:
   Math::Vector<3> m_scale{1.0, 1.0, 1.0};
   Math::Vector<6> m_shear{0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
   std::shared_ptr<IMaterial> m_material{nullptr};
-  Math::Transform m_transform{};
+  mutable Math::Transform m_transform{};
+  mutable std::atomic<bool> m_transformDirty{false};
+  mutable std::mutex m_transformMutex;
 };
 
 } // namespace Raytracer::Core
\ No newline at end of file
@@ -0,0 +1,193 @@
+#include "Core/BVH.hpp"
+#include <algorithm>
+#include <numeric>
+
+namespace Raytracer::Core {
+
+template <typename T>
+void BasicBVH<T>::build(const std::vector<BoundingBox> &bounds,
+                        std::size_t leafWidth) {
+  clear();
+  m_leafWidth = std::max<std::size_t>(leafWidth, 1);
+  if (bounds.empty()) {
+    return;
+  }
+
+  std::vector<Math::Point<3>> centers;
+  centers.reserve(bounds.size());
+  for (const auto &box : bounds) {
+    centers.push_back(box.getCenter());
+  }
+
+  m_items.resize(bounds.size());
+  std::iota(m_items.begin(), m_items.end(), 0);
+  m_nodes.reserve(2 * bounds.size());
+  buildNode(bounds, centers, 0, bounds.size(), 1);
+}
+
+template <typename T>
+std::vector<std::uint32_t>
+BasicBVH<T>::linearizeItems(std::size_t alignment) {
+  std::vector<std::uint32_t> previous;
+  previous.reserve(m_items.size());
+  for (Node &node : m_nodes) {
+    if (node.count == 0) {
+      continue;
+    }
+    while (previous.size() % alignment != 0) {
+      previous.push_back(NO_ITEM);
+    }
+    const auto first = m_items.begin() + node.offset;
+    node.offset = static_cast<std::uint32_t>(previous.size());
+    previous.insert(previous.end(), first, first + node.count);
+  }
+  m_items.resize(previous.size());
+  std::iota(m_items.begin(), m_items.end(), 0);
+  return previous;
+}
+
+template <typename T>
+std::uint32_t BasicBVH<T>::buildNode(const std::vector<BoundingBox> &bounds,
+                                     const std::vector<Math::Point<3>> &centers,
+                                     std::size_t begin, std::size_t end,
+                                     std::size_t depth) {
+  const auto nodeIndex = static_cast<std::uint32_t>(m_nodes.size());
+  m_nodes.emplace_back();
+
+  BoundingBox nodeBounds = bounds[m_items[begin]];
+  Math::Point<3> centerMin = centers[m_items[begin]];
+  Math::Point<3> centerMax = centerMin;
+  for (std::size_t i = begin + 1; i < end; ++i) {
+    nodeBounds = nodeBounds.unite(bounds[m_items[i]]);
+    const Math::Point<3> &center = centers[m_items[i]];
+    for (std::size_t axis = 0; axis < 3; ++axis) {
+      centerMin.m_components[axis] =
+          std::min(centerMin.m_components[axis], center.m_components[axis]);
+      centerMax.m_components[axis] =
+          std::max(centerMax.m_components[axis], center.m_components[axis]);
+    }
+  }
+  m_nodes[nodeIndex].bounds = Bounds::enclosing(nodeBounds);
+
+  const std::size_t count = end - begin;
+  auto makeLeaf = [&]() {
+    m_nodes[nodeIndex].offset = static_cast<std::uint32_t>(begin);
+    m_nodes[nodeIndex].count = static_cast<std::uint16_t>(count);
+    return nodeIndex;
+  };
+
+  if (count == 1) {
+    return makeLeaf();
+  }
+
+  std::size_t axis = 0;
+  for (std::size_t i = 1; i < 3; ++i) {
+    if (centerMax.m_components[i] - centerMin.m_components[i] >
+        centerMax.m_components[axis] - centerMin.m_components[axis]) {
+      axis = i;
+    }
+  }
+  const double extent =
+      centerMax.m_components[axis] - centerMin.m_components[axis];
+
+  auto groups = [this](std::size_t items) {
+    return static_cast<double>((items + m_leafWidth - 1) / m_leafWidth);
+  };
+
+  std::size_t mid = begin;
+  if (extent > 0.0 && depth < SAH_MAX_DEPTH) {
+    struct Bin {
+      BoundingBox bounds{};
+      std::size_t count{0};
+    };
+    std::array<Bin, SAH_BINS> bins{};
+    const double scale = static_cast<double>(SAH_BINS) / extent;
+    auto binOf = [&](std::uint32_t item) {
+      auto bin = static_cast<std::size_t>(
+          (centers[item].m_components[axis] - centerMin.m_components[axis]) *
+          scale);
+      return std::min(bin, SAH_BINS - 1);
+    };
+
+    for (std::size_t i = begin; i < end; ++i) {
+      Bin &bin = bins[binOf(m_items[i])];
+      bin.bounds = bin.count == 0 ? bounds[m_items[i]]
+                                  : bin.bounds.unite(bounds[m_items[i]]);
+      ++bin.count;
+    }
+
+    std::array<double, SAH_BINS - 1> leftArea{};
+    std::array<std::size_t, SAH_BINS - 1> leftCount{};
+    BoundingBox sweep{};
+    std::size_t sweepCount = 0;
+    for (std::size_t i = 0; i < SAH_BINS - 1; ++i) {
+      if (bins[i].count > 0) {
+        sweep = sweepCount == 0 ? bins[i].bounds : sweep.unite(bins[i].bounds);
+        sweepCount += bins[i].count;
+      }
+      leftArea[i] = sweepCount > 0 ? sweep.surfaceArea() : 0.0;
+      leftCount[i] = sweepCount;
+    }
+
+    double bestCost = std::numeric_limits<double>::infinity();
+    std::size_t bestSplit = 0;
+    sweepCount = 0;
+    for (std::size_t i = SAH_BINS - 1; i > 0; --i) {
+      if (bins[i].count > 0) {
+        sweep = sweepCount == 0 ? bins[i].bounds : sweep.unite(bins[i].bounds);
+        sweepCount += bins[i].count;
+      }
+      if (sweepCount == 0 || leftCount[i - 1] == 0) {
+        continue;
+      }
+      double cost = leftArea[i - 1] * groups(leftCount[i - 1]) +
+                    sweep.surfaceArea() * groups(sweepCount);
+      if (cost < bestCost) {
+        bestCost = cost;
+        bestSplit = i;
+      }
+    }
+
+    const double parentArea = nodeBounds.surfaceArea();
+    const double leafCost = INTERSECTION_COST * groups(count);
+    const double splitCost =
+        parentArea > 0.0
+            ? TRAVERSAL_COST + INTERSECTION_COST * bestCost / parentArea
+            : leafCost;
+    if (count <= MAX_LEAF_SIZE && leafCost <= splitCost) {
+      return makeLeaf();
+    }
+
+    if (bestSplit > 0) {
+      auto *split = std::partition(
+          m_items.data() + begin, m_items.data() + end,
+          [&](std::uint32_t item) { return binOf(item) < bestSplit; });
+      mid = static_cast<std::size_t>(split - m_items.data());
+    }
+  } else if (count <= MAX_LEAF_SIZE) {
+    return makeLeaf();
+  }
+
+  // Unproductive SAH splits, degenerate centers and very deep nodes fall back
+  // to a median split, which halves the range and keeps the depth bounded.
+  if (mid == begin || mid == end) {
+    mid = begin + count / 2;
+    std::nth_element(m_items.begin() + static_cast<std::ptrdiff_t>(begin),
+                     m_items.begin() + static_cast<std::ptrdiff_t>(mid),
+                     m_items.begin() + static_cast<std::ptrdiff_t>(end),
+                     [&](std::uint32_t a, std::uint32_t b) {
+                       return centers[a].m_components[axis] <
+                              centers[b].m_components[axis];
+                     });
+  }
+
+  m_nodes[nodeIndex].axis = static_cast<std::uint8_t>(axis);
+  buildNode(bounds, centers, begin, mid, depth + 1);
+  m_nodes[nodeIndex].offset = buildNode(bounds, centers, mid, end, depth + 1);
+  return nodeIndex;
+}
+
+template class BasicBVH<double>;
+template class BasicBVH<float>;
+
+} // namespace Raytracer::Core
@@ -0,0 +1,520 @@
+/**
+ * @file BVH.hpp
+ * @brief Defines the bounding volume hierarchy used to accelerate ray queries.
+ */
+
+#pragma once
+
+#include "Core/BoundingBox.hpp"
+#include "Core/Ray.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace Raytracer::Core {
+
+/**
+ * @class BasicBVH
+ * @brief Binary bounding volume hierarchy built with the surface area
+ * heuristic.
+ * @tparam T The type of the node bounds.
+ *
+ * The hierarchy only stores boxes and item indices, so the same structure
+ * accelerates scene primitives and mesh triangles alike: callers hand it one
+ * box per item and receive those indices back in traverse().
+ *
+ * Node bounds are rounded outwards to @p T, so single-precision nodes halve
+ * the memory of the hierarchy while still enclosing their items. Ray tests
+ * run in double precision either way.
+ */
+template <typename T> class BasicBVH final {
+public:
+  /** Bounding box of a node. */
+  using Bounds = BasicBoundingBox<T>;
+
+  /**
+   * @struct Node
+   * @brief Flattened hierarchy node, stored in depth-first order.
+   *
+   * The left child of an interior node immediately follows it, @c offset
+   * holds the index of the right child. For leaves @c offset is the first
+   * entry of the item list and @c count the number of items.
+   */
+  struct Node {
+    Bounds bounds{};
+    std::uint32_t offset{0};
+    std::uint16_t count{0};
+    std::uint8_t axis{0};
+  };
+
+  /** Largest number of rays traversePacket() traces together. */
+  static constexpr std::size_t PACKET_SIZE = 8;
+
+  /**
+   * @brief Build the hierarchy over a set of item bounds.
+   *
+   * Callers that test the items of a leaf several at a time give that
+   * number as @p leafWidth: the surface area heuristic then charges a leaf
+   * one intersection per group of items, which favours fuller leaves.
+   * @param bounds One bounding box per item; every box must be finite.
+   * @param leafWidth Number of items tested together.
+   */
+  void build(const std::vector<BoundingBox> &bounds,
+             std::size_t leafWidth = 1);
+
+  /**
+   * @brief Remove every node and item.
+   */
+  void clear() noexcept {
+    m_nodes.clear();
+    m_items.clear();
+  }
+
+  /**
+   * @brief Check whether the hierarchy holds any item.
+   * @return true if nothing was built.
+   */
+  [[nodiscard]] bool empty() const noexcept { return m_nodes.empty(); }
+
+  /**
+   * @brief Get the bounds of every item in the hierarchy.
+   * @return Root bounding box, a default box when empty.
+   */
+  [[nodiscard]] Bounds getBounds() const noexcept {
+    return m_nodes.empty() ? Bounds() : m_nodes.front().bounds;
+  }
+
+  /**
+   * @brief Get the flattened nodes.
+   * @return Node array, root first.
+   */
+  [[nodiscard]] const std::vector<Node> &getNodes() const noexcept {
+    return m_nodes;
+  }
+
+  /**
+   * @brief Visit the items whose boxes the ray overlaps, nearest first.
+   *
+   * Children are visited front-to-back by box entry distance and any subtree
+   * entered beyond the current @c tMax is skipped, so a leaf callback that
+   * shrinks @c tMax to its closest hit prunes everything behind it.
+   *
+   * @tparam LeafFn Callable as <tt>bool(std::uint32_t item, double &tMax)</tt>;
+   * returning true stops the traversal (any-hit queries).
+   * @param ray Ray to trace; its distance range bounds the search.
+   * @param leaf Callback invoked for each candidate item.
+   * @return true if a callback requested termination.
+   */
+  template <typename LeafFn>
+  bool traverse(const Ray &ray, LeafFn &&leaf) const {
+    return traverseLeaves(ray, forEachItem(leaf));
+  }
+
+  /**
+   * @brief Visit the leaves whose boxes the ray overlaps, nearest first.
+   *
+   * Same walk as traverse(), handing over the items of a leaf at once so
+   * the caller can test them together. After linearizeItems() the items of
+   * a leaf are consecutive indices.
+   *
+   * @tparam LeafFn Callable as
+   * <tt>bool(std::span<const std::uint32_t> items, double &tMax)</tt>;
+   * returning true stops the traversal (any-hit queries).
+   * @param ray Ray to trace; its distance range bounds the search.
+   * @param leaf Callback invoked for each candidate leaf.
+   * @return true if a callback requested termination.
+   */
+  template <typename LeafFn>
+  bool traverseLeaves(const Ray &ray, LeafFn &&leaf) const {
+    if (m_nodes.empty()) {
+      return false;
+    }
+
+    const Math::Point<3> origin = ray.getOrigin();
+    const Math::Vector<3> invDirection = inverseDirection(ray);
+    const double tMin = ray.getMinDistance();
+    double tMax = ray.getMaxDistance();
+
+    double entry = 0.0;
+    if (!m_nodes[0].bounds.intersect(origin, invDirection, tMin, tMax,
+                                     entry)) {
+      return false;
+    }
+    return traverseLeafRanges(origin, invDirection, tMin, tMax, 0, entry,
+                              leaf);
+  }
+
+  /** Entry of linearizeItems() standing for an unused slot. */
+  static constexpr std::uint32_t NO_ITEM = 0xFFFFFFFFu;
+
+  /**
+   * @brief Renumber the items so that every leaf holds consecutive ones.
+   *
+   * Items are numbered in the order the leaves store them, and the first
+   * item of every leaf gets an index that is a multiple of @p alignment so
+   * callers can keep the items of a leaf in fixed-size blocks. Indices
+   * skipped to align a leaf belong to no item. The caller must reorder its
+   * per-item data with the returned table.
+   * @param alignment Multiple every leaf starts at.
+   * @return Former index of each new index, NO_ITEM for skipped ones.
+   */
+  std::vector<std::uint32_t> linearizeItems(std::size_t alignment = 1);
+
+  /**
+   * @brief Visit the items overlapped by a packet of rays.
+   *
+   * Rays whose directions share a sign octant walk the hierarchy together:
+   * a node is fetched and tested once for the whole packet, descended into
+   * if any ray overlaps it and ordered by the nearest entry among those
+   * rays. Once a subtree is overlapped by a single ray, that ray carries on
+   * alone with the traverse() loop. Packets spread over several octants do
+   * not share enough nodes to be worth it and are traced one ray at a time.
+   * Each ray sees the same items and pruning it would see in traverse().
+   *
+   * @tparam LeafFn Callable as
+   * <tt>std::uint32_t(std::uint32_t item, std::uint32_t lanes)</tt>, where
+   * bit @c i of @c lanes stands for @c rays[i]; it returns the lanes whose
+   * traversal is over (any-hit queries), 0 to continue.
+   * @param rays Rays to trace, at most PACKET_SIZE.
+   * @param lanes Rays to trace among @p rays, one bit each.
+   * @param tMax Far distance of each ray, initialised from the rays by the
+   * caller; the callback may shrink it to prune the search of that ray.
+   * @param leaf Callback invoked for each candidate item.
+   */
+  template <typename LeafFn>
+  void traversePacket(std::span<const Ray> rays, std::uint32_t lanes,
+                      std::array<double, PACKET_SIZE> &tMax,
+                      LeafFn &&leaf) const {
+    const std::size_t count = std::min(rays.size(), PACKET_SIZE);
+    if (m_nodes.empty() || count == 0 || lanes == 0) {
+      return;
+    }
+
+    // Lanes are stored per component so the slab test runs over the whole
+    // packet at once; unused lanes hold zeros and are masked out.
+    std::array<std::array<double, PACKET_SIZE>, 3> origins{};
+    std::array<std::array<double, PACKET_SIZE>, 3> invDirections{};
+    std::array<double, PACKET_SIZE> tMins{};
+    std::uint32_t active = 0;
+    bool coherent = true;
+    unsigned firstOctant = 0;
+    for (std::size_t lane = 0; lane < count; ++lane) {
+      if ((lanes >> lane & 1u) == 0) {
+        continue;
+      }
+      const Math::Vector<3> invDirection = inverseDirection(rays[lane]);
+      for (std::size_t axis = 0; axis < 3; ++axis) {
+        origins[axis][lane] = rays[lane].getOrigin().m_components[axis];
+        invDirections[axis][lane] = invDirection.m_components[axis];
+      }
+      tMins[lane] = rays[lane].getMinDistance();
+      if (active == 0) {
+        firstOctant = octant(invDirection);
+      }
+      coherent = coherent && octant(invDirection) == firstOctant;
+      active |= 1u << lane;
+    }
+
+    // Carries on with a single lane from a node it is known to overlap,
+    // or from the root when no entry distance is given.
+    auto traceLane = [&](std::size_t lane, std::uint32_t node,
+                         std::optional<double> entry) {
+      const std::uint32_t bit = 1u << lane;
+      const Math::Point<3> origin(origins[0][lane], origins[1][lane],
+                                  origins[2][lane]);
+      const Math::Vector<3> invDirection(invDirections[0][lane],
+                                         invDirections[1][lane],
+                                         invDirections[2][lane]);
+      double rootEntry = 0.0;
+      if (!entry && !m_nodes[0].bounds.intersect(origin, invDirection,
+                                                  tMins[lane], tMax[lane],
+                                                  rootEntry)) {
+        return;
+      }
+      auto laneLeaf = [&](std::uint32_t item, double &) {
+        return (leaf(item, bit) & bit) != 0;
+      };
+      if (traverseSubtree(origin, invDirection, tMins[lane], tMax[lane], node,
+                          entry.value_or(rootEntry), laneLeaf)) {
+        active &= ~bit;
+      }
+    };
+
+    if (!coherent) {
+      for (std::size_t lane = 0; lane < count; ++lane) {
+        if ((active >> lane & 1u) != 0) {
+          traceLane(lane, 0, std::nullopt);
+        }
+      }
+      return;
+    }
+
+    struct Pending {
+      std::uint32_t node;
+      std::uint32_t lanes;
+      std::array<double, PACKET_SIZE> entries;
+    };
+    // Same arithmetic as BoundingBox::intersect(), without its early exit:
+    // once a lane misses a slab its range stays empty, so the outcome and
+    // the entry distances are unchanged.
+    auto testNode = [&](std::uint32_t node, std::uint32_t mask,
+                        Pending &pending, double &nearest) {
+      const Bounds &box = m_nodes[node].bounds;
+      std::array<double, PACKET_SIZE> tNear = tMins;
+      std::array<double, PACKET_SIZE> tFar = tMax;
+      for (std::size_t axis = 0; axis < 3; ++axis) {
+        const double low = box.getMin().m_components[axis];
+        const double high = box.getMax().m_components[axis];
+        for (std::size_t lane = 0; lane < PACKET_SIZE; ++lane) {
+          const double t0 =
+              (low - origins[axis][lane]) * invDirections[axis][lane];
+          const double t1 =
+              (high - origins[axis][lane]) * invDirections[axis][lane];
+          const double slabNear = t0 > t1 ? t1 : t0;
+          const double slabFar = (t0 > t1 ? t0 : t1) * BoundingBox::EXIT_SCALE;
+          tNear[lane] = slabNear > tNear[lane] ? slabNear : tNear[lane];
+          tFar[lane] = slabFar < tFar[lane] ? slabFar : tFar[lane];
+        }
+      }
+
+      pending.node = node;
+      pending.lanes = 0;
+      pending.entries = tNear;
+      nearest = std::numeric_limits<double>::infinity();
+      for (std::size_t lane = 0; lane < count; ++lane) {
+        if ((mask >> lane & 1u) != 0 && tNear[lane] <= tFar[lane]) {
+          pending.lanes |= 1u << lane;
+          nearest = std::min(nearest, tNear[lane]);
+        }
+      }
+      return pending.lanes != 0;
+    };
+
+    std::array<Pending, MAX_DEPTH> stack;
+    std::size_t stackSize = 0;
+    Pending rootPending{};
+    double nearest = 0.0;
+    if (!testNode(0, active, rootPending, nearest)) {
+      return;
+    }
+    stack[stackSize++] = rootPending;
+
+    while (stackSize > 0 && active != 0) {
+      const Pending pending = stack[--stackSize];
+      std::uint32_t live = pending.lanes & active;
+      for (std::size_t lane = 0; lane < count; ++lane) {
+        if ((live >> lane & 1u) != 0 && pending.entries[lane] > tMax[lane]) {
+          live &= ~(1u << lane);
+        }
+      }
+      if (live == 0) {
+        continue;
+      }
+      if ((live & (live - 1)) == 0) {
+        const auto lane = static_cast<std::size_t>(std::countr_zero(live));
+        traceLane(lane, pending.node, pending.entries[lane]);
+        continue;
+      }
+
+      const Node &node = m_nodes[pending.node];
+      if (node.count > 0) {
+        for (std::uint32_t i = 0; i < node.count && live != 0; ++i) {
+          const std::uint32_t done = leaf(m_items[node.offset + i], live);
+          live &= ~done;
+          active &= ~done;
+        }
+        continue;
+      }
+
+      const std::uint32_t left = pending.node + 1;
+      const std::uint32_t right = node.offset;
+      Pending leftPending{};
+      Pending rightPending{};
+      double leftEntry = 0.0;
+      double rightEntry = 0.0;
+      const bool hitLeft = testNode(left, live, leftPending, leftEntry);
+      const bool hitRight = testNode(right, live, rightPending, rightEntry);
+
+      if (hitLeft && hitRight) {
+        if (leftEntry <= rightEntry) {
+          stack[stackSize++] = rightPending;
+          stack[stackSize++] = leftPending;
+        } else {
+          stack[stackSize++] = leftPending;
+          stack[stackSize++] = rightPending;
+        }
+      } else if (hitLeft) {
+        stack[stackSize++] = leftPending;
+      } else if (hitRight) {
+        stack[stackSize++] = rightPending;
+      }
+    }
+  }
+
+private:
+  static constexpr std::size_t MAX_DEPTH = 128;
+  static constexpr std::size_t SAH_MAX_DEPTH = 64;
+  static constexpr std::size_t MAX_LEAF_SIZE = 8;
+  static constexpr std::size_t SAH_BINS = 16;
+  static constexpr double TRAVERSAL_COST = 1.0;
+  static constexpr double INTERSECTION_COST = 1.0;
+
+  /**
+   * @brief Compute the per-axis inverse of a ray direction.
+   * @param ray Ray whose direction is inverted.
+   * @return Inverse direction, infinite on axes the ray is parallel to.
+   */
+  [[nodiscard]] static Math::Vector<3>
+  inverseDirection(const Ray &ray) noexcept {
+    const Math::Vector<3> direction = ray.getDirection();
+    return Math::Vector<3>(1.0 / direction.m_components[0],
+                           1.0 / direction.m_components[1],
+                           1.0 / direction.m_components[2]);
+  }
+
+  /**
+   * @brief Get the sign octant of a direction.
+   * @param invDirection Inverse direction of a ray.
+   * @return One bit per axis, set when the axis is travelled backwards.
+   */
+  [[nodiscard]] static unsigned octant(
+      const Math::Vector<3> &invDirection) noexcept {
+    return (std::signbit(invDirection.m_components[0]) ? 1u : 0u) |
+           (std::signbit(invDirection.m_components[1]) ? 2u : 0u) |
+           (std::signbit(invDirection.m_components[2]) ? 4u : 0u);
+  }
+
+  /**
+   * @brief Adapt a per-item callback to a per-leaf one.
+   * @tparam LeafFn Same as in traverse().
+   * @param leaf Callback invoked for each item of the leaf.
+   * @return Callback for traverseLeafRanges().
+   */
+  template <typename LeafFn> static auto forEachItem(LeafFn &leaf) {
+    return [&leaf](std::span<const std::uint32_t> items, double &tMax) {
+      for (std::uint32_t item : items) {
+        if (leaf(item, tMax)) {
+          return true;
+        }
+      }
+      return false;
+    };
+  }
+
+  /**
+   * @brief Visit the items of a subtree whose boxes a ray overlaps.
+   * @tparam LeafFn Same as in traverse().
+   * @param origin Origin of the ray.
+   * @param invDirection Inverse direction of the ray.
+   * @param tMin Near distance of the ray.
+   * @param tMax Far distance of the ray, shrunk by the callback.
+   * @param root Index of the subtree's root, already known to be overlapped.
+   * @param entry Distance at which the ray enters the root's box.
+   * @param leaf Callback invoked for each candidate item.
+   * @return true if a callback requested termination.
+   */
+  template <typename LeafFn>
+  bool traverseSubtree(const Math::Point<3> &origin,
+                       const Math::Vector<3> &invDirection, double tMin,
+                       double &tMax, std::uint32_t root, double entry,
+                       LeafFn &&leaf) const {
+    return traverseLeafRanges(origin, invDirection, tMin, tMax, root, entry,
+                              forEachItem(leaf));
+  }
+
+  /**
+   * @brief Visit the leaves of a subtree whose boxes a ray overlaps.
+   * @tparam LeafFn Same as in traverseLeaves().
+   * @param origin Origin of the ray.
+   * @param invDirection Inverse direction of the ray.
+   * @param tMin Near distance of the ray.
+   * @param tMax Far distance of the ray, shrunk by the callback.
+   * @param root Index of the subtree's root, already known to be overlapped.
+   * @param entry Distance at which the ray enters the root's box.
+   * @param leaf Callback invoked for each candidate leaf.
+   * @return true if a callback requested termination.
+   */
+  template <typename LeafFn>
+  bool traverseLeafRanges(const Math::Point<3> &origin,
+                          const Math::Vector<3> &invDirection, double tMin,
+                          double &tMax, std::uint32_t root, double entry,
+                          LeafFn &&leaf) const {
+    struct Pending {
+      std::uint32_t node;
+      double entry;
+    };
+    std::array<Pending, MAX_DEPTH> stack;
+    std::size_t stackSize = 0;
+    stack[stackSize++] = {root, entry};
+
+    while (stackSize > 0) {
+      const Pending pending = stack[--stackSize];
+      if (pending.entry > tMax) {
+        continue;
+      }
+
+      const Node &node = m_nodes[pending.node];
+      if (node.count > 0) {
+        if (leaf(std::span<const std::uint32_t>(m_items.data() + node.offset,
+                                                node.count),
+                 tMax)) {
+          return true;
+        }
+        continue;
+      }
+
+      const std::uint32_t left = pending.node + 1;
+      const std::uint32_t right = node.offset;
+      double leftEntry = 0.0;
+      double rightEntry = 0.0;
+      const bool hitLeft = m_nodes[left].bounds.intersect(
+          origin, invDirection, tMin, tMax, leftEntry);
+      const bool hitRight = m_nodes[right].bounds.intersect(
+          origin, invDirection, tMin, tMax, rightEntry);
+
+      if (hitLeft && hitRight) {
+        if (leftEntry <= rightEntry) {
+          stack[stackSize++] = {right, rightEntry};
+          stack[stackSize++] = {left, leftEntry};
+        } else {
+          stack[stackSize++] = {left, leftEntry};
+          stack[stackSize++] = {right, rightEntry};
+        }
+      } else if (hitLeft) {
+        stack[stackSize++] = {left, leftEntry};
+      } else if (hitRight) {
+        stack[stackSize++] = {right, rightEntry};
+      }
+    }
+    return false;
+  }
+
+  /**
+   * @brief Recursively build the subtree covering items [begin, end).
+   * @param bounds Item bounds, indexed by item.
+   * @param centers Item box centers, indexed by item.
+   * @param begin First entry of m_items covered by the node.
+   * @param end One past the last entry of m_items covered by the node.
+   * @param depth Depth of the node being built.
+   * @return Index of the created node.
+   */
+  std::uint32_t buildNode(const std::vector<BoundingBox> &bounds,
+                          const std::vector<Math::Point<3>> &centers,
+                          std::size_t begin, std::size_t end,
+                          std::size_t depth);
+
+  std::vector<Node> m_nodes;
+  std::vector<std::uint32_t> m_items;
+  std::size_t m_leafWidth{1};
+};
+
+/** Hierarchy with double-precision nodes, used for scene primitives. */
+using BVH = BasicBVH<double>;
+
+} // namespace Raytracer::Core
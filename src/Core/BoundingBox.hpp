@@ -7,42 +7,156 @@
 
 #include "Core/Ray.hpp"
 #include "Math/Point.hpp"
+#include "Math/Vector.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
 
 namespace Raytracer::Core {
 
 /**
- * @class BoundingBox
+ * @class BasicBoundingBox
  * @brief Axis-aligned bounding box for spatial queries.
+ * @tparam T The type of the bounds.
+ *
+ * Single-precision boxes halve the memory of acceleration structures. Ray
+ * tests always run in double precision, on bounds that convert to it
+ * exactly, so their outcome only depends on the stored bounds.
  */
-class BoundingBox final {
+template <typename T> class BasicBoundingBox final {
 public:
+  /**
+   * Factor widening slab exit distances by a few ulps, so rounding in the
+   * slab test never rejects a ray that grazes the box.
+   */
+  static constexpr double EXIT_SCALE =
+      1.0 + 2.0 * (3.0 * std::numeric_limits<double>::epsilon() * 0.5) /
+                (1.0 - 3.0 * std::numeric_limits<double>::epsilon() * 0.5);
+
   /**
    * @brief Default constructor.
    */
-  constexpr BoundingBox() noexcept = default;
+  constexpr BasicBoundingBox() noexcept = default;
 
   /**
    * @brief Construct with given bounds.
    * @param min Minimum corner of the box.
    * @param max Maximum corner of the box.
    */
-  constexpr BoundingBox(const Math::Point<3> &min,
-                        const Math::Point<3> &max) noexcept
+  constexpr BasicBoundingBox(const Math::Point<3, T> &min,
+                             const Math::Point<3, T> &max) noexcept
       : m_min(min), m_max(max) {}
 
+  /**
+   * @brief Create a box enclosing all of space.
+   * @return Box with infinite bounds on every axis.
+   */
+  [[nodiscard]] static BasicBoundingBox infinite() noexcept {
+    constexpr T inf = std::numeric_limits<T>::infinity();
+    return BasicBoundingBox(Math::Point<3, T>(-inf, -inf, -inf),
+                            Math::Point<3, T>(inf, inf, inf));
+  }
+
+  /**
+   * @brief Create the smallest box of this precision enclosing another box.
+   *
+   * Bounds that the type cannot represent exactly are rounded outwards, so
+   * every point of @p box stays inside the result.
+   * @tparam U The type of the bounds of @p box.
+   * @param box Box to enclose.
+   * @return Enclosing box.
+   */
+  template <typename U>
+  [[nodiscard]] static BasicBoundingBox
+  enclosing(const BasicBoundingBox<U> &box) noexcept {
+    Math::Point<3, T> min;
+    Math::Point<3, T> max;
+    for (std::size_t i = 0; i < 3; ++i) {
+      const U low = box.getMin().m_components[i];
+      const U high = box.getMax().m_components[i];
+      min.m_components[i] = static_cast<T>(low);
+      max.m_components[i] = static_cast<T>(high);
+      if (min.m_components[i] > low) {
+        min.m_components[i] = std::nextafter(
+            min.m_components[i], -std::numeric_limits<T>::infinity());
+      }
+      if (max.m_components[i] < high) {
+        max.m_components[i] = std::nextafter(
+            max.m_components[i], std::numeric_limits<T>::infinity());
+      }
+    }
+    return BasicBoundingBox(min, max);
+  }
+
   /**
    * @brief Test intersection with a ray.
    * @param ray Ray to test against.
-   * @return true if the ray intersects the box.
+   * @return true if the ray intersects the box within its distance range.
+   */
+  [[nodiscard]] bool intersect(const Ray &ray) const noexcept {
+    const Math::Vector<3> direction = ray.getDirection();
+    const Math::Vector<3> invDirection(1.0 / direction.m_components[0],
+                                       1.0 / direction.m_components[1],
+                                       1.0 / direction.m_components[2]);
+    double entry = 0.0;
+    return intersect(ray.getOrigin(), invDirection, ray.getMinDistance(),
+                     ray.getMaxDistance(), entry);
+  }
+
+  /**
+   * @brief Slab test against a ray with a precomputed inverse direction.
+   * @param origin Ray origin.
+   * @param invDirection Component-wise inverse of the ray direction.
+   * @param tMin Minimum ray parameter.
+   * @param tMax Maximum ray parameter.
+   * @param entry Set to the parameter at which the ray enters the box.
+   * @return true if the ray overlaps the box within [tMin, tMax].
+   * @note Comparisons are ordered so that NaN slabs (ray origin on a slab
+   * plane with a zero direction component) are ignored, and the exit
+   * distance is widened by a few ulps so hits on the surface are kept.
    */
-  [[nodiscard]] bool intersect(const Ray &ray) const noexcept;
+  [[nodiscard]] bool intersect(const Math::Point<3> &origin,
+                               const Math::Vector<3> &invDirection,
+                               double tMin, double tMax,
+                               double &entry) const noexcept {
+    for (std::size_t i = 0; i < 3; ++i) {
+      double tNear = (static_cast<double>(m_min.m_components[i]) -
+                      origin.m_components[i]) *
+                     invDirection.m_components[i];
+      double tFar = (static_cast<double>(m_max.m_components[i]) -
+                     origin.m_components[i]) *
+                    invDirection.m_components[i];
+      if (tNear > tFar) {
+        std::swap(tNear, tFar);
+      }
+      tFar *= EXIT_SCALE;
+      tMin = tNear > tMin ? tNear : tMin;
+      tMax = tFar < tMax ? tFar : tMax;
+      if (tMin > tMax) {
+        return false;
+      }
+    }
+    entry = tMin;
+    return true;
+  }
 
   /**
    * @brief Compute the union of this box and another.
    * @param other Other bounding box to unite with.
    * @return Bounding box that encloses both.
    */
-  [[nodiscard]] BoundingBox unite(const BoundingBox &other) const noexcept;
+  [[nodiscard]] BasicBoundingBox
+  unite(const BasicBoundingBox &other) const noexcept {
+    Math::Point<3, T> min;
+    Math::Point<3, T> max;
+    for (std::size_t i = 0; i < 3; ++i) {
+      min.m_components[i] =
+          std::min(m_min.m_components[i], other.m_min.m_components[i]);
+      max.m_components[i] =
+          std::max(m_max.m_components[i], other.m_max.m_components[i]);
+    }
+    return BasicBoundingBox(min, max);
+  }
 
   /**
    * @brief Check if a point is inside the box.
@@ -50,13 +164,58 @@ public:
    * @return true if the point lies within the bounds.
    */
   [[nodiscard]] constexpr bool
-  contains(const Math::Point<3> &point) const noexcept;
+  contains(const Math::Point<3, T> &point) const noexcept {
+    for (std::size_t i = 0; i < 3; ++i) {
+      if (point.m_components[i] < m_min.m_components[i] ||
+          point.m_components[i] > m_max.m_components[i]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * @brief Check whether every bound of the box is finite.
+   * @return false for infinite primitives such as planes.
+   */
+  [[nodiscard]] bool isBounded() const noexcept {
+    for (std::size_t i = 0; i < 3; ++i) {
+      if (!std::isfinite(m_min.m_components[i]) ||
+          !std::isfinite(m_max.m_components[i])) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * @brief Get the center of the box.
+   * @return Midpoint between the two corners.
+   */
+  [[nodiscard]] Math::Point<3, T> getCenter() const noexcept {
+    constexpr T half = static_cast<T>(0.5);
+    return Math::Point<3, T>(
+        half * (m_min.m_components[0] + m_max.m_components[0]),
+        half * (m_min.m_components[1] + m_max.m_components[1]),
+        half * (m_min.m_components[2] + m_max.m_components[2]));
+  }
+
+  /**
+   * @brief Compute the surface area of the box.
+   * @return Surface area, 0 for degenerate or inverted boxes.
+   */
+  [[nodiscard]] T surfaceArea() const noexcept {
+    T dx = std::max(T{}, m_max.m_components[0] - m_min.m_components[0]);
+    T dy = std::max(T{}, m_max.m_components[1] - m_min.m_components[1]);
+    T dz = std::max(T{}, m_max.m_components[2] - m_min.m_components[2]);
+    return static_cast<T>(2.0) * (dx * dy + dy * dz + dz * dx);
+  }
 
   /**
    * @brief Get the minimum corner.
    * @return Reference to the minimum point.
    */
-  [[nodiscard]] constexpr const Math::Point<3> &getMin() const noexcept {
+  [[nodiscard]] constexpr const Math::Point<3, T> &getMin() const noexcept {
     return m_min;
   }
 
@@ -64,13 +223,16 @@ public:
    * @brief Get the maximum corner.
    * @return Reference to the maximum point.
    */
-  [[nodiscard]] constexpr const Math::Point<3> &getMax() const noexcept {
+  [[nodiscard]] constexpr const Math::Point<3, T> &getMax() const noexcept {
     return m_max;
   }
 
 private:
-  Math::Point<3> m_min{};
-  Math::Point<3> m_max{};
+  Math::Point<3, T> m_min{};
+  Math::Point<3, T> m_max{};
 };
 
+/** Bounding box in double precision, used throughout the scene. */
+using BoundingBox = BasicBoundingBox<double>;
+
 } // namespace Raytracer::Core
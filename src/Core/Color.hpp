@@ -6,9 +6,13 @@
 #pragma once
 
 #include "Utility/Clamped.hpp"
+#include <array>
 
 namespace Raytracer::Core {
 
+/** Red, green and blue sums, not clamped to the displayable range. */
+using Radiance = std::array<double, 3>;
+
 /**
  * @class Color
  * @brief Represents an RGB color with clamped components.
@@ -47,6 +51,14 @@ public:
    */
   [[nodiscard]] constexpr double getB() const noexcept { return m_b.get(); }
 
+  /**
+   * @brief Get the components as an unclamped sum to add to.
+   * @return Red, green and blue components.
+   */
+  [[nodiscard]] constexpr Radiance toRadiance() const noexcept {
+    return {getR(), getG(), getB()};
+  }
+
   /**
    * @brief Set red component.
    * @param red New red value.
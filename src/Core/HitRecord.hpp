@@ -0,0 +1,39 @@
+/**
+ * @file HitRecord.hpp
+ * @brief Defines the lightweight record produced by the distance-only phase
+ * of ray-primitive tests.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+namespace Raytracer::Core {
+class IPrimitive;
+struct SceneInstance;
+
+/**
+ * @struct HitRecord
+ * @brief Closest hit found so far, before any surface data is computed.
+ *
+ * Primitives only fill in the ray parameter and a few values of their own
+ * choosing; IPrimitive::computeIntersection() turns the record into a full
+ * Intersection once the closest hit is known.
+ */
+struct HitRecord {
+  /** Ray parameter of the hit; candidates must be strictly closer. */
+  double t{std::numeric_limits<double>::infinity()};
+  /** Primitive that was hit. */
+  const IPrimitive *primitive{nullptr};
+  /** Outermost instance containing the primitive, if any. */
+  const SceneInstance *instance{nullptr};
+  /** Primitive-defined payload, e.g. the surface or triangle hit. */
+  std::uint32_t index{0};
+  /** Primitive-defined payload, e.g. barycentric coordinates. */
+  double u{0.0};
+  /** Primitive-defined payload, e.g. barycentric coordinates. */
+  double v{0.0};
+};
+
+} // namespace Raytracer::Core
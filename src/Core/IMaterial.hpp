@@ -7,7 +7,11 @@
 #pragma once
 
 #include "Core/Color.hpp"
+#include "Core/Ray.hpp"
+#include "Core/RenderContext.hpp"
 #include "Core/Scene.hpp"
+#include <array>
+#include <cstddef>
 #include <memory>
 #include <vector>
 
@@ -15,7 +19,61 @@ namespace Raytracer::Core {
 
 class ILight;
 class Intersection;
-class Ray;
+
+/**
+ * @struct ScatteredRay
+ * @brief Secondary ray spawned by a material.
+ */
+struct ScatteredRay {
+  /** Ray to trace. */
+  Ray ray;
+  /** Factor applied to the color the ray brings back. */
+  double weight{0.0};
+  /** Color added instead when the ray hits nothing, not scaled by weight. */
+  Color missColor{};
+  /** Factor applied to missColor. */
+  double missWeight{1.0};
+};
+
+/**
+ * @struct ScatterResult
+ * @brief Shading of one hit: the color of the surface itself and the rays
+ * whose colors complete it.
+ *
+ * Materials never trace the rays they spawn; the renderer does, so shading
+ * needs no recursion and a bounded amount of memory. Weights multiply into
+ * the throughput of each ray, which the renderer compares against the
+ * PathTermination rules of the scene to skip rays that barely matter.
+ */
+struct ScatterResult {
+  /** Maximum number of rays a material can spawn per hit. */
+  static constexpr std::size_t MAX_RAYS = 2;
+
+  /**
+   * Color of the surface, before the scattered rays are added. It is not
+   * clamped: the renderer clamps once the whole path is summed.
+   */
+  Radiance radiance{};
+  /** Spawned rays, in the order they should be traced. */
+  std::array<ScatteredRay, MAX_RAYS> rays{};
+  /** Number of valid entries in rays. */
+  std::size_t rayCount{0};
+
+  /**
+   * @brief Add a secondary ray, ignored once MAX_RAYS are stored.
+   * @param ray Ray to trace.
+   * @param weight Factor applied to the color the ray brings back.
+   * @param missColor Color added instead when the ray hits nothing.
+   * @param missWeight Factor applied to missColor.
+   */
+  void addRay(const Ray &ray, double weight,
+              const Color &missColor = Color(),
+              double missWeight = 1.0) noexcept {
+    if (rayCount < MAX_RAYS) {
+      rays[rayCount++] = {ray, weight, missColor, missWeight};
+    }
+  }
+};
 
 /**
  * @class IMaterial
@@ -26,16 +84,19 @@ public:
   virtual ~IMaterial() = default;
 
   /**
-   * @brief Compute the color resulting from lighting at an intersection.
+   * @brief Shade an intersection and list the rays it spawns.
    * @param intersection Intersection information.
    * @param ray Incoming ray.
    * @param lights Lights affecting the intersection.
    * @param scene Scene containing all objects.
-   * @return Computed color.
+   * @param context State of the path, for random decisions.
+   * @return Color of the surface and spawned rays.
    */
-  virtual Color computeColor(const Intersection &intersection, const Ray &ray,
-                             const std::vector<std::shared_ptr<ILight>> &lights,
-                             const Core::Scene &scene) const = 0;
+  virtual ScatterResult scatter(const Intersection &intersection,
+                                const Ray &ray,
+                                const std::vector<const ILight *> &lights,
+                                const Core::Scene &scene,
+                                RenderContext &context) const = 0;
 
   /**
    * @brief Get the diffuse color.
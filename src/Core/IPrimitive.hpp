@@ -9,6 +9,7 @@
 #include <optional>
 
 #include "Core/BoundingBox.hpp"
+#include "Core/HitRecord.hpp"
 #include "Core/Intersection.hpp"
 #include "Core/Ray.hpp"
 #include "Math/Transform.hpp"
@@ -35,6 +36,32 @@ public:
   [[nodiscard]] virtual std::optional<Intersection>
   intersect(const Ray &ray) const noexcept = 0;
 
+  /**
+   * @brief Find the ray parameter of the closest hit, without shading data.
+   * @param ray Ray to test against.
+   * @param hit Closest hit so far; overwritten if this primitive is hit
+   * strictly before @c hit.t.
+   * @return true if @p hit was updated.
+   */
+  [[nodiscard]] virtual bool findHit(const Ray &ray,
+                                     HitRecord &hit) const noexcept = 0;
+
+  /**
+   * @brief Compute the surface data of a hit found by findHit().
+   * @param ray Ray that was passed to findHit().
+   * @param hit Record filled in by this primitive.
+   * @return Intersection data at the hit.
+   */
+  [[nodiscard]] virtual Intersection
+  computeIntersection(const Ray &ray, const HitRecord &hit) const noexcept = 0;
+
+  /**
+   * @brief Check whether a ray hits the primitive, without shading data.
+   * @param ray Ray to test against.
+   * @return true if intersect() would report a hit for the same ray.
+   */
+  [[nodiscard]] virtual bool occluded(const Ray &ray) const noexcept = 0;
+
   /**
    * @brief Get the axis-aligned bounding box of the primitive.
    * @return Bounding box enclosing the primitive.
@@ -7,7 +7,7 @@
 
 #include "Math/Point.hpp"
 #include "Math/Vector.hpp"
-#include <memory>
+#include <type_traits>
 
 namespace Raytracer::Core {
 class IMaterial;
@@ -15,6 +15,10 @@ class IMaterial;
 /**
  * @class Intersection
  * @brief Contains information about a ray-primitive intersection.
+ *
+ * Intersections are copied around freely by every render thread, so they
+ * only refer to the material through a plain pointer. The material is owned
+ * by the hit primitive and lives as long as the scene.
  */
 class Intersection final {
 public:
@@ -27,15 +31,15 @@ public:
    * @brief Construct intersection with specified parameters.
    * @param point Point of intersection in world space.
    * @param normal Surface normal at the intersection point.
-   * @param material Material of the intersected primitive.
+   * @param material Material of the intersected primitive, owned by it.
    * @param distance Distance from ray origin to intersection.
    * @param isInside True if the ray origin was inside the primitive.
    * @param uv Texture coordinates at the intersection.
    */
   Intersection(const Math::Point<3> &point, const Math::Vector<3> &normal,
-               std::shared_ptr<IMaterial> material, double distance,
-               bool isInside, const Math::Point<2> &uv) noexcept
-      : m_point(point), m_normal(normal), m_material(std::move(material)),
+               const IMaterial *material, double distance, bool isInside,
+               const Math::Point<2> &uv) noexcept
+      : m_point(point), m_normal(normal), m_material(material),
         m_distance(distance), m_isInside(isInside), m_uv(uv) {}
 
   /**
@@ -56,9 +60,9 @@ public:
 
   /**
    * @brief Get the material at the intersection.
-   * @return Shared pointer to the material.
+   * @return Pointer to the material, or nullptr if the primitive has none.
    */
-  [[nodiscard]] std::shared_ptr<IMaterial> getMaterial() const noexcept {
+  [[nodiscard]] const IMaterial *getMaterial() const noexcept {
     return m_material;
   }
 
@@ -83,9 +87,13 @@ public:
 private:
   Math::Point<3> m_point{};
   Math::Vector<3> m_normal{};
-  std::shared_ptr<IMaterial> m_material{nullptr};
+  const IMaterial *m_material{nullptr};
   double m_distance{0.0};
   bool m_isInside{false};
   Math::Point<2> m_uv{0.0, 0.0};
 };
+
+static_assert(std::is_trivially_copyable_v<Intersection>,
+              "Intersection is copied per ray and must stay trivially "
+              "copyable.");
 } // namespace Raytracer::Core
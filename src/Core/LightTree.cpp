@@ -0,0 +1,137 @@
+#include "Core/LightTree.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace Raytracer::Core {
+
+void LightTree::build(const std::vector<const ILight *> &lights) {
+  clear();
+
+  std::vector<Entry> entries;
+  for (const ILight *light : lights) {
+    auto positional = dynamic_cast<const IPositionalLight *>(light);
+    if (!positional) {
+      m_otherLights.push_back(light);
+      continue;
+    }
+    const Color &color = light->getColor();
+    const double power = light->getIntensity() *
+                         (color.getR() + color.getG() + color.getB()) /
+                         (3.0 * 255.0);
+    entries.push_back({light, positional, std::max(power, 0.0)});
+  }
+  if (entries.empty()) {
+    return;
+  }
+
+  m_nodes.reserve(2 * entries.size());
+  buildNode(entries, 0, entries.size());
+  m_lights = std::move(entries);
+}
+
+std::uint32_t LightTree::buildNode(std::vector<Entry> &entries,
+                                   std::size_t begin, std::size_t end) {
+  const auto nodeIndex = static_cast<std::uint32_t>(m_nodes.size());
+  m_nodes.emplace_back();
+
+  const Math::Point<3> &first = entries[begin].positional->getPosition();
+  BoundingBox bounds(first, first);
+  double power = 0.0;
+  for (std::size_t i = begin; i < end; ++i) {
+    const Math::Point<3> &position = entries[i].positional->getPosition();
+    bounds = bounds.unite(BoundingBox(position, position));
+    power += entries[i].power;
+  }
+  m_nodes[nodeIndex].bounds = bounds;
+  m_nodes[nodeIndex].power = power;
+
+  if (end - begin == 1) {
+    m_nodes[nodeIndex].offset = static_cast<std::uint32_t>(begin);
+    m_nodes[nodeIndex].leaf = true;
+    return nodeIndex;
+  }
+
+  // Median split along the widest axis keeps the tree balanced, so every
+  // sample costs the same number of steps whatever the light layout.
+  std::size_t axis = 0;
+  const Math::Vector<3> extent = bounds.getMax() - bounds.getMin();
+  for (std::size_t i = 1; i < 3; ++i) {
+    if (extent.m_components[i] > extent.m_components[axis]) {
+      axis = i;
+    }
+  }
+  const std::size_t mid = begin + (end - begin) / 2;
+  std::nth_element(entries.begin() + static_cast<std::ptrdiff_t>(begin),
+                   entries.begin() + static_cast<std::ptrdiff_t>(mid),
+                   entries.begin() + static_cast<std::ptrdiff_t>(end),
+                   [axis](const Entry &a, const Entry &b) {
+                     return a.positional->getPosition().m_components[axis] <
+                            b.positional->getPosition().m_components[axis];
+                   });
+
+  buildNode(entries, begin, mid);
+  m_nodes[nodeIndex].offset = buildNode(entries, mid, end);
+  return nodeIndex;
+}
+
+double LightTree::importance(const Node &node, const Math::Point<3> &point,
+                             const Math::Vector<3> &normal) noexcept {
+  if (node.power <= 0.0) {
+    return 0.0;
+  }
+
+  // Smallest angle between the normal and a direction towards the node's
+  // bounding sphere; leaves have a zero radius, which makes it exact.
+  const Math::Vector<3> toCenter = node.bounds.getCenter() - point;
+  const double distance = toCenter.length();
+  const double radius = (node.bounds.getMax() - node.bounds.getMin()).length() /
+                        2.0;
+  if (distance <= radius) {
+    return node.power;
+  }
+  const double cosine =
+      std::clamp(normal.dot(toCenter) / distance, -1.0, 1.0);
+  const double angle = std::acos(cosine) - std::asin(radius / distance);
+  const double cosineBound = angle <= 0.0 ? 1.0 : std::cos(angle);
+  return cosineBound > 0.0 ? node.power * cosineBound : 0.0;
+}
+
+LightTree::Sample LightTree::sample(const Math::Point<3> &point,
+                                    const Math::Vector<3> &normal,
+                                    double u) const noexcept {
+  if (m_nodes.empty() || importance(m_nodes[0], point, normal) <= 0.0) {
+    return {};
+  }
+
+  std::uint32_t index = 0;
+  double pdf = 1.0;
+  while (!m_nodes[index].leaf) {
+    const std::uint32_t left = index + 1;
+    const std::uint32_t right = m_nodes[index].offset;
+    const double leftImportance = importance(m_nodes[left], point, normal);
+    const double rightImportance = importance(m_nodes[right], point, normal);
+    const double total = leftImportance + rightImportance;
+    if (total <= 0.0) {
+      return {};
+    }
+
+    // The value is rescaled after each choice so one number drives the
+    // whole descent.
+    const double leftProbability = leftImportance / total;
+    if (u < leftProbability) {
+      u /= leftProbability;
+      pdf *= leftProbability;
+      index = left;
+    } else {
+      u = (u - leftProbability) / (1.0 - leftProbability);
+      pdf *= 1.0 - leftProbability;
+      index = right;
+    }
+    u = std::min(u, std::nextafter(1.0, 0.0));
+  }
+
+  const Entry &entry = m_lights[m_nodes[index].offset];
+  return {entry.light, entry.positional, pdf};
+}
+
+} // namespace Raytracer::Core
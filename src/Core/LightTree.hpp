@@ -0,0 +1,150 @@
+/**
+ * @file LightTree.hpp
+ * @brief Defines the hierarchy used to pick point lights by importance.
+ */
+
+#pragma once
+
+#include "Core/BoundingBox.hpp"
+#include "Core/ILight.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace Raytracer::Core {
+
+/**
+ * @class LightTree
+ * @brief Binary hierarchy over the positional lights of a scene.
+ *
+ * Every node stores the bounds and total power of the lights below it.
+ * sample() walks from the root to a single light, choosing each child in
+ * proportion to an upper bound of what its lights can contribute to a
+ * shading point, so the cost of picking a light grows with the depth of
+ * the tree rather than with the number of lights. The bound only accounts
+ * for power and orientation: point lights do not fall off with distance in
+ * this renderer.
+ */
+class LightTree final {
+public:
+  /**
+   * @struct Sample
+   * @brief Light picked by sample(), with the probability of picking it.
+   */
+  struct Sample {
+    /** Picked light, null when no light can reach the point. */
+    const ILight *light{nullptr};
+    /** Same light, seen as a positional light. */
+    const IPositionalLight *positional{nullptr};
+    /** Probability that the light was picked. */
+    double pdf{0.0};
+  };
+
+  /**
+   * @brief Build the tree over the positional lights of a list.
+   * @param lights Lights of the scene; other kinds of light are skipped.
+   */
+  void build(const std::vector<const ILight *> &lights);
+
+  /**
+   * @brief Remove every node and light.
+   */
+  void clear() noexcept {
+    m_nodes.clear();
+    m_lights.clear();
+    m_otherLights.clear();
+  }
+
+  /**
+   * @brief Check whether the tree holds any light.
+   * @return true if there is nothing to sample.
+   */
+  [[nodiscard]] bool empty() const noexcept { return m_nodes.empty(); }
+
+  /**
+   * @brief Get the number of lights in the tree.
+   * @return Number of positional lights.
+   */
+  [[nodiscard]] std::size_t size() const noexcept { return m_lights.size(); }
+
+  /**
+   * @brief Get the lights left out of the tree.
+   *
+   * Ambient and directional lights reach every point alike; they are kept
+   * here so shading can go over them without visiting the whole list.
+   * @return Lights of the list given to build() that are not positional.
+   */
+  [[nodiscard]] const std::vector<const ILight *> &
+  getOtherLights() const noexcept {
+    return m_otherLights;
+  }
+
+  /**
+   * @brief Pick one light for a shading point.
+   *
+   * Lights that cannot light the point, being behind its surface or
+   * without power, are never picked. Node bounds are conservative, so a
+   * descent may end in a subtree where no light reaches the point; no light
+   * is returned then, which only wastes the sample.
+   * @param point Shading point.
+   * @param normal Surface normal at the point.
+   * @param u Uniform value in [0, 1) driving the choice.
+   * @return Picked light and its probability.
+   */
+  [[nodiscard]] Sample sample(const Math::Point<3> &point,
+                              const Math::Vector<3> &normal,
+                              double u) const noexcept;
+
+private:
+  /**
+   * @struct Node
+   * @brief Flattened tree node, stored in depth-first order.
+   *
+   * As in BVH, the left child of an interior node immediately follows it
+   * and @c offset holds the index of the right child. For leaves @c offset
+   * is the index of the light.
+   */
+  struct Node {
+    BoundingBox bounds{};
+    double power{0.0};
+    std::uint32_t offset{0};
+    bool leaf{false};
+  };
+
+  /**
+   * @struct Entry
+   * @brief Light being sorted into the tree.
+   */
+  struct Entry {
+    const ILight *light;
+    const IPositionalLight *positional;
+    double power;
+  };
+
+  /**
+   * @brief Recursively build the subtree covering entries [begin, end).
+   * @param entries Lights to place, reordered in place.
+   * @param begin First entry covered by the node.
+   * @param end One past the last entry covered by the node.
+   * @return Index of the created node.
+   */
+  std::uint32_t buildNode(std::vector<Entry> &entries, std::size_t begin,
+                          std::size_t end);
+
+  /**
+   * @brief Bound what the lights of a node can contribute to a point.
+   * @param node Node to evaluate.
+   * @param point Shading point.
+   * @param normal Surface normal at the point.
+   * @return Node power times a bound of the cosine term, exact for leaves.
+   */
+  [[nodiscard]] static double importance(const Node &node,
+                                         const Math::Point<3> &point,
+                                         const Math::Vector<3> &normal)
+      noexcept;
+
+  std::vector<Node> m_nodes;
+  std::vector<Entry> m_lights;
+  std::vector<const ILight *> m_otherLights;
+};
+
+} // namespace Raytracer::Core
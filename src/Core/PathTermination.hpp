@@ -0,0 +1,64 @@
+/**
+ * @file PathTermination.hpp
+ * @brief Defines the rules for ending paths whose rays no longer matter.
+ */
+
+#pragma once
+
+#include "Core/Sampler.hpp"
+#include <cstddef>
+
+namespace Raytracer::Core {
+
+/**
+ * @struct PathTermination
+ * @brief Per-scene rules deciding which secondary rays are traced.
+ *
+ * Every ray carries a throughput, the product of the weights that scale its
+ * color on the way back to the camera. Rays whose throughput falls under
+ * minContribution are dropped outright. From rouletteDepth on, rays under
+ * rouletteThreshold go through Russian roulette instead: they survive with
+ * a probability proportional to their throughput and survivors are scaled
+ * up by its inverse, so dim rays are skipped without darkening the image
+ * on average. The defaults trace every ray.
+ */
+struct PathTermination {
+  /** Throughput under which a ray is dropped; 0 keeps every ray. */
+  double minContribution{0.0};
+  /** Depth from which Russian roulette applies. */
+  std::size_t rouletteDepth{2};
+  /** Throughput under which roulette applies; 0 disables roulette. */
+  double rouletteThreshold{0.0};
+
+  /**
+   * @brief Check whether any ray can be terminated.
+   * @return true if a cutoff or roulette is configured.
+   */
+  [[nodiscard]] bool isEnabled() const noexcept {
+    return minContribution > 0.0 || rouletteThreshold > 0.0;
+  }
+
+  /**
+   * @brief Decide whether a ray is traced.
+   *
+   * A value is only drawn from the sampler when roulette applies, so paths
+   * that never reach it consume the same dimensions as without roulette.
+   * @param depth Depth of the ray.
+   * @param throughput Largest factor the color of the ray is added with.
+   * @param sampler Sampler of the path.
+   * @return Factor to apply to the ray's throughput, 0 to drop the ray.
+   */
+  [[nodiscard]] double survivalWeight(std::size_t depth, double throughput,
+                                      Sampler &sampler) const noexcept {
+    if (throughput < minContribution) {
+      return 0.0;
+    }
+    if (depth < rouletteDepth || throughput >= rouletteThreshold) {
+      return 1.0;
+    }
+    double survival = throughput / rouletteThreshold;
+    return sampler.next1D() < survival ? 1.0 / survival : 0.0;
+  }
+};
+
+} // namespace Raytracer::Core
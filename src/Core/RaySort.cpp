@@ -0,0 +1,66 @@
+#include "Core/RaySort.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+namespace Raytracer::Core {
+namespace {
+
+/** Log2 of the number of cells per axis secondary rays are sorted on. */
+constexpr unsigned RAY_SORT_CELL_BITS = 5;
+
+/**
+ * @brief Spread the bits of a cell coordinate to every third bit.
+ * @param value Cell coordinate, under 2^RAY_SORT_CELL_BITS.
+ * @return Coordinate ready to be interleaved into a Morton code.
+ */
+std::uint32_t spreadBits(std::uint32_t value) noexcept {
+  std::uint32_t spread = 0;
+  for (unsigned bit = 0; bit < RAY_SORT_CELL_BITS; ++bit) {
+    spread |= (value >> bit & 1u) << (3 * bit);
+  }
+  return spread;
+}
+
+} // namespace
+
+void sortRays(std::span<const Ray> rays, std::vector<std::uint64_t> &order) {
+  std::array<double, 3> low;
+  std::array<double, 3> high;
+  low.fill(std::numeric_limits<double>::infinity());
+  high.fill(-std::numeric_limits<double>::infinity());
+  for (const Ray &ray : rays) {
+    const Math::Point<3> origin = ray.getOrigin();
+    for (std::size_t axis = 0; axis < 3; ++axis) {
+      low[axis] = std::min(low[axis], origin.m_components[axis]);
+      high[axis] = std::max(high[axis], origin.m_components[axis]);
+    }
+  }
+
+  constexpr std::uint32_t lastCell = (1u << RAY_SORT_CELL_BITS) - 1;
+  order.clear();
+  for (std::size_t i = 0; i < rays.size(); ++i) {
+    const Ray &ray = rays[i];
+    std::uint32_t cell = 0;
+    std::uint32_t octant = 0;
+    for (std::size_t axis = 0; axis < 3; ++axis) {
+      const double extent = high[axis] - low[axis];
+      double offset = 0.0;
+      if (extent > 0.0 && std::isfinite(extent)) {
+        offset = (ray.getOrigin().m_components[axis] - low[axis]) / extent;
+      }
+      const auto coordinate = std::min(
+          static_cast<std::uint32_t>(offset * (lastCell + 1)), lastCell);
+      cell |= spreadBits(coordinate) << axis;
+      if (std::signbit(ray.getDirection().m_components[axis])) {
+        octant |= 1u << axis;
+      }
+    }
+    const std::uint64_t key = octant << (3 * RAY_SORT_CELL_BITS) | cell;
+    order.push_back(key << 32 | i);
+  }
+  std::sort(order.begin(), order.end());
+}
+
+} // namespace Raytracer::Core
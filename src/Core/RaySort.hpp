@@ -0,0 +1,26 @@
+/**
+ * @file RaySort.hpp
+ * @brief Declares the ordering the wavefront path traces sorted rays in.
+ */
+
+#pragma once
+
+#include "Core/Ray.hpp"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Raytracer::Core {
+
+/**
+ * @brief Order rays so that neighbours travel alike.
+ *
+ * Rays are grouped by direction octant, then by the cell of their origin
+ * in a grid laid over all of them, cells following a Morton curve. Ties
+ * keep the given order.
+ * @param rays Rays to order.
+ * @param order Filled with sort keys whose low 32 bits are ray indices.
+ */
+void sortRays(std::span<const Ray> rays, std::vector<std::uint64_t> &order);
+
+} // namespace Raytracer::Core
@@ -0,0 +1,29 @@
+/**
+ * @file RenderContext.hpp
+ * @brief Defines the per-path state handed to materials while shading.
+ */
+
+#pragma once
+
+#include "Core/Sampler.hpp"
+
+namespace Raytracer::Core {
+
+class ShadowBatch;
+
+/**
+ * @struct RenderContext
+ * @brief State of the camera path being shaded.
+ *
+ * The renderer creates one context per camera sample and materials pass it
+ * on to every ray they spawn, so all random decisions along the path draw
+ * from the same deterministic sampler instead of shared generators.
+ */
+struct RenderContext {
+  /** Sample values of the path. */
+  Sampler sampler;
+  /** Light terms deferred by the wavefront path, null to shade at once. */
+  ShadowBatch *shadows{nullptr};
+};
+
+} // namespace Raytracer::Core
@@ -0,0 +1,187 @@
+#include "Core/RenderThreadPool.hpp"
+#include <algorithm>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace Raytracer::Core {
+
+RenderThreadPool &RenderThreadPool::getInstance() {
+  // Background jobs hold a worker while they wait on their own run(), so
+  // keep at least two threads even on single-core machines.
+  static RenderThreadPool instance(
+      std::max(2u, std::thread::hardware_concurrency()));
+  return instance;
+}
+
+RenderThreadPool::RenderThreadPool(unsigned int workerCount) {
+#if defined(__linux__)
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  if (sched_getaffinity(0, sizeof(allowed), &allowed) == 0) {
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+      if (CPU_ISSET(cpu, &allowed)) {
+        m_cpus.push_back(cpu);
+      }
+    }
+  }
+#endif
+  m_workers.reserve(workerCount);
+  for (unsigned int i = 0; i < workerCount; ++i) {
+    m_workers.emplace_back(&RenderThreadPool::workerLoop, this);
+  }
+}
+
+RenderThreadPool::~RenderThreadPool() {
+  {
+    std::lock_guard lock(m_mutex);
+    m_stopping = true;
+  }
+  m_workAvailable.notify_all();
+  for (auto &worker : m_workers) {
+    worker.join();
+  }
+}
+
+bool RenderThreadPool::setPinned(bool pinned) {
+  std::lock_guard lock(m_mutex);
+  if (pinned == m_pinned) {
+    return true;
+  }
+#if defined(__linux__)
+  if (m_cpus.empty()) {
+    return false;
+  }
+  bool success = true;
+  for (std::size_t i = 0; i < m_workers.size(); ++i) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (pinned) {
+      CPU_SET(m_cpus[i % m_cpus.size()], &set);
+    } else {
+      for (int cpu : m_cpus) {
+        CPU_SET(cpu, &set);
+      }
+    }
+    success &= pthread_setaffinity_np(m_workers[i].native_handle(),
+                                      sizeof(set), &set) == 0;
+  }
+  m_pinned = pinned && success;
+  return success;
+#else
+  return false;
+#endif
+}
+
+void RenderThreadPool::run(unsigned int count,
+                           const std::function<void(unsigned int)> &task) {
+  if (count == 0) {
+    return;
+  }
+
+  auto batch = std::make_shared<Batch>();
+  batch->task = task;
+  batch->count = count;
+  batch->remaining = count;
+  if (count > 1) {
+    enqueue(batch);
+  }
+
+  while (true) {
+    unsigned int index = 0;
+    {
+      std::lock_guard lock(m_mutex);
+      if (!claim(*batch, index)) {
+        break;
+      }
+    }
+    execute(*batch, index);
+  }
+
+  std::unique_lock lock(batch->mutex);
+  batch->done.wait(lock, [&] { return batch->remaining == 0; });
+  if (batch->error) {
+    std::rethrow_exception(batch->error);
+  }
+}
+
+std::future<void> RenderThreadPool::submit(std::function<void()> job,
+                                           CancellationToken token) {
+  auto packaged = std::make_shared<std::packaged_task<void()>>(
+      [job = std::move(job), token]() {
+        if (!token.isCancelled()) {
+          job();
+        }
+      });
+  std::future<void> future = packaged->get_future();
+
+  auto batch = std::make_shared<Batch>();
+  batch->task = [packaged](unsigned int) { (*packaged)(); };
+  batch->count = 1;
+  batch->remaining = 1;
+  enqueue(batch);
+  return future;
+}
+
+void RenderThreadPool::enqueue(const std::shared_ptr<Batch> &batch) {
+  {
+    std::lock_guard lock(m_mutex);
+    m_queue.push_back(batch);
+  }
+  m_workAvailable.notify_all();
+}
+
+bool RenderThreadPool::claim(Batch &batch, unsigned int &index) {
+  if (batch.next >= batch.count) {
+    return false;
+  }
+  index = batch.next++;
+  if (batch.next == batch.count) {
+    auto it = std::find_if(m_queue.begin(), m_queue.end(),
+                           [&](const auto &queued) {
+                             return queued.get() == &batch;
+                           });
+    if (it != m_queue.end()) {
+      m_queue.erase(it);
+    }
+  }
+  return true;
+}
+
+void RenderThreadPool::execute(Batch &batch, unsigned int index) noexcept {
+  std::exception_ptr error;
+  try {
+    batch.task(index);
+  } catch (...) {
+    error = std::current_exception();
+  }
+  std::lock_guard lock(batch.mutex);
+  if (error && !batch.error) {
+    batch.error = error;
+  }
+  if (--batch.remaining == 0) {
+    batch.done.notify_all();
+  }
+}
+
+void RenderThreadPool::workerLoop() {
+  std::unique_lock lock(m_mutex);
+  while (true) {
+    m_workAvailable.wait(lock,
+                         [&] { return m_stopping || !m_queue.empty(); });
+    if (m_queue.empty()) {
+      return;
+    }
+
+    std::shared_ptr<Batch> batch = m_queue.front();
+    unsigned int index = 0;
+    claim(*batch, index);
+    lock.unlock();
+    execute(*batch, index);
+    lock.lock();
+  }
+}
+
+} // namespace Raytracer::Core
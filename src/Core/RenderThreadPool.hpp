@@ -0,0 +1,197 @@
+/**
+ * @file RenderThreadPool.hpp
+ * @brief Defines the persistent worker pool shared by every render.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Raytracer::Core {
+
+/**
+ * @class CancellationToken
+ * @brief Shared flag telling a render job to stop.
+ *
+ * Copies share the same flag, so a job keeps observing the token it was
+ * started with even after its owner moved on to a new one.
+ */
+class CancellationToken final {
+public:
+  /**
+   * @brief Create a token that is not cancelled.
+   */
+  CancellationToken() : m_flag(std::make_shared<std::atomic<bool>>(false)) {}
+
+  /**
+   * @brief Ask every holder of the token to stop.
+   */
+  void cancel() const noexcept {
+    m_flag->store(true, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Check whether the token was cancelled.
+   * @return true once cancel() has been called on any copy.
+   */
+  [[nodiscard]] bool isCancelled() const noexcept {
+    return m_flag->load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Get the underlying flag, for APIs taking an atomic flag.
+   * @return Flag owned by the token.
+   */
+  [[nodiscard]] std::atomic<bool> *getFlag() const noexcept {
+    return m_flag.get();
+  }
+
+private:
+  std::shared_ptr<std::atomic<bool>> m_flag;
+};
+
+/**
+ * @class RenderThreadPool
+ * @brief Process-wide set of render threads that stay alive between renders.
+ *
+ * Renders split their work with run(), background jobs such as GUI previews
+ * are queued with submit(). Threads are created once, on first use, so
+ * restarting a render only costs queuing a job.
+ */
+class RenderThreadPool final {
+public:
+  /**
+   * @brief Get the pool shared by the whole process.
+   * @return The pool instance.
+   */
+  static RenderThreadPool &getInstance();
+
+  /**
+   * @brief Stop and join every worker once the queued work is done.
+   */
+  ~RenderThreadPool();
+
+  RenderThreadPool(const RenderThreadPool &) = delete;
+  RenderThreadPool &operator=(const RenderThreadPool &) = delete;
+  RenderThreadPool(RenderThreadPool &&) = delete;
+  RenderThreadPool &operator=(RenderThreadPool &&) = delete;
+
+  /**
+   * @brief Get the number of pool threads.
+   * @return Number of workers, not counting threads calling run().
+   */
+  [[nodiscard]] unsigned int getWorkerCount() const noexcept {
+    return static_cast<unsigned int>(m_workers.size());
+  }
+
+  /**
+   * @brief Pin each worker to its own CPU, or let them float again.
+   *
+   * Workers are spread round-robin over the CPUs the process may run on,
+   * so a render started under taskset or a cpuset stays inside it. Threads
+   * calling run() are left alone.
+   * @param pinned true to pin the workers, false to unpin them.
+   * @return false if the platform refused or does not support pinning.
+   */
+  bool setPinned(bool pinned);
+
+  /**
+   * @brief Check whether the workers are pinned.
+   * @return true after a successful setPinned(true).
+   */
+  [[nodiscard]] bool isPinned() const noexcept { return m_pinned; }
+
+  /**
+   * @brief Call a task once for every index and wait for all of them.
+   *
+   * The calling thread runs indices too, so run() may be used from inside
+   * a pool job without waiting on itself. At most getWorkerCount() + 1
+   * indices run at the same time.
+   * If the task throws, the other indices still run and the first
+   * exception is rethrown once every index is done, so no thread is left
+   * holding the task when run() returns.
+   * @param count Number of indices.
+   * @param task Called with each index in [0, count), from any thread.
+   */
+  void run(unsigned int count, const std::function<void(unsigned int)> &task);
+
+  /**
+   * @brief Queue a job to run in the background.
+   * @param job Job to run on a pool thread.
+   * @param token The job is skipped if the token is cancelled before it
+   * starts; the job itself is expected to watch the token while running.
+   * @return Future that becomes ready when the job ends or is skipped.
+   */
+  std::future<void> submit(std::function<void()> job,
+                           CancellationToken token = CancellationToken());
+
+private:
+  /**
+   * @struct Batch
+   * @brief Set of indices handed out to the threads that pick it up.
+   */
+  struct Batch {
+    std::function<void(unsigned int)> task;
+    unsigned int count{0};
+    unsigned int next{0};
+    unsigned int remaining{0};
+    /** First exception thrown by the task, rethrown by run(). */
+    std::exception_ptr error;
+    std::mutex mutex;
+    std::condition_variable done;
+  };
+
+  /**
+   * @brief Start the workers.
+   * @param workerCount Number of threads to start.
+   */
+  explicit RenderThreadPool(unsigned int workerCount);
+
+  /**
+   * @brief Queue a batch and wake the workers.
+   * @param batch Batch to queue.
+   */
+  void enqueue(const std::shared_ptr<Batch> &batch);
+
+  /**
+   * @brief Take the next index of a batch; the pool mutex must be held.
+   * @param batch Batch to take from.
+   * @param index Set to the index taken.
+   * @return false if every index was already taken.
+   */
+  bool claim(Batch &batch, unsigned int &index);
+
+  /**
+   * @brief Run one index of a batch and record its completion.
+   *
+   * An exception thrown by the task is kept in the batch instead of
+   * escaping, so the index is always counted as done.
+   * @param batch Batch the index belongs to.
+   * @param index Index to run.
+   */
+  static void execute(Batch &batch, unsigned int index) noexcept;
+
+  /**
+   * @brief Main loop of a pool thread.
+   */
+  void workerLoop();
+
+  std::mutex m_mutex;
+  std::condition_variable m_workAvailable;
+  std::deque<std::shared_ptr<Batch>> m_queue;
+  bool m_stopping{false};
+  bool m_pinned{false};
+  std::vector<int> m_cpus;
+  std::vector<std::thread> m_workers;
+};
+
+} // namespace Raytracer::Core
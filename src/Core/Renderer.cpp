@@ -1,20 +1,235 @@
 #include "Core/Renderer.hpp"
 #include "Core/IMaterial.hpp"
+#include "Core/RaySort.hpp"
+#include "Core/RenderThreadPool.hpp"
+#include "Core/ShadowBatch.hpp"
 #include "Exceptions/OutputException.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <fstream>
+#include <limits>
 #include <memory>
+#include <new>
+#include <span>
 #include <thread>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace Raytracer::Core {
-void Renderer::renderChunk(const Scene &scene,
-                           std::vector<std::vector<Color>> &pixelBuffer,
-                           size_t startY, size_t endY) const {
-  for (size_t y = startY; y < endY; ++y) {
-    for (size_t x = 0; x < m_width; ++x) {
-      pixelBuffer[y][x] = computePixelColor(scene, x, y);
+namespace {
+static_assert(std::is_trivially_destructible_v<Color>);
+
+/**
+ * @struct PixelStorageDeleter
+ * @brief Releases pixel storage obtained from std::allocator.
+ */
+struct PixelStorageDeleter {
+  std::size_t size{0};
+
+  void operator()(Color *pixels) const noexcept {
+    std::allocator<Color>().deallocate(pixels, size);
+  }
+};
+
+/**
+ * @brief Allocate pixels without constructing them.
+ *
+ * Image-sized blocks are mapped fresh from the OS, so their pages are only
+ * placed in memory once written. Leaving them untouched until a render
+ * thread writes its tile lets first-touch NUMA placement put each part of
+ * the image on the node of the thread that renders it.
+ * @param size Number of pixels.
+ * @return Uninitialized storage for size pixels.
+ */
+std::unique_ptr<Color[], PixelStorageDeleter>
+allocatePixels(std::size_t size) {
+  return {std::allocator<Color>().allocate(size), PixelStorageDeleter{size}};
+}
+
+/**
+ * @brief Write one RGBA8 pixel.
+ * @param out RGBA8 buffer.
+ * @param pixel Index of the pixel.
+ * @param r Red channel (0–255).
+ * @param g Green channel (0–255).
+ * @param b Blue channel (0–255).
+ */
+void storePixel(std::vector<uint8_t> &out, std::size_t pixel, double r,
+                double g, double b) noexcept {
+  std::size_t i = pixel * 4;
+  out[i] = uint8_t(r);
+  out[i + 1] = uint8_t(g);
+  out[i + 2] = uint8_t(b);
+  out[i + 3] = 255;
+}
+
+/**
+ * @brief Advance a row counter by the rows a finished tile completes.
+ * @param pixelsDone Pixels finished so far in the current pass.
+ * @param rowsDone Row counter, may be null.
+ * @param tile Finished tile.
+ * @param width Image width in pixels.
+ */
+void reportTile(std::atomic<size_t> &pixelsDone, std::atomic<size_t> *rowsDone,
+                const Tile &tile, std::size_t width) noexcept {
+  if (!rowsDone)
+    return;
+  size_t pixels = (tile.x1 - tile.x0) * (tile.y1 - tile.y0);
+  size_t before = pixelsDone.fetch_add(pixels, std::memory_order_relaxed);
+  rowsDone->fetch_add((before + pixels) / width - before / width,
+                      std::memory_order_relaxed);
+}
+
+/**
+ * @struct PendingRay
+ * @brief Ray waiting on the integrator stack.
+ */
+struct PendingRay {
+  /** Ray to trace. */
+  Ray ray;
+  /** Product of the weights from the camera to this ray. */
+  double throughput{0.0};
+  /** Color added when the ray hits nothing. */
+  Color missColor{};
+  /** Factor applied to missColor. */
+  double missWeight{0.0};
+};
+static_assert(std::is_trivially_destructible_v<PendingRay>);
+
+/**
+ * @class RayStack
+ * @brief Fixed-capacity stack of pending rays.
+ *
+ * Slots are left uninitialized until pushed, so a path that ends after one
+ * bounce does not pay for constructing the whole stack.
+ * @tparam Capacity Maximum number of pending rays.
+ */
+template <std::size_t Capacity> class RayStack {
+public:
+  [[nodiscard]] bool empty() const noexcept { return m_size == 0; }
+  [[nodiscard]] bool full() const noexcept { return m_size == Capacity; }
+
+  void push(const PendingRay &ray) noexcept {
+    std::construct_at(slot(m_size++), ray);
+  }
+
+  [[nodiscard]] PendingRay pop() noexcept { return *slot(--m_size); }
+
+private:
+  PendingRay *slot(std::size_t index) noexcept {
+    return std::launder(reinterpret_cast<PendingRay *>(m_storage)) + index;
+  }
+
+  alignas(PendingRay) std::byte m_storage[sizeof(PendingRay) * Capacity];
+  std::size_t m_size{0};
+};
+
+/**
+ * @struct WavefrontRay
+ * @brief Ray of a wavefront batch, tagged with the path it belongs to.
+ */
+struct WavefrontRay {
+  PendingRay pending;
+  /** Index of the pixel, within the tile, whose path spawned the ray. */
+  std::uint32_t path{0};
+};
+
+/**
+ * @brief Build the pending ray for a ray spawned by a material.
+ * @param parent Ray whose hit spawned the new one.
+ * @param child Ray returned by the material.
+ * @param termination Rules for ending paths.
+ * @param sampler Sampler of the path, used by Russian roulette.
+ * @param next Filled with the new ray when it is kept.
+ * @return false if the ray was terminated.
+ */
+bool spawnRay(const PendingRay &parent, const ScatteredRay &child,
+              const PathTermination &termination, Sampler &sampler,
+              PendingRay &next) noexcept {
+  next = {child.ray, parent.throughput * child.weight, child.missColor,
+          parent.throughput * child.missWeight};
+  if (!termination.isEnabled()) {
+    return true;
+  }
+  const Color &miss = next.missColor;
+  double contribution = next.throughput;
+  if (miss.getR() + miss.getG() + miss.getB() > 0.0) {
+    contribution = std::max(contribution, next.missWeight);
+  }
+  double survival = termination.survivalWeight(next.ray.getDepth(),
+                                               contribution, sampler);
+  next.throughput *= survival;
+  next.missWeight *= survival;
+  return survival != 0.0;
+}
+
+/**
+ * @brief Add scaled radiance to a sum.
+ * @param sum Red, green and blue sums.
+ * @param radiance Radiance to add.
+ * @param weight Factor applied to the radiance.
+ */
+void addRadiance(Radiance &sum, const Radiance &radiance,
+                 double weight) noexcept {
+  sum[0] += radiance[0] * weight;
+  sum[1] += radiance[1] * weight;
+  sum[2] += radiance[2] * weight;
+}
+
+} // namespace
+
+void Renderer::renderTile(const Scene &scene, Color *pixels,
+                          const Tile &tile) const {
+  SampleCache cache(getSamplingDepth());
+  for (size_t y = tile.y0; y < tile.y1; ++y) {
+    for (size_t x = tile.x0; x < tile.x1; ++x) {
+      std::construct_at(pixels + y * m_width + x,
+                        computePixelColor(scene, cache, x, y));
     }
   }
+  recordSampling(cache);
+}
+
+void Renderer::recordSampling(const SampleCache &cache) const {
+  if (cache.traced == 0)
+    return;
+  m_raysTraced.fetch_add(cache.traced, std::memory_order_relaxed);
+  m_raysSaved.fetch_add(cache.reused, std::memory_order_relaxed);
+}
+
+unsigned int Renderer::getThreadCount() const {
+  if (!m_useMultithreading) {
+    return 1;
+  }
+  unsigned int threadCount = m_threadCount;
+  if (threadCount == 0) {
+    threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+  }
+  // The pool runs at most its workers and the calling thread at once, so
+  // more would only add queues for them to drain.
+  return threadCount == 1 ? 1 : std::min(threadCount, getMaxThreadCount());
+}
+
+unsigned int Renderer::getMaxThreadCount() {
+  return RenderThreadPool::getInstance().getWorkerCount() + 1;
+}
+
+void Renderer::runTiles(const TileScheduler &scheduler,
+                        const std::function<void(const Tile &)> &work,
+                        const std::atomic<bool> *cancelFlag) const {
+  unsigned int threadCount = getThreadCount();
+  if (threadCount > 1) {
+    RenderThreadPool::getInstance().setPinned(m_pinThreads);
+  }
+  m_raysTraced.store(0, std::memory_order_relaxed);
+  m_raysSaved.store(0, std::memory_order_relaxed);
+  m_lastStats = scheduler.run(threadCount, work, cancelFlag);
+  m_lastSampling = {m_raysTraced.load(std::memory_order_relaxed),
+                    m_raysSaved.load(std::memory_order_relaxed)};
 }
 
 void Renderer::render(const Scene &scene, const std::string &filename) const {
@@ -32,33 +247,33 @@ void Renderer::render(const Scene &scene, const std::string &filename) const {
   Camera &camera = const_cast<Camera &>(scene.getCamera());
   camera.setPerspective(aspectRatio);
 
-  std::vector pixelBuffer(m_height, std::vector<Color>(m_width));
-
-  if (m_useMultithreading) {
-    unsigned int threadCount = std::thread::hardware_concurrency();
-    threadCount = (threadCount == 0) ? 1 : threadCount;
-
-    std::vector<std::thread> threads;
-    size_t linesPerThread = m_height / threadCount;
-
-    for (unsigned int i = 0; i < threadCount; ++i) {
-      size_t startY = i * linesPerThread;
-      size_t endY = i == threadCount - 1 ? m_height : (i + 1) * linesPerThread;
-      threads.push_back(std::thread(&Renderer::renderChunk, this,
-                                    std::ref(scene), std::ref(pixelBuffer),
-                                    startY, endY));
-    }
-
-    for (auto &thread : threads) {
-      thread.join();
-    }
+  auto pixels = allocatePixels(m_width * m_height);
+
+  if (m_timeBudget.count() > 0) {
+    renderWithBudget(
+        scene,
+        [&](std::size_t pixel, const Color &color) {
+          std::construct_at(pixels.get() + pixel, color);
+        },
+        nullptr, nullptr, nullptr);
+  } else if (useWavefront()) {
+    TileScheduler scheduler(m_width, m_height, m_tileSize, m_tileOrder);
+    runTiles(scheduler, [&](const Tile &tile) {
+      renderTileWavefront(scene, tile,
+                          [&](std::size_t pixel, const Color &color) {
+                            std::construct_at(pixels.get() + pixel, color);
+                          });
+    });
   } else {
-    renderChunk(scene, pixelBuffer, 0, m_height);
+    TileScheduler scheduler(m_width, m_height, m_tileSize, m_tileOrder);
+    runTiles(scheduler, [&](const Tile &tile) {
+      renderTile(scene, pixels.get(), tile);
+    });
   }
 
   for (size_t y = 0; y < m_height; ++y) {
     for (size_t x = 0; x < m_width; ++x) {
-      Color color = pixelBuffer[y][x];
+      Color color = pixels[y * m_width + x];
       file << static_cast<int>(color.getR()) << " "
            << static_cast<int>(color.getG()) << " "
            << static_cast<int>(color.getB()) << " ";
@@ -68,97 +283,453 @@ void Renderer::render(const Scene &scene, const std::string &filename) const {
 }
 
 [[nodiscard]] Color Renderer::computePixelColor(const Scene &scene,
+                                                SampleCache &cache,
                                                 std::size_t x,
                                                 std::size_t y) const {
+  if (cache.maxDepth >= 0) {
+    return sampleRegion(scene, cache, x * cache.scale, y * cache.scale,
+                        cache.scale, 0);
+  }
+
   const double invWidth = 1.0 / (m_width - 1);
   const double invHeight = 1.0 / (m_height - 1);
 
   using ClampedDouble = Utility::Clamped<double, 0.0, 1.0>;
 
-  ClampedDouble uMin(x * invWidth);
-  ClampedDouble uMax((x + 1) * invWidth);
-  ClampedDouble vMax(1.0 - y * invHeight);
-  ClampedDouble vMin(1.0 - (y + 1) * invHeight);
-
-  if (m_enableAdaptiveSS) {
-    return sampleRegion(scene, uMin.get(), vMin.get(), uMax.get(), vMax.get(),
-                        0);
-  }
-
   ClampedDouble u(x * invWidth);
   ClampedDouble v(1.0 - y * invHeight);
-  return traceRay(scene, scene.getCamera().ray(u, v));
+  RenderContext context{Sampler(y * m_width + x, 0)};
+  return traceRay(scene, scene.getCamera().ray(u, v), context);
+}
+
+[[nodiscard]] Radiance
+Renderer::samplePixel(const Scene &scene, std::size_t x, std::size_t y,
+                      std::size_t pass) const {
+  const double invWidth = 1.0 / (m_width - 1);
+  const double invHeight = 1.0 / (m_height - 1);
+
+  using ClampedDouble = Utility::Clamped<double, 0.0, 1.0>;
+
+  RenderContext context{
+      Sampler(y * m_width + x, static_cast<std::uint32_t>(pass))};
+  auto [dx, dy] = context.sampler.next2D();
+  ClampedDouble u((x + dx) * invWidth);
+  ClampedDouble v(1.0 - (y + dy) * invHeight);
+  return traceRadiance(scene, scene.getCamera().ray(u, v), context);
+}
+
+[[nodiscard]] Color Renderer::traceRay(const Scene &scene, const Ray &ray,
+                                       RenderContext &context) const {
+  auto [red, green, blue] = traceRadiance(scene, ray, context);
+  return Color(red, green, blue);
 }
 
-[[nodiscard]] Color Renderer::traceRay(const Scene &scene,
-                                       const Ray &ray) const {
-  std::optional<Intersection> nearestHit = scene.findNearestIntersection(ray);
-  if (!nearestHit) {
-    return Color(0, 0, 0);
+[[nodiscard]] Radiance
+Renderer::traceRadiance(const Scene &scene, const Ray &ray,
+                        RenderContext &context) const {
+  std::vector<const ILight *> collected;
+  if (!scene.isCompiled()) {
+    collectLights(scene, collected);
+  }
+  const std::vector<const ILight *> &lights =
+      scene.isCompiled() ? scene.getLightList() : collected;
+
+  // Rays are traced depth-first from a fixed-size stack. Children are
+  // pushed in reverse so they are shaded in the order the material listed
+  // them, and channels are summed unclamped until the path is done.
+  const PathTermination &termination = scene.getPathTermination();
+  RayStack<MAX_PENDING_RAYS> stack;
+  stack.push({ray, 1.0, Color(), 0.0});
+  Radiance sum{};
+
+  while (!stack.empty()) {
+    const PendingRay current = stack.pop();
+    std::optional<Intersection> hit =
+        scene.findNearestIntersection(current.ray);
+    if (!hit) {
+      addRadiance(sum, current.missColor.toRadiance(), current.missWeight);
+      continue;
+    }
+    const IMaterial *material = hit->getMaterial();
+    if (!material) {
+      continue;
+    }
+    ScatterResult result =
+        material->scatter(*hit, current.ray, lights, scene, context);
+    addRadiance(sum, result.radiance, current.throughput);
+
+    // Rays that do not fit are dropped; with the depth limits of the
+    // materials the stack never holds more than a few entries.
+    for (std::size_t i = result.rayCount; i-- > 0;) {
+      if (stack.full()) {
+        break;
+      }
+      PendingRay next;
+      if (spawnRay(current, result.rays[i], termination, context.sampler,
+                   next)) {
+        stack.push(next);
+      }
+    }
   }
 
-  std::shared_ptr<IMaterial> material = nearestHit->getMaterial();
-  if (!material) {
-    return Color(0, 0, 0);
+  return sum;
+}
+
+bool Renderer::renderTileWavefront(
+    const Scene &scene, const Tile &tile,
+    const std::function<void(std::size_t, const Color &)> &store,
+    const std::atomic<bool> *cancelFlag) const {
+  std::vector<const ILight *> collected;
+  if (!scene.isCompiled()) {
+    collectLights(scene, collected);
   }
+  const std::vector<const ILight *> &lights =
+      scene.isCompiled() ? scene.getLightList() : collected;
+  const PathTermination &termination = scene.getPathTermination();
+
+  const std::size_t tileWidth = tile.x1 - tile.x0;
+  const std::size_t pathCount = tileWidth * (tile.y1 - tile.y0);
+  std::vector<RenderContext> contexts;
+  std::vector<Radiance> sums(pathCount, Radiance{});
+  std::vector<WavefrontRay> batch;
+  contexts.reserve(pathCount);
+  batch.reserve(pathCount);
+
+  // Camera rays of the whole tile form the first batch.
+  const double invWidth = 1.0 / (m_width - 1);
+  const double invHeight = 1.0 / (m_height - 1);
+  using ClampedDouble = Utility::Clamped<double, 0.0, 1.0>;
+  for (size_t y = tile.y0; y < tile.y1; ++y) {
+    for (size_t x = tile.x0; x < tile.x1; ++x) {
+      ClampedDouble u(x * invWidth);
+      ClampedDouble v(1.0 - y * invHeight);
+      auto path = static_cast<std::uint32_t>(contexts.size());
+      contexts.push_back({Sampler(y * m_width + x, 0)});
+      batch.push_back(
+          {{scene.getCamera().ray(u, v), 1.0, Color(), 0.0}, path});
+    }
+  }
+
+  // Buckets are numbered in order of first appearance, so shading order,
+  // and with it the sampler dimensions, never depends on addresses.
+  std::unordered_map<const IMaterial *, std::uint32_t> buckets;
+  std::vector<std::optional<Intersection>> hits;
+  std::vector<std::uint64_t> order;
+  std::vector<ScatterResult> results;
+  std::vector<WavefrontRay> next;
+  std::vector<Ray> traceRays;
+  std::vector<std::uint64_t> traceOrder;
+  std::array<std::optional<Intersection>, Scene::PACKET_SIZE> packetHits;
+  ShadowBatch shadows;
+  std::vector<std::size_t> firstTerms;
+  std::vector<std::size_t> lastTerms;
+  bool primary = true;
+
+  while (!batch.empty()) {
+    if (cancelFlag && cancelFlag->load(std::memory_order_relaxed)) {
+      return false;
+    }
+    // Rays are traced as packets of neighbours in tracing order. Camera
+    // rays come in row order, so each packet covers a run of adjacent
+    // pixels; secondary rays may be sorted first to regroup them. Only
+    // tracing is reordered: shading still follows the batch order.
+    const bool sorted = m_sortRays && !primary;
+    if (sorted) {
+      traceRays.clear();
+      for (const WavefrontRay &ray : batch) {
+        traceRays.push_back(ray.pending.ray);
+      }
+      sortRays(traceRays, traceOrder);
+    }
+    hits.resize(batch.size());
+    for (std::size_t first = 0; first < batch.size();
+         first += Scene::PACKET_SIZE) {
+      const std::size_t count =
+          std::min(Scene::PACKET_SIZE, batch.size() - first);
+      std::array<std::size_t, Scene::PACKET_SIZE> indices;
+      std::array<Ray, Scene::PACKET_SIZE> packet;
+      for (std::size_t lane = 0; lane < count; ++lane) {
+        indices[lane] =
+            sorted ? traceOrder[first + lane] & 0xFFFFFFFFu : first + lane;
+        packet[lane] = batch[indices[lane]].pending.ray;
+      }
+      scene.findNearestIntersections(
+          std::span<const Ray>(packet.data(), count), packetHits);
+      for (std::size_t lane = 0; lane < count; ++lane) {
+        hits[indices[lane]] = std::move(packetHits[lane]);
+      }
+    }
+    primary = false;
+
+    order.clear();
+    for (std::size_t i = 0; i < batch.size(); ++i) {
+      if (hits[i] && hits[i]->getMaterial()) {
+        auto bucket = buckets.try_emplace(
+            hits[i]->getMaterial(),
+            static_cast<std::uint32_t>(buckets.size())).first->second;
+        order.push_back(static_cast<std::uint64_t>(bucket) << 32 | i);
+      }
+    }
+    std::sort(order.begin(), order.end());
+
+    // Materials that cast shadow rays hand their light terms to the batch,
+    // which traces the rays as packets once every hit is shaded.
+    results.assign(batch.size(), ScatterResult{});
+    shadows.clear();
+    firstTerms.assign(batch.size(), 0);
+    lastTerms.assign(batch.size(), 0);
+    for (std::uint64_t key : order) {
+      std::size_t i = key & 0xFFFFFFFFu;
+      const WavefrontRay &ray = batch[i];
+      RenderContext &context = contexts[ray.path];
+      firstTerms[i] = shadows.size();
+      context.shadows = &shadows;
+      results[i] = hits[i]->getMaterial()->scatter(
+          *hits[i], ray.pending.ray, lights, scene, context);
+      context.shadows = nullptr;
+      lastTerms[i] = shadows.size();
+    }
+    if (shadows.size() > 0) {
+      shadows.trace(scene);
+      for (std::size_t i = 0; i < batch.size(); ++i) {
+        if (lastTerms[i] > firstTerms[i]) {
+          shadows.resolve(results[i].radiance, firstTerms[i], lastTerms[i]);
+        }
+      }
+    }
 
-  std::vector<std::shared_ptr<ILight>> lights;
-  collectLights(scene, lights);
+    // Sums and new rays follow the batch order, whatever the buckets were.
+    next.clear();
+    for (std::size_t i = 0; i < batch.size(); ++i) {
+      const WavefrontRay &ray = batch[i];
+      if (!hits[i]) {
+        addRadiance(sums[ray.path], ray.pending.missColor.toRadiance(),
+                    ray.pending.missWeight);
+        continue;
+      }
+      if (!hits[i]->getMaterial()) {
+        continue;
+      }
+      const ScatterResult &result = results[i];
+      addRadiance(sums[ray.path], result.radiance, ray.pending.throughput);
+      for (std::size_t c = 0; c < result.rayCount; ++c) {
+        WavefrontRay child{{}, ray.path};
+        if (spawnRay(ray.pending, result.rays[c], termination,
+                     contexts[ray.path].sampler, child.pending)) {
+          next.push_back(child);
+        }
+      }
+    }
+    batch.swap(next);
+  }
 
-  return material->computeColor(*nearestHit, ray, lights, scene);
+  for (std::size_t path = 0; path < pathCount; ++path) {
+    std::size_t x = tile.x0 + path % tileWidth;
+    std::size_t y = tile.y0 + path / tileWidth;
+    const Radiance &sum = sums[path];
+    store(y * m_width + x, Color(sum[0], sum[1], sum[2]));
+  }
+  return true;
 }
 
 void Renderer::renderToBuffer(const Scene &scene, std::vector<uint8_t> &out,
                               std::atomic<bool> *cancelFlag,
-                              std::atomic<size_t> *rowsDone) const {
+                              std::atomic<size_t> *rowsDone,
+                              std::atomic<size_t> *passesDone) const {
   if (out.size() < m_width * m_height * 4)
     throw std::runtime_error("renderToBuffer: output buffer too small");
 
+  if (m_timeBudget.count() > 0) {
+    renderWithBudget(
+        scene,
+        [&](std::size_t pixel, const Color &color) {
+          storePixel(out, pixel, color.getR(), color.getG(), color.getB());
+        },
+        cancelFlag, rowsDone, passesDone);
+    return;
+  }
+
+  if (m_progressive) {
+    renderProgressive(scene, out, cancelFlag, rowsDone, passesDone);
+    return;
+  }
+
   if (rowsDone)
     rowsDone->store(0, std::memory_order_relaxed);
 
-  auto worker = [&](size_t y0, size_t y1) {
-    for (size_t y = y0; y < y1; ++y) {
-      if (cancelFlag && cancelFlag->load(std::memory_order_relaxed))
-        return;
-      for (size_t x = 0; x < m_width; ++x) {
-        if (cancelFlag && cancelFlag->load(std::memory_order_relaxed))
+  std::atomic<size_t> pixelsDone{0};
+  auto storeColor = [&](std::size_t pixel, const Color &color) {
+    storePixel(out, pixel, color.getR(), color.getG(), color.getB());
+  };
+  auto work = [&](const Tile &tile) {
+    if (useWavefront()) {
+      if (renderTileWavefront(scene, tile, storeColor, cancelFlag)) {
+        reportTile(pixelsDone, rowsDone, tile, m_width);
+      }
+      return;
+    }
+    SampleCache cache(getSamplingDepth());
+    for (size_t y = tile.y0; y < tile.y1; ++y) {
+      for (size_t x = tile.x0; x < tile.x1; ++x) {
+        if (cancelFlag && cancelFlag->load(std::memory_order_relaxed)) {
+          recordSampling(cache);
           return;
-        Color color = computePixelColor(scene, x, y);
-        size_t i = (y * m_width + x) * 4;
-        out[i] = uint8_t(color.getR());
-        out[i + 1] = uint8_t(color.getG());
-        out[i + 2] = uint8_t(color.getB());
-        out[i + 3] = 255;
+        }
+        storeColor(y * m_width + x, computePixelColor(scene, cache, x, y));
       }
-      if (rowsDone)
-        rowsDone->fetch_add(1, std::memory_order_relaxed);
     }
+    recordSampling(cache);
+    reportTile(pixelsDone, rowsDone, tile, m_width);
+  };
+
+  TileScheduler scheduler(m_width, m_height, m_tileSize, m_tileOrder);
+  runTiles(scheduler, work, cancelFlag);
+  if (passesDone && !(cancelFlag && cancelFlag->load()))
+    passesDone->fetch_add(1, std::memory_order_relaxed);
+}
+
+void Renderer::renderProgressive(const Scene &scene,
+                                 std::vector<uint8_t> &out,
+                                 std::atomic<bool> *cancelFlag,
+                                 std::atomic<size_t> *rowsDone,
+                                 std::atomic<size_t> *passesDone) const {
+  auto cancelled = [cancelFlag]() {
+    return cancelFlag && cancelFlag->load(std::memory_order_relaxed);
   };
 
-  if (m_useMultithreading) {
-    unsigned threads = std::thread::hardware_concurrency();
-    threads = threads ? threads : 1;
-    size_t stripe = m_height / threads;
-    std::vector<std::thread> threadPool;
-    threadPool.reserve(threads);
+  std::vector<double> sums(m_width * m_height * 3, 0.0);
+  TileScheduler scheduler(m_width, m_height, m_tileSize, m_tileOrder);
+
+  for (size_t pass = 0; m_maxPasses == 0 || pass < m_maxPasses; ++pass) {
+    if (cancelled())
+      return;
+    if (rowsDone)
+      rowsDone->store(0, std::memory_order_relaxed);
+
+    const double weight = 1.0 / static_cast<double>(pass + 1);
+    std::atomic<size_t> pixelsDone{0};
+    auto work = [&](const Tile &tile) {
+      for (size_t y = tile.y0; y < tile.y1; ++y) {
+        for (size_t x = tile.x0; x < tile.x1; ++x) {
+          if (cancelled())
+            return;
+          Radiance sample = samplePixel(scene, x, y, pass);
+          size_t pixel = y * m_width + x;
+          double *sum = &sums[pixel * 3];
+          sum[0] += sample[0];
+          sum[1] += sample[1];
+          sum[2] += sample[2];
+          storePixel(out, pixel, std::min(sum[0] * weight, 255.0),
+                     std::min(sum[1] * weight, 255.0),
+                     std::min(sum[2] * weight, 255.0));
+        }
+      }
+      reportTile(pixelsDone, rowsDone, tile, m_width);
+    };
+
+    runTiles(scheduler, work, cancelFlag);
+    if (cancelled())
+      return;
+    if (passesDone)
+      passesDone->fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void Renderer::renderWithBudget(
+    const Scene &scene,
+    const std::function<void(std::size_t, const Color &)> &store,
+    std::atomic<bool> *cancelFlag, std::atomic<size_t> *rowsDone,
+    std::atomic<size_t> *passesDone) const {
+  using Clock = std::chrono::steady_clock;
+  const Clock::time_point deadline = Clock::now() + m_timeBudget;
+
+  auto cancelled = [cancelFlag]() {
+    return cancelFlag && cancelFlag->load(std::memory_order_relaxed);
+  };
 
-    for (unsigned i = 0; i < threads; ++i) {
-      size_t y0 = i * stripe;
-      size_t y1 = (i + 1 == threads) ? m_height : (i + 1) * stripe;
-      threadPool.emplace_back(worker, y0, y1);
+  TileScheduler scheduler(m_width, m_height, m_tileSize, m_tileOrder);
+  m_lastPassCount = 0;
+
+  auto finishPass = [&]() {
+    ++m_lastPassCount;
+    if (passesDone)
+      passesDone->fetch_add(1, std::memory_order_relaxed);
+  };
+
+  // Coarse pass: one ray per block, ignoring the deadline so that the frame
+  // is always complete.
+  if (rowsDone)
+    rowsDone->store(0, std::memory_order_relaxed);
+  std::atomic<size_t> pixelsDone{0};
+  auto coarse = [&](const Tile &tile) {
+    for (size_t by = tile.y0; by < tile.y1; by += BUDGET_COARSE_BLOCK) {
+      for (size_t bx = tile.x0; bx < tile.x1; bx += BUDGET_COARSE_BLOCK) {
+        if (cancelled())
+          return;
+        SampleCache cache(-1);
+        Color color = computePixelColor(scene, cache, bx, by);
+        size_t yEnd = std::min(by + BUDGET_COARSE_BLOCK, tile.y1);
+        size_t xEnd = std::min(bx + BUDGET_COARSE_BLOCK, tile.x1);
+        for (size_t y = by; y < yEnd; ++y) {
+          for (size_t x = bx; x < xEnd; ++x) {
+            store(y * m_width + x, color);
+          }
+        }
+      }
     }
-    for (auto &thread : threadPool)
-      thread.join();
-  } else {
-    worker(0, m_height);
+    reportTile(pixelsDone, rowsDone, tile, m_width);
+  };
+  runTiles(scheduler, coarse, cancelFlag);
+  if (cancelled())
+    return;
+  finishPass();
+
+  // Refinement passes: one ray per pixel, then supersampling of increasing
+  // depth. A pass interrupted by the deadline leaves the pixels it did not
+  // reach at the previous pass's quality.
+  std::atomic<bool> stop{false};
+  auto expired = [&]() {
+    if (stop.load(std::memory_order_relaxed))
+      return true;
+    if (cancelled() || Clock::now() >= deadline) {
+      stop.store(true, std::memory_order_relaxed);
+      return true;
+    }
+    return false;
+  };
+
+  for (int depth = -1; depth <= BUDGET_MAX_AA_DEPTH; ++depth) {
+    if (expired())
+      return;
+    if (rowsDone)
+      rowsDone->store(0, std::memory_order_relaxed);
+    pixelsDone.store(0, std::memory_order_relaxed);
+
+    auto refine = [&](const Tile &tile) {
+      SampleCache cache(depth);
+      for (size_t y = tile.y0; y < tile.y1; ++y) {
+        for (size_t x = tile.x0; x < tile.x1; ++x) {
+          if (expired()) {
+            recordSampling(cache);
+            return;
+          }
+          store(y * m_width + x, computePixelColor(scene, cache, x, y));
+        }
+      }
+      recordSampling(cache);
+      reportTile(pixelsDone, rowsDone, tile, m_width);
+    };
+    runTiles(scheduler, refine, &stop);
+    if (stop.load(std::memory_order_relaxed))
+      return;
+    finishPass();
   }
 }
 
 void Renderer::collectLights(
-    const Scene &scene, std::vector<std::shared_ptr<ILight>> &lights) const {
+    const Scene &scene, std::vector<const ILight *> &lights) const {
   for (const auto &[id, light] : scene.getLights()) {
-    lights.push_back(std::shared_ptr<ILight>(light.get(), [](ILight *) {}));
+    lights.push_back(light.get());
   }
 
   for (const auto &[id, childScene] : scene.getChildScenes()) {
@@ -166,25 +737,53 @@ void Renderer::collectLights(
   }
 }
 
-[[nodiscard]] Color Renderer::sampleRegion(const Scene &scene, double uMin,
-                                           double vMin, double uMax,
-                                           double vMax, int depth) const {
-  double uMid = 0.5 * (uMin + uMax);
-  double vMid = 0.5 * (vMin + vMax);
+bool Renderer::useWavefront() const noexcept {
+  return m_wavefront && getSamplingDepth() < 0;
+}
 
-  std::array<std::pair<double, double>, 5> points = {
-      std::make_pair(uMin, vMin), std::make_pair(uMin, vMax),
-      std::make_pair(uMax, vMin), std::make_pair(uMax, vMax),
-      std::make_pair(uMid, vMid)};
+int Renderer::getSamplingDepth() const noexcept {
+  return m_enableAdaptiveSS ? std::max(m_AAMaxDepth, 0) : -1;
+}
 
-  std::array<Color, 5> cols;
-  for (int i = 0; i < 5; ++i) {
-    auto [u, v] = points[i];
-    cols[i] = traceRay(
-        scene, scene.getCamera().ray(Utility::Clamped<double, 0.0, 1.0>(u),
-                                     Utility::Clamped<double, 0.0, 1.0>(v)));
+[[nodiscard]] Color Renderer::sampleLattice(const Scene &scene,
+                                            SampleCache &cache, std::size_t x,
+                                            std::size_t y) const {
+  std::uint64_t key = (static_cast<std::uint64_t>(x) << 32) | y;
+  auto [it, inserted] = cache.colors.try_emplace(key);
+  if (!inserted) {
+    ++cache.reused;
+    return it->second;
   }
 
+  const double scale = static_cast<double>(cache.scale);
+  const double invWidth = 1.0 / (m_width - 1);
+  const double invHeight = 1.0 / (m_height - 1);
+  double u = (static_cast<double>(x) / scale) * invWidth;
+  double v = 1.0 - (static_cast<double>(y) / scale) * invHeight;
+
+  ++cache.traced;
+  RenderContext context{Sampler(key, 0)};
+  it->second = traceRay(
+      scene,
+      scene.getCamera().ray(Utility::Clamped<double, 0.0, 1.0>(u),
+                            Utility::Clamped<double, 0.0, 1.0>(v)),
+      context);
+  return it->second;
+}
+
+[[nodiscard]] Color Renderer::sampleRegion(const Scene &scene,
+                                           SampleCache &cache, std::size_t x0,
+                                           std::size_t y0, std::size_t size,
+                                           int depth) const {
+  std::size_t half = size / 2;
+  std::size_t x1 = x0 + size;
+  std::size_t y1 = y0 + size;
+
+  std::array<Color, 5> cols = {
+      sampleLattice(scene, cache, x0, y1), sampleLattice(scene, cache, x0, y0),
+      sampleLattice(scene, cache, x1, y1), sampleLattice(scene, cache, x1, y0),
+      sampleLattice(scene, cache, x0 + half, y0 + half)};
+
   double maxDiff = 0.0;
   for (int i = 0; i < 5; ++i) {
     for (int j = i + 1; j < 5; ++j) {
@@ -196,11 +795,12 @@ void Renderer::collectLights(
     }
   }
 
-  if (depth < m_AAMaxDepth && maxDiff > m_AAThreshold) {
-    Color color1 = sampleRegion(scene, uMin, vMid, uMid, vMax, depth + 1);
-    Color color2 = sampleRegion(scene, uMid, vMid, uMax, vMax, depth + 1);
-    Color color3 = sampleRegion(scene, uMin, vMin, uMid, vMid, depth + 1);
-    Color color4 = sampleRegion(scene, uMid, vMin, uMax, vMid, depth + 1);
+  if (depth < cache.maxDepth && maxDiff > m_AAThreshold) {
+    Color color1 = sampleRegion(scene, cache, x0, y0, half, depth + 1);
+    Color color2 = sampleRegion(scene, cache, x0 + half, y0, half, depth + 1);
+    Color color3 = sampleRegion(scene, cache, x0, y0 + half, half, depth + 1);
+    Color color4 =
+        sampleRegion(scene, cache, x0 + half, y0 + half, half, depth + 1);
     double r =
         (color1.getR() + color2.getR() + color3.getR() + color4.getR()) * 0.25;
     double g =
@@ -6,11 +6,30 @@
 #pragma once
 
 #include "Core/Color.hpp"
+#include "Core/RenderContext.hpp"
 #include "Core/Scene.hpp"
+#include "Core/TileScheduler.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
 #include <vector>
 
 namespace Raytracer::Core {
+/**
+ * @struct SamplingStats
+ * @brief Primary rays of the last render with adaptive supersampling.
+ */
+struct SamplingStats {
+  /** Number of primary rays traced. */
+  std::size_t raysTraced{0};
+  /** Number of samples taken from the corner cache instead of traced. */
+  std::size_t raysSaved{0};
+};
+
 /**
  * @class Renderer
  * @brief Handles rendering of scenes to PPM image files.
@@ -60,12 +79,17 @@ public:
    *        and reporting progress via atomic flags.
    * @param scene       The scene.
    * @param out         Pre‐allocated RGBA8 buffer of size width*height*4.
-   * @param cancelFlag  If non‐null, checked each row; if true, abort early.
-   * @param rowsDone    If non‐null, incremented each time a row completes.
+   * @param cancelFlag  If non‐null, checked each pixel; if true, abort early.
+   * @param rowsDone    If non‐null, advanced by one each time a row's worth
+   *                    of pixels completes; tiles finish out of row order.
+   *                    Reset at the start of every progressive pass.
+   * @param passesDone  If non‐null, advanced by one after each completed
+   *                    progressive pass.
    */
   void renderToBuffer(const Scene &scene, std::vector<uint8_t> &out,
                       std::atomic<bool> *cancelFlag = nullptr,
-                      std::atomic<size_t> *rowsDone = nullptr) const;
+                      std::atomic<size_t> *rowsDone = nullptr,
+                      std::atomic<size_t> *passesDone = nullptr) const;
   /**
    * @brief Enable or disable multithreaded rendering.
    * @param enable True to enable multithreading, false to disable.
@@ -80,6 +104,82 @@ public:
     return m_useMultithreading;
   }
 
+  /**
+   * @brief Set the number of render threads.
+   * @param count Number of threads, 0 to use every hardware thread. Counts
+   * above getMaxThreadCount() are lowered to it.
+   */
+  void setThreadCount(unsigned int count) { m_threadCount = count; }
+
+  /**
+   * @brief Get the number of threads a render will use.
+   * @return 1 when multithreading is disabled, otherwise the count set with
+   * setThreadCount(), or the hardware concurrency if it is 0, at most
+   * getMaxThreadCount().
+   */
+  [[nodiscard]] unsigned int getThreadCount() const;
+
+  /**
+   * @brief Get the number of threads a render can run at once.
+   * @return Workers of the shared render pool plus the calling thread.
+   */
+  [[nodiscard]] static unsigned int getMaxThreadCount();
+
+  /**
+   * @brief Pin render threads to their own CPUs during renders.
+   * @param enable True to pin threads, false to let the OS place them.
+   */
+  void setThreadPinning(bool enable) { m_pinThreads = enable; }
+
+  /**
+   * @brief Check if render threads are pinned.
+   * @return True if pinning is enabled, false otherwise.
+   */
+  [[nodiscard]] bool isThreadPinningEnabled() const noexcept {
+    return m_pinThreads;
+  }
+
+  /**
+   * @brief Set the side of the square tiles handed to render threads.
+   * @param size Tile side in pixels.
+   */
+  void setTileSize(std::size_t size) { m_tileSize = size; }
+
+  /**
+   * @brief Get the tile side.
+   * @return Tile side in pixels.
+   */
+  [[nodiscard]] std::size_t getTileSize() const noexcept { return m_tileSize; }
+
+  /**
+   * @brief Set the order in which tiles are rendered.
+   * @param order Tile order.
+   */
+  void setTileOrder(TileOrder order) { m_tileOrder = order; }
+
+  /**
+   * @brief Get the order in which tiles are rendered.
+   * @return Tile order.
+   */
+  [[nodiscard]] TileOrder getTileOrder() const noexcept { return m_tileOrder; }
+
+  /**
+   * @brief Get the per-thread statistics of the last render.
+   * @return One entry per render thread, empty before the first render.
+   */
+  [[nodiscard]] const std::vector<WorkerStats> &
+  getLastRenderStats() const noexcept {
+    return m_lastStats;
+  }
+
+  /**
+   * @brief Get the adaptive supersampling statistics of the last render.
+   * @return Rays traced and saved, zero when supersampling was off.
+   */
+  [[nodiscard]] const SamplingStats &getLastSamplingStats() const noexcept {
+    return m_lastSampling;
+  }
+
   /**
    * @brief Enable/disable adaptive supersampling for anti-aliasing.
    * @param enable Turn on/off
@@ -100,66 +200,315 @@ public:
     return m_enableAdaptiveSS;
   }
 
+  /**
+   * @brief Enable/disable progressive rendering in renderToBuffer().
+   *
+   * Each pass adds one stratified sample per pixel to an accumulation
+   * buffer and publishes the running average, so a full frame is visible
+   * after the first pass and refines with every pass. Adaptive
+   * supersampling is not used in this mode.
+   * @param enable Turn on/off
+   * @param maxPasses Number of passes, 0 to keep going until cancelled.
+   */
+  void setProgressive(bool enable, std::size_t maxPasses = 0) {
+    m_progressive = enable;
+    m_maxPasses = maxPasses;
+  }
+
+  /**
+   * @brief Render within a time budget.
+   *
+   * render() and renderToBuffer() first fill the whole frame with a coarse
+   * pass, one ray per 4x4 block, then refine it with a full resolution
+   * pass and adaptive supersampling of increasing depth until the budget
+   * runs out. Pixels keep the best quality they reached, so the frame is
+   * always complete; only the coarse pass may overrun the budget. Takes
+   * precedence over progressive rendering.
+   * @param budget Time allowed for a render, 0 to render without a limit.
+   */
+  void setTimeBudget(std::chrono::milliseconds budget) {
+    m_timeBudget = budget;
+  }
+
+  /**
+   * @brief Get the time budget.
+   * @return Time allowed for a render, 0 when unlimited.
+   */
+  [[nodiscard]] std::chrono::milliseconds getTimeBudget() const noexcept {
+    return m_timeBudget;
+  }
+
+  /**
+   * @brief Get the number of passes completed by the last budgeted render.
+   * @return Completed passes, the coarse pass included.
+   */
+  [[nodiscard]] std::size_t getLastPassCount() const noexcept {
+    return m_lastPassCount;
+  }
+
+  /**
+   * @brief Enable/disable the wavefront render path.
+   *
+   * Instead of following each camera path to its end before starting the
+   * next, every tile is rendered breadth-first: all its camera rays are
+   * intersected, the hits are grouped by material and shaded bucket by
+   * bucket, and the rays they spawn form the next batch, until no ray is
+   * left. Applies to render() and renderToBuffer() when neither adaptive
+   * supersampling, progressive rendering nor a time budget is used; larger
+   * tiles give larger batches.
+   * Each camera path draws from a single sampler, in shading order. The
+   * image therefore matches the depth-first path as long as no material
+   * draws sampler values on a path that has branched into several rays;
+   * past such a branch both paths consume dimensions in another order.
+   * @param enable Turn on/off
+   */
+  void setWavefront(bool enable) { m_wavefront = enable; }
+
+  /**
+   * @brief Check if the wavefront render path is enabled.
+   * @return True if enabled, false otherwise.
+   */
+  [[nodiscard]] bool isWavefront() const noexcept { return m_wavefront; }
+
+  /**
+   * @brief Enable/disable sorting secondary rays in the wavefront path.
+   *
+   * Before each batch of secondary rays is traced, rays are regrouped by
+   * direction octant and by origin, so consecutive rays, and the packets
+   * they are traced in, walk the same parts of the scene. The image is
+   * unchanged; only the order rays are traced in differs.
+   * @param enable Turn on/off
+   */
+  void setRaySorting(bool enable) { m_sortRays = enable; }
+
+  /**
+   * @brief Check if secondary rays are sorted in the wavefront path.
+   * @return True if enabled, false otherwise.
+   */
+  [[nodiscard]] bool isRaySorting() const noexcept { return m_sortRays; }
+
+  /**
+   * @brief Check if progressive rendering is enabled.
+   * @return True if enabled, false otherwise.
+   */
+  [[nodiscard]] bool isProgressive() const noexcept { return m_progressive; }
+
 private:
   /**
-   * @brief Render a chunk of the scene.
+   * @struct SampleCache
+   * @brief Colors already traced on the supersampling lattice of a tile.
+   *
+   * Every sample point of sampleRegion() lies on a lattice with
+   * 2^(maxDepth + 1) steps per pixel, so neighbouring pixels and nested
+   * sub-squares share their corners through this cache.
+   */
+  struct SampleCache {
+    /**
+     * @brief Create an empty cache.
+     * @param depth Supersampling depth, negative for one ray per pixel.
+     */
+    explicit SampleCache(int depth)
+        : maxDepth(depth), scale(depth < 0 ? 1 : std::size_t(2) << depth) {}
+
+    /** Supersampling recursion depth, negative when disabled. */
+    int maxDepth;
+    /** Lattice steps per pixel. */
+    std::size_t scale;
+    /** Traced colors, keyed by lattice x in the high 32 bits and y below. */
+    std::unordered_map<std::uint64_t, Color> colors;
+    /** Number of rays traced. */
+    std::size_t traced{0};
+    /** Number of lookups answered by the cache. */
+    std::size_t reused{0};
+  };
+
+  /**
+   * @brief Render one tile of the scene.
    * @param scene Scene to render.
-   * @param pixelBuffer Buffer to store pixel colors.
-   * @param startY Starting Y coordinate of the chunk.
-   * @param endY Ending Y coordinate of the chunk.
+   * @param pixels Uninitialized row-major storage of width * height colors;
+   * the tile's pixels are constructed in place.
+   * @param tile Pixels to render.
+   */
+  void renderTile(const Scene &scene, Color *pixels, const Tile &tile) const;
+
+  /**
+   * @brief Run a tile scheduler with the configured threads.
+   * @param scheduler Tiles to render.
+   * @param work Called once per tile.
+   * @param cancelFlag If non-null, stops the render once set.
    */
-  void renderChunk(const Scene &scene,
-                   std::vector<std::vector<Color>> &pixelBuffer, size_t startY,
-                   size_t endY) const;
+  void runTiles(const TileScheduler &scheduler,
+                const std::function<void(const Tile &)> &work,
+                const std::atomic<bool> *cancelFlag = nullptr) const;
 
   /**
    * @brief Compute the color for a specific pixel.
    * @param scene Scene to render.
+   * @param cache Samples of the tile the pixel belongs to.
    * @param x Pixel x coordinate.
    * @param y Pixel y coordinate.
    * @return Computed pixel color.
    */
-  [[nodiscard]] Color computePixelColor(const Scene &scene, std::size_t x,
+  [[nodiscard]] Color computePixelColor(const Scene &scene,
+                                        SampleCache &cache, std::size_t x,
                                         std::size_t y) const;
 
   /**
-   * @brief Trace a ray through the scene.
+   * @brief Record the cache statistics of a finished tile.
+   * @param cache Cache of the tile.
+   */
+  void recordSampling(const SampleCache &cache) const;
+
+  /**
+   * @brief Compute one stratified sample of a pixel for a progressive pass.
+   * @param scene Scene to render.
+   * @param x Pixel x coordinate.
+   * @param y Pixel y coordinate.
+   * @param pass Index of the pass, selects the stratum.
+   * @return Unclamped radiance of the sample.
+   */
+  [[nodiscard]] Radiance samplePixel(const Scene &scene, std::size_t x,
+                                     std::size_t y, std::size_t pass) const;
+
+  /**
+   * @brief Progressive variant of renderToBuffer().
+   * @param scene Scene to render.
+   * @param out Pre‐allocated RGBA8 buffer of size width*height*4.
+   * @param cancelFlag If non‐null, stops the render once set.
+   * @param rowsDone If non‐null, progress of the current pass in rows.
+   * @param passesDone If non‐null, number of completed passes.
+   */
+  void renderProgressive(const Scene &scene, std::vector<uint8_t> &out,
+                         std::atomic<bool> *cancelFlag,
+                         std::atomic<size_t> *rowsDone,
+                         std::atomic<size_t> *passesDone) const;
+
+  /**
+   * @brief Time-budgeted render shared by render() and renderToBuffer().
+   * @param scene Scene to render.
+   * @param store Called with the index and color of every pixel written,
+   * possibly several times per pixel as its quality improves.
+   * @param cancelFlag If non‐null, stops the render once set.
+   * @param rowsDone If non‐null, progress of the current pass in rows.
+   * @param passesDone If non‐null, number of completed passes.
+   */
+  void renderWithBudget(
+      const Scene &scene,
+      const std::function<void(std::size_t, const Color &)> &store,
+      std::atomic<bool> *cancelFlag, std::atomic<size_t> *rowsDone,
+      std::atomic<size_t> *passesDone) const;
+
+  /**
+   * @brief Trace a ray and every ray its materials spawn.
    * @param scene Scene to render.
    * @param ray Ray to trace.
+   * @param context State of the camera path the ray belongs to.
    * @return Resulting color.
    */
-  [[nodiscard]] Color traceRay(const Scene &scene, const Ray &ray) const;
+  [[nodiscard]] Color traceRay(const Scene &scene, const Ray &ray,
+                               RenderContext &context) const;
+
+  /**
+   * @brief Trace a ray and every ray its materials spawn, without clamping.
+   *
+   * Accumulated samples are averaged from this value, so bright samples are
+   * not clipped before they are weighed against dark ones.
+   * @param scene Scene to render.
+   * @param ray Ray to trace.
+   * @param context State of the camera path the ray belongs to.
+   * @return Red, green and blue radiance on the 0-255 scale.
+   */
+  [[nodiscard]] Radiance traceRadiance(const Scene &scene, const Ray &ray,
+                                       RenderContext &context) const;
+
+  /**
+   * @brief Render one tile breadth-first, one batch of rays per bounce.
+   * @param scene Scene to render.
+   * @param tile Tile to render.
+   * @param store Receives each pixel index with its final color.
+   * @param cancelFlag If non-null, checked between bounces.
+   * @return false if the render was cancelled, in which case no pixel of
+   * the tile is stored.
+   */
+  bool renderTileWavefront(
+      const Scene &scene, const Tile &tile,
+      const std::function<void(std::size_t, const Color &)> &store,
+      const std::atomic<bool> *cancelFlag = nullptr) const;
+
+  /**
+   * @brief Check whether tiles go through renderTileWavefront().
+   * @return True if the wavefront path is enabled and applies.
+   */
+  [[nodiscard]] bool useWavefront() const noexcept;
 
 private:
   /**
-   * @brief Collect all lights in the scene.
+   * @brief Collect all lights of a scene that has not been compiled.
    * @param scene Scene to render.
    * @param lights Vector to store collected lights.
    */
   void collectLights(const Scene &scene,
-                     std::vector<std::shared_ptr<ILight>> &lights) const;
+                     std::vector<const ILight *> &lights) const;
 
   /** @brief Recursive adaptive‐supersample
    * @param scene Scene to render.
-   * @param uMin Minimum U coordinate.
-   * @param vMin Minimum V coordinate.
-   * @param uMax Maximum U coordinate.
-   * @param vMax Maximum V coordinate.
+   * @param cache Samples already traced in the current tile.
+   * @param x0 Lattice column of the square's left edge.
+   * @param y0 Lattice row of the square's top edge.
+   * @param size Side of the square in lattice steps.
    * @param depth Current recursion depth.
    * @return Computed color.
    */
-  [[nodiscard]] Color sampleRegion(const Scene &scene, double uMin, double vMin,
-                                   double uMax, double vMax, int depth) const;
+  [[nodiscard]] Color sampleRegion(const Scene &scene, SampleCache &cache,
+                                   std::size_t x0, std::size_t y0,
+                                   std::size_t size, int depth) const;
+
+  /**
+   * @brief Trace a lattice point, or reuse its color if already traced.
+   * @param scene Scene to render.
+   * @param cache Samples already traced in the current tile.
+   * @param x Lattice column.
+   * @param y Lattice row.
+   * @return Color seen through the lattice point.
+   */
+  [[nodiscard]] Color sampleLattice(const Scene &scene, SampleCache &cache,
+                                    std::size_t x, std::size_t y) const;
+
+  /**
+   * @brief Supersampling depth of a regular render.
+   * @return The configured depth, or -1 when supersampling is off.
+   */
+  [[nodiscard]] int getSamplingDepth() const noexcept;
 
 private:
   std::size_t m_width;
   std::size_t m_height;
 
   bool m_useMultithreading = true;
+  unsigned int m_threadCount = 0;
+  bool m_pinThreads = false;
+  std::size_t m_tileSize = 16;
+  TileOrder m_tileOrder = TileOrder::Scanline;
+  mutable std::vector<WorkerStats> m_lastStats;
+  mutable SamplingStats m_lastSampling;
+  mutable std::atomic<size_t> m_raysTraced{0};
+  mutable std::atomic<size_t> m_raysSaved{0};
 
   bool m_enableAdaptiveSS = false;
   int m_AAMaxDepth = 2;
   double m_AAThreshold = 20.0;
+
+  bool m_progressive = false;
+  bool m_wavefront = false;
+  bool m_sortRays = false;
+  std::size_t m_maxPasses = 0;
+
+  static constexpr std::size_t MAX_PENDING_RAYS = 32;
+
+  static constexpr std::size_t BUDGET_COARSE_BLOCK = 4;
+  static constexpr int BUDGET_MAX_AA_DEPTH = 3;
+  std::chrono::milliseconds m_timeBudget{0};
+  mutable std::size_t m_lastPassCount = 0;
 };
 
 } // namespace Raytracer::Core
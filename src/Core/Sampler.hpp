@@ -0,0 +1,138 @@
+/**
+ * @file Sampler.hpp
+ * @brief Defines the deterministic sampler used for every random decision
+ * of a render.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <utility>
+
+namespace Raytracer::Core {
+
+/**
+ * @class Sampler
+ * @brief Counter-based source of sample values for one camera path.
+ *
+ * Every value is a pure function of (pixel, sample index, dimension): no
+ * state is shared between threads, and a render gives the same image
+ * whatever the thread count or tile order. Dimensions are consumed in
+ * order along the path. Each pair of dimensions is a 2D Sobol sequence
+ * over the sample index, shuffled per pair and rotated per pixel, so the
+ * samples of a pixel stay stratified in every pair while neighbouring
+ * pixels and dimensions stay decorrelated.
+ */
+class Sampler final {
+public:
+  /**
+   * @brief Create the sampler of one camera sample.
+   * @param pixel Identifier of the pixel, or of any shared sample point.
+   * @param sample Index of the sample within the pixel.
+   */
+  Sampler(std::uint64_t pixel, std::uint32_t sample) noexcept
+      : m_pixel(pixel), m_sample(sample) {}
+
+  /**
+   * @brief Get the next value of the path.
+   * @return Value in [0, 1).
+   */
+  [[nodiscard]] double next1D() noexcept {
+    std::uint32_t dimension = m_dimension++;
+    std::uint32_t pair = dimension / 2;
+    std::uint32_t index = m_sample ^ hash(0, pair, 0x5bd1e995u);
+    std::uint32_t bits = (dimension % 2 == 0) ? sobol0(index) : sobol1(index);
+    bits += hash(m_pixel, 0, dimension);
+    return toUnit(bits);
+  }
+
+  /**
+   * @brief Get the next two values of the path.
+   * @return Values in [0, 1), stratified together over the samples.
+   */
+  [[nodiscard]] std::pair<double, double> next2D() noexcept {
+    if (m_dimension % 2 != 0) {
+      ++m_dimension;
+    }
+    double first = next1D();
+    double second = next1D();
+    return {first, second};
+  }
+
+  /**
+   * @brief Get the number of dimensions consumed so far.
+   * @return Index of the next dimension.
+   */
+  [[nodiscard]] std::uint32_t getDimension() const noexcept {
+    return m_dimension;
+  }
+
+  /**
+   * @brief Hash a (pixel, sample, dimension) counter into 32 random bits.
+   *
+   * PCG-style output permutation applied to the combined counter.
+   * @param pixel Pixel identifier.
+   * @param sample Sample index.
+   * @param dimension Dimension index.
+   * @return Uniformly distributed bits.
+   */
+  [[nodiscard]] static std::uint32_t hash(std::uint64_t pixel,
+                                          std::uint32_t sample,
+                                          std::uint32_t dimension) noexcept {
+    std::uint64_t state = pixel * 0x9E3779B97F4A7C15ULL;
+    state ^= (static_cast<std::uint64_t>(sample) << 32 | dimension) +
+             0x632BE59BD9B4E019ULL;
+    state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+    auto word = static_cast<std::uint32_t>(
+        ((state >> ((state >> 59u) + 5u)) ^ state) >> 32);
+    word ^= static_cast<std::uint32_t>(state);
+    word = (word ^ (word >> 16)) * 0x7feb352du;
+    word = (word ^ (word >> 15)) * 0x846ca68bu;
+    return word ^ (word >> 16);
+  }
+
+private:
+  /**
+   * @brief First Sobol dimension, the base-2 van der Corput sequence.
+   * @param index Sample index.
+   * @return Value scaled to 32 bits.
+   */
+  [[nodiscard]] static std::uint32_t sobol0(std::uint32_t index) noexcept {
+    index = (index << 16) | (index >> 16);
+    index = ((index & 0x00FF00FFu) << 8) | ((index & 0xFF00FF00u) >> 8);
+    index = ((index & 0x0F0F0F0Fu) << 4) | ((index & 0xF0F0F0F0u) >> 4);
+    index = ((index & 0x33333333u) << 2) | ((index & 0xCCCCCCCCu) >> 2);
+    index = ((index & 0x55555555u) << 1) | ((index & 0xAAAAAAAAu) >> 1);
+    return index;
+  }
+
+  /**
+   * @brief Second Sobol dimension.
+   * @param index Sample index.
+   * @return Value scaled to 32 bits.
+   */
+  [[nodiscard]] static std::uint32_t sobol1(std::uint32_t index) noexcept {
+    std::uint32_t result = 0;
+    for (std::uint32_t v = 1u << 31; index != 0; index >>= 1, v ^= v >> 1) {
+      if (index & 1u) {
+        result ^= v;
+      }
+    }
+    return result;
+  }
+
+  /**
+   * @brief Map 32 bits to a double in [0, 1).
+   * @param bits Bits to map.
+   * @return Value in [0, 1).
+   */
+  [[nodiscard]] static double toUnit(std::uint32_t bits) noexcept {
+    return static_cast<double>(bits) * (1.0 / 4294967296.0);
+  }
+
+  std::uint64_t m_pixel;
+  std::uint32_t m_sample;
+  std::uint32_t m_dimension{0};
+};
+
+} // namespace Raytracer::Core
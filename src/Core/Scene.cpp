@@ -1,47 +1,474 @@
 #include "Core/Scene.hpp"
 #include "Core/Intersection.hpp"
 #include "Core/Ray.hpp"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include <unordered_set>
 
 namespace Raytracer::Core {
 
+namespace {
+// Hit distances and box entry distances are computed along different
+// arithmetic paths; widen the pruning bound so rounding never culls a hit
+// that the exhaustive search would have kept.
+constexpr double PRUNE_SLACK = 1.0 + 1e-9;
+
+std::optional<Intersection> intersectInstance(const Scene::Instance &instance,
+                                              const Ray &ray) {
+  Ray localRay = instance.transform.inverseTransformRay(ray);
+  auto hit = instance.scene->findNearestIntersection(localRay);
+  if (!hit) {
+    return std::nullopt;
+  }
+
+  Math::Point<3> worldPoint =
+      instance.transform.transformPoint(hit->getPoint());
+  Math::Vector<3> worldNormal =
+      instance.transform.transformNormal(hit->getNormal());
+  return Intersection(worldPoint, worldNormal, hit->getMaterial(),
+                      (worldPoint - ray.getOrigin()).length(),
+                      hit->getIsInside(), hit->getUv());
+}
+
+// Instance rays keep their direction unnormalized, so the ray parameter of
+// a hit is the same in both spaces and records can be compared directly.
+bool findInstanceHit(const Scene::Instance &instance, const Ray &ray,
+                     HitRecord &hit) {
+  if (!instance.scene->findHit(instance.transform.inverseTransformRay(ray),
+                               hit)) {
+    return false;
+  }
+  hit.instance = &instance;
+  return true;
+}
+
+/**
+ * @class OccluderCache
+ * @brief Last occluder found by one thread for each light it casts to.
+ *
+ * Slots are picked by hashing the light, so two lights may evict each other;
+ * a slot only hints at an entry to test first. Every cache registers itself
+ * so the counters of all threads can be summed, and folds its counts into
+ * the retired totals when its thread exits.
+ */
+class OccluderCache {
+public:
+  struct Slot {
+    const Scene *scene{nullptr};
+    const ILight *light{nullptr};
+    std::uint32_t item{0};
+  };
+
+  OccluderCache() {
+    Registry &registry = getRegistry();
+    std::lock_guard lock(registry.mutex);
+    registry.caches.push_back(this);
+  }
+
+  ~OccluderCache() {
+    Registry &registry = getRegistry();
+    std::lock_guard lock(registry.mutex);
+    registry.retired.lookups += lookups.load(std::memory_order_relaxed);
+    registry.retired.hits += hits.load(std::memory_order_relaxed);
+    std::erase(registry.caches, this);
+  }
+
+  OccluderCache(const OccluderCache &) = delete;
+  OccluderCache &operator=(const OccluderCache &) = delete;
+
+  Slot &slot(const ILight *light) noexcept {
+    const auto key = reinterpret_cast<std::uintptr_t>(light);
+    return m_slots[(key >> 4) % SLOT_COUNT];
+  }
+
+  static OccluderCacheStats total() {
+    Registry &registry = getRegistry();
+    std::lock_guard lock(registry.mutex);
+    OccluderCacheStats stats = registry.retired;
+    for (const OccluderCache *cache : registry.caches) {
+      stats.lookups += cache->lookups.load(std::memory_order_relaxed);
+      stats.hits += cache->hits.load(std::memory_order_relaxed);
+    }
+    return stats;
+  }
+
+  static void reset() {
+    Registry &registry = getRegistry();
+    std::lock_guard lock(registry.mutex);
+    registry.retired = {};
+    for (OccluderCache *cache : registry.caches) {
+      cache->lookups.store(0, std::memory_order_relaxed);
+      cache->hits.store(0, std::memory_order_relaxed);
+    }
+  }
+
+  /**
+   * @brief Count one event on a counter of the calling thread's cache.
+   *
+   * Only the owning thread writes its counters, so a plain load and store
+   * is enough and avoids a locked read-modify-write per shadow ray. A
+   * reset made by another thread in between may be overwritten, which
+   * only skews statistics.
+   * @param counter Counter to increment.
+   */
+  static void count(std::atomic<std::size_t> &counter) noexcept {
+    counter.store(counter.load(std::memory_order_relaxed) + 1,
+                  std::memory_order_relaxed);
+  }
+
+  // Only the owning thread counts; other threads read or reset them.
+  std::atomic<std::size_t> lookups{0};
+  std::atomic<std::size_t> hits{0};
+
+private:
+  struct Registry {
+    std::mutex mutex;
+    std::vector<OccluderCache *> caches;
+    OccluderCacheStats retired;
+  };
+
+  static Registry &getRegistry() {
+    static Registry registry;
+    return registry;
+  }
+
+  static constexpr std::size_t SLOT_COUNT = 16;
+  std::array<Slot, SLOT_COUNT> m_slots{};
+};
+
+thread_local OccluderCache t_occluders;
+
+std::optional<Intersection> resolveHit(const Ray &ray, const HitRecord &hit) {
+  // Only the outermost instance is recorded, so hits inside one are shaded
+  // by tracing that instance again rather than walking the whole scene.
+  if (hit.instance) {
+    return intersectInstance(*hit.instance, ray);
+  }
+  return hit.primitive->computeIntersection(ray, hit);
+}
+} // namespace
+
+void Scene::compile() {
+  auto compiled = std::make_unique<Compiled>();
+  std::vector<BoundingBox> bounds;
+  flatten(*this, *compiled, bounds);
+
+  std::unordered_set<const IMaterial *> seenMaterials;
+  auto addMaterial = [&](const IMaterial *material) {
+    if (material && seenMaterials.insert(material).second) {
+      compiled->materials.push_back(material);
+    }
+  };
+  for (const Item &item : compiled->items) {
+    if (item.primitive) {
+      addMaterial(item.primitive->getMaterial().get());
+    } else {
+      const auto &materials = item.instance->scene->getMaterialList();
+      for (const IMaterial *material : materials) {
+        addMaterial(material);
+      }
+    }
+  }
+
+  compiled->bvh.build(bounds);
+  compiled->lightTree.build(compiled->lights);
+  compiled->bounds = compiled->unboundedItems.empty()
+                         ? compiled->bvh.getBounds()
+                         : BoundingBox::infinite();
+  m_compiled = std::move(compiled);
+}
+
+void Scene::flatten(const Scene &scene, Compiled &compiled,
+                    std::vector<BoundingBox> &bounds) {
+  // Items are numbered in the order the exhaustive search visits them:
+  // primitives, then child scenes depth first, then instances. Child scenes
+  // share the space of their parent, so their primitives are added as is.
+  auto addItem = [&](const Item &item, const BoundingBox &box) {
+    const auto index = static_cast<std::uint32_t>(compiled.items.size());
+    compiled.items.push_back(item);
+    if (box.isBounded()) {
+      compiled.boundedItems.push_back(index);
+      bounds.push_back(box);
+    } else {
+      compiled.unboundedItems.push_back(index);
+    }
+  };
+
+  for (const auto &[id, primitive] : scene.m_primitives) {
+    addItem({primitive.get(), nullptr}, primitive->getBoundingBox());
+  }
+  for (const auto &[id, light] : scene.m_lights) {
+    compiled.lights.push_back(light.get());
+  }
+  for (const auto &[id, childScene] : scene.m_childScenes) {
+    flatten(*childScene, compiled, bounds);
+  }
+  for (const auto &[id, instance] : scene.m_instances) {
+    BoundingBox box = instance.scene->getBounds();
+    addItem({nullptr, &instance},
+            box.isBounded() ? instance.transform.transformBoundingBox(box)
+                            : box);
+  }
+}
+
+bool Scene::findItemHit(const Item &item, const Ray &ray, HitRecord &hit) {
+  if (item.primitive) {
+    return item.primitive->findHit(ray, hit);
+  }
+  return findInstanceHit(*item.instance, ray, hit);
+}
+
+bool Scene::hitsItem(const Item &item, const Ray &ray) {
+  if (item.primitive) {
+    return item.primitive->occluded(ray);
+  }
+  return item.instance->scene->hasIntersection(
+      item.instance->transform.inverseTransformRay(ray));
+}
+
+std::optional<std::uint32_t> Scene::findOccluder(const Compiled &compiled,
+                                                 const Ray &ray) {
+  for (std::uint32_t index : compiled.unboundedItems) {
+    if (hitsItem(compiled.items[index], ray)) {
+      return index;
+    }
+  }
+  std::optional<std::uint32_t> occluder;
+  compiled.bvh.traverse(ray, [&](std::uint32_t item, double &) {
+    const std::uint32_t index = compiled.boundedItems[item];
+    if (!hitsItem(compiled.items[index], ray)) {
+      return false;
+    }
+    occluder = index;
+    return true;
+  });
+  return occluder;
+}
+
 bool Scene::hasIntersection(const Ray &ray) const {
+  if (m_compiled) {
+    return findOccluder(*m_compiled, ray).has_value();
+  }
+
   for (const auto &[id, primitive] : m_primitives) {
-    if (primitive->intersect(ray).has_value()) {
+    if (primitive->occluded(ray)) {
       return true;
     }
   }
-
   for (const auto &[id, childScene] : m_childScenes) {
     if (childScene->hasIntersection(ray)) {
       return true;
     }
   }
+  for (const auto &[id, instance] : m_instances) {
+    if (instance.scene->hasIntersection(
+            instance.transform.inverseTransformRay(ray))) {
+      return true;
+    }
+  }
   return false;
 }
 
+bool Scene::hasIntersection(const Ray &ray, const ILight &light) const {
+  if (!m_compiled) {
+    return hasIntersection(ray);
+  }
+
+  const Compiled &compiled = *m_compiled;
+  OccluderCache &cache = t_occluders;
+  OccluderCache::Slot &slot = cache.slot(&light);
+  OccluderCache::count(cache.lookups);
+  // The scene may have been recompiled since the slot was filled, so the
+  // index is only trusted once it is known to fit the current snapshot.
+  if (slot.scene == this && slot.light == &light &&
+      slot.item < compiled.items.size() &&
+      hitsItem(compiled.items[slot.item], ray)) {
+    OccluderCache::count(cache.hits);
+    return true;
+  }
+
+  std::optional<std::uint32_t> occluder = findOccluder(compiled, ray);
+  if (occluder) {
+    slot = {this, &light, *occluder};
+  }
+  return occluder.has_value();
+}
+
+OccluderCacheStats Scene::getOccluderCacheStats() {
+  return OccluderCache::total();
+}
+
+void Scene::resetOccluderCacheStats() { OccluderCache::reset(); }
+
 std::optional<Intersection>
 Scene::findNearestIntersection(const Ray &ray) const {
-  std::optional<Intersection> nearestHit;
-  double nearestDistance = std::numeric_limits<double>::infinity();
+  HitRecord hit;
+  if (!findHit(ray, hit)) {
+    return std::nullopt;
+  }
+  return resolveHit(ray, hit);
+}
 
-  for (const auto &[id, primitive] : m_primitives) {
-    if (auto hit = primitive->intersect(ray)) {
-      if (hit->getDistance() < nearestDistance) {
-        nearestDistance = hit->getDistance();
-        nearestHit = hit;
+bool Scene::findHit(const Ray &ray, HitRecord &hit) const {
+  bool found = false;
+
+  if (m_compiled) {
+    const Compiled &compiled = *m_compiled;
+    // Ties are resolved towards the item that comes first, which is the one
+    // the exhaustive search below would keep: an earlier item is allowed to
+    // match the current distance exactly.
+    std::uint32_t nearestIndex = 0;
+    auto consider = [&](std::uint32_t index) {
+      HitRecord candidate = hit;
+      if (found && index < nearestIndex) {
+        candidate.t =
+            std::nextafter(hit.t, std::numeric_limits<double>::infinity());
+      }
+      if (findItemHit(compiled.items[index], ray, candidate)) {
+        hit = candidate;
+        nearestIndex = index;
+        found = true;
       }
+    };
+
+    for (std::uint32_t index : compiled.unboundedItems) {
+      consider(index);
     }
+
+    compiled.bvh.traverse(ray, [&](std::uint32_t item, double &tMax) {
+      consider(compiled.boundedItems[item]);
+      tMax = std::min(tMax, hit.t * PRUNE_SLACK);
+      return false;
+    });
+    return found;
   }
 
+  for (const auto &[id, primitive] : m_primitives) {
+    found = primitive->findHit(ray, hit) || found;
+  }
   for (const auto &[id, childScene] : m_childScenes) {
-    if (auto childHit = childScene->findNearestIntersection(ray)) {
-      if (childHit->getDistance() < nearestDistance) {
-        nearestDistance = childHit->getDistance();
-        nearestHit = childHit;
+    found = childScene->findHit(ray, hit) || found;
+  }
+  for (const auto &[id, instance] : m_instances) {
+    found = findInstanceHit(instance, ray, hit) || found;
+  }
+  return found;
+}
+
+std::uint32_t Scene::findHits(std::span<const Ray> rays,
+                              std::span<HitRecord> hits) const {
+  const std::size_t count = std::min({rays.size(), hits.size(), PACKET_SIZE});
+  std::uint32_t found = 0;
+
+  if (!m_compiled) {
+    for (std::size_t lane = 0; lane < count; ++lane) {
+      if (findHit(rays[lane], hits[lane])) {
+        found |= 1u << lane;
+      }
+    }
+    return found;
+  }
+
+  // Same per-ray tie-breaking and pruning as findHit().
+  const Compiled &compiled = *m_compiled;
+  std::array<std::uint32_t, PACKET_SIZE> nearestIndex{};
+  auto consider = [&](std::size_t lane, std::uint32_t index) {
+    const std::uint32_t bit = 1u << lane;
+    HitRecord candidate = hits[lane];
+    if ((found & bit) != 0 && index < nearestIndex[lane]) {
+      candidate.t = std::nextafter(hits[lane].t,
+                                   std::numeric_limits<double>::infinity());
+    }
+    if (findItemHit(compiled.items[index], rays[lane], candidate)) {
+      hits[lane] = candidate;
+      nearestIndex[lane] = index;
+      found |= bit;
+    }
+  };
+
+  std::array<double, PACKET_SIZE> tMax{};
+  for (std::size_t lane = 0; lane < count; ++lane) {
+    for (std::uint32_t index : compiled.unboundedItems) {
+      consider(lane, index);
+    }
+    tMax[lane] = rays[lane].getMaxDistance();
+  }
+
+  const auto lanes = static_cast<std::uint32_t>((1u << count) - 1);
+  compiled.bvh.traversePacket(
+      rays.first(count), lanes, tMax,
+      [&](std::uint32_t item, std::uint32_t live) {
+        const std::uint32_t index = compiled.boundedItems[item];
+        for (; live != 0; live &= live - 1) {
+          const auto lane = static_cast<std::size_t>(std::countr_zero(live));
+          consider(lane, index);
+          tMax[lane] = std::min(tMax[lane], hits[lane].t * PRUNE_SLACK);
+        }
+        return 0u;
+      });
+  return found;
+}
+
+void Scene::findNearestIntersections(
+    std::span<const Ray> rays,
+    std::span<std::optional<Intersection>> intersections) const {
+  const std::size_t count =
+      std::min({rays.size(), intersections.size(), PACKET_SIZE});
+  std::array<HitRecord, PACKET_SIZE> hits{};
+  const std::uint32_t found = findHits(rays.first(count), hits);
+
+  for (std::size_t lane = 0; lane < count; ++lane) {
+    intersections[lane] = (found >> lane & 1u) != 0
+                              ? resolveHit(rays[lane], hits[lane])
+                              : std::nullopt;
+  }
+}
+
+std::uint32_t Scene::findOccluded(std::span<const Ray> rays) const {
+  const std::size_t count = std::min(rays.size(), PACKET_SIZE);
+  std::uint32_t occluded = 0;
+
+  if (!m_compiled) {
+    for (std::size_t lane = 0; lane < count; ++lane) {
+      if (hasIntersection(rays[lane])) {
+        occluded |= 1u << lane;
       }
     }
+    return occluded;
   }
-  return nearestHit;
+
+  const Compiled &compiled = *m_compiled;
+  std::array<double, PACKET_SIZE> tMax{};
+  for (std::size_t lane = 0; lane < count; ++lane) {
+    for (std::uint32_t index : compiled.unboundedItems) {
+      if (hitsItem(compiled.items[index], rays[lane])) {
+        occluded |= 1u << lane;
+        break;
+      }
+    }
+    tMax[lane] = rays[lane].getMaxDistance();
+  }
+
+  const auto lanes = static_cast<std::uint32_t>((1u << count) - 1);
+  compiled.bvh.traversePacket(
+      rays.first(count), lanes & ~occluded, tMax,
+      [&](std::uint32_t item, std::uint32_t live) {
+        const Item &entry = compiled.items[compiled.boundedItems[item]];
+        std::uint32_t done = 0;
+        for (; live != 0; live &= live - 1) {
+          const auto lane = static_cast<std::size_t>(std::countr_zero(live));
+          if (hitsItem(entry, rays[lane])) {
+            done |= 1u << lane;
+          }
+        }
+        occluded |= done;
+        return done;
+      });
+  return occluded;
 }
 
 } // namespace Raytracer::Core
@@ -5,19 +5,58 @@
 
 #pragma once
 
+#include "Core/BVH.hpp"
 #include "Core/Camera.hpp"
 #include "Core/ILight.hpp"
 #include "Core/IPrimitive.hpp"
+#include "Core/LightTree.hpp"
+#include "Core/PathTermination.hpp"
+#include "Math/Transform.hpp"
+#include <cstdint>
 #include <memory>
+#include <optional>
+#include <span>
 #include <unordered_map>
+#include <vector>
 
 namespace Raytracer::Core {
+class Scene;
+
+/**
+ * @struct SceneInstance
+ * @brief Placement of a shared scene inside another one.
+ *
+ * Several instances may point to the same scene, which then keeps a single
+ * acceleration structure for all of them. Only the geometry of an instanced
+ * scene is used; its lights and camera are ignored.
+ */
+struct SceneInstance {
+  std::shared_ptr<const Scene> scene;
+  Math::Transform transform;
+};
+
+/**
+ * @struct OccluderCacheStats
+ * @brief Shadow queries answered by the last-occluder cache.
+ */
+struct OccluderCacheStats {
+  /** Number of shadow queries made with a light. */
+  std::size_t lookups{0};
+  /** Number of those answered by the cached occluder alone. */
+  std::size_t hits{0};
+};
+
 /**
  * @class Scene
  * @brief Manages a 3D scene containing primitives, lights, and a camera.
  */
 class Scene {
 public:
+  using Instance = SceneInstance;
+
+  /** Largest number of rays the packet queries trace together. */
+  static constexpr std::size_t PACKET_SIZE = BVH::PACKET_SIZE;
+
   /**
    * @brief Default constructor.
    */
@@ -58,6 +97,7 @@ public:
   template <typename T,
             typename = std::enable_if_t<std::is_base_of_v<IPrimitive, T>>>
   bool addPrimitive(const std::string &id, std::unique_ptr<T> primitive) {
+    m_compiled.reset();
     return m_primitives
         .try_emplace(id, std::unique_ptr<IPrimitive>(primitive.release()))
         .second;
@@ -69,6 +109,7 @@ public:
    * @return true if removed successfully, false if not found.
    */
   bool removePrimitive(const std::string &id) {
+    m_compiled.reset();
     return m_primitives.erase(id) > 0;
   }
 
@@ -77,7 +118,7 @@ public:
    * @param id The identifier of the primitive.
    * @return Pointer to the primitive if found, nullptr otherwise.
    */
-  [[nodiscard]] IPrimitive *getPrimitive(const std::string &id) const {
+  [[nodiscard]] const IPrimitive *getPrimitive(const std::string &id) const {
     auto it = m_primitives.find(id);
     return (it != m_primitives.end()) ? it->second.get() : nullptr;
   }
@@ -92,6 +133,7 @@ public:
   template <typename T,
             typename = std::enable_if_t<std::is_base_of_v<ILight, T>>>
   bool addLight(const std::string &id, std::unique_ptr<T> light) {
+    m_compiled.reset();
     return m_lights.try_emplace(id, std::unique_ptr<ILight>(light.release()))
         .second;
   }
@@ -101,14 +143,17 @@ public:
    * @param id The identifier of the light to remove.
    * @return true if removed successfully, false if not found.
    */
-  bool removeLight(const std::string &id) { return m_lights.erase(id) > 0; }
+  bool removeLight(const std::string &id) {
+    m_compiled.reset();
+    return m_lights.erase(id) > 0;
+  }
 
   /**
    * @brief Get a reference to a light by its ID.
    * @param id The identifier of the light.
    * @return Pointer to the light if found, nullptr otherwise.
    */
-  [[nodiscard]] ILight *getLight(const std::string &id) const {
+  [[nodiscard]] const ILight *getLight(const std::string &id) const {
     auto it = m_lights.find(id);
     return (it != m_lights.end()) ? it->second.get() : nullptr;
   }
@@ -131,6 +176,42 @@ public:
    */
   Camera &getCamera() { return m_camera; }
 
+  /**
+   * @brief Set the rules for terminating secondary rays.
+   * @param termination The new rules.
+   */
+  void setPathTermination(const PathTermination &termination) noexcept {
+    m_pathTermination = termination;
+  }
+
+  /**
+   * @brief Get the rules for terminating secondary rays.
+   * @return Reference to the rules.
+   */
+  [[nodiscard]] const PathTermination &getPathTermination() const noexcept {
+    return m_pathTermination;
+  }
+
+  /**
+   * @brief Set how many lights are sampled per shading point.
+   *
+   * With 0, every light is evaluated at every hit. Otherwise materials draw
+   * that many positional lights from the light tree, so shading costs the
+   * same whatever the number of lights, at the price of noise.
+   * @param count Number of light samples, 0 to evaluate every light.
+   */
+  void setLightSampleCount(std::size_t count) noexcept {
+    m_lightSampleCount = count;
+  }
+
+  /**
+   * @brief Get how many lights are sampled per shading point.
+   * @return Number of light samples, 0 when every light is evaluated.
+   */
+  [[nodiscard]] std::size_t getLightSampleCount() const noexcept {
+    return m_lightSampleCount;
+  }
+
   /**
    * @brief Add a child scene to this scene.
    * @param id Unique identifier for the child scene.
@@ -138,6 +219,7 @@ public:
    * @return true if added successfully, false if ID already exists.
    */
   bool addChildScene(const std::string &id, std::unique_ptr<Scene> childScene) {
+    m_compiled.reset();
     return m_childScenes.try_emplace(id, std::move(childScene)).second;
   }
 
@@ -147,6 +229,7 @@ public:
    * @return true if removed successfully, false if not found.
    */
   bool removeChildScene(const std::string &id) {
+    m_compiled.reset();
     return m_childScenes.erase(id) > 0;
   }
 
@@ -155,11 +238,44 @@ public:
    * @param id The identifier of the child scene.
    * @return Pointer to the child scene if found, nullptr otherwise.
    */
-  [[nodiscard]] Scene *getChildScene(const std::string &id) const {
+  [[nodiscard]] const Scene *getChildScene(const std::string &id) const {
     auto it = m_childScenes.find(id);
     return (it != m_childScenes.end()) ? it->second.get() : nullptr;
   }
 
+  /**
+   * @brief Add an instance of a shared scene.
+   * @param id Unique identifier for the instance.
+   * @param scene Scene to place, should already be compiled.
+   * @param transform Transformation from the scene's space to this one.
+   * @return true if added successfully, false if ID already exists.
+   */
+  bool addInstance(const std::string &id, std::shared_ptr<const Scene> scene,
+                   const Math::Transform &transform) {
+    m_compiled.reset();
+    return m_instances.try_emplace(id, Instance{std::move(scene), transform})
+        .second;
+  }
+
+  /**
+   * @brief Remove an instance by its ID.
+   * @param id The identifier of the instance to remove.
+   * @return true if removed successfully, false if not found.
+   */
+  bool removeInstance(const std::string &id) {
+    m_compiled.reset();
+    return m_instances.erase(id) > 0;
+  }
+
+  /**
+   * @brief Get all instances placed in the scene.
+   * @return Const reference to the instances container.
+   */
+  [[nodiscard]] const std::unordered_map<std::string, Instance> &
+  getInstances() const {
+    return m_instances;
+  }
+
   /**
    * @brief Get all primitives in the scene.
    * @return Const reference to the primitives container.
@@ -191,34 +307,142 @@ public:
   /**
    * @brief Clear all primitives from the scene.
    */
-  void clearPrimitives() { m_primitives.clear(); }
+  void clearPrimitives() {
+    m_compiled.reset();
+    m_primitives.clear();
+  }
 
   /**
    * @brief Clear all lights from the scene.
    */
-  void clearLights() { m_lights.clear(); }
+  void clearLights() {
+    m_compiled.reset();
+    m_lights.clear();
+  }
 
   /**
    * @brief Clear all child scenes.
    */
-  void clearChildScenes() { m_childScenes.clear(); }
+  void clearChildScenes() {
+    m_compiled.reset();
+    m_childScenes.clear();
+  }
+
+  /**
+   * @brief Clear all instances.
+   */
+  void clearInstances() {
+    m_compiled.reset();
+    m_instances.clear();
+  }
 
   /**
-   * @brief Clear the entire scene (primitives, lights, and child scenes).
+   * @brief Clear the entire scene (primitives, lights, child scenes and
+   * instances).
    */
   void clear() {
     clearPrimitives();
     clearLights();
     clearChildScenes();
+    clearInstances();
+  }
+
+  /**
+   * @brief Build the immutable render snapshot of this scene.
+   *
+   * The primitives of this scene and of its child scenes, which share its
+   * space, are flattened into one dense array under a single hierarchy,
+   * next to the instances. The materials in use and the lights of this
+   * scene and its child scenes are gathered into flat lists as well, so ray
+   * queries never walk the string-keyed containers.
+   * Every edit to the scene needs a new call: adding or removing anything
+   * drops the snapshot, and ray queries then test everything until the
+   * scene is compiled again. The snapshot refers to the primitives, lights
+   * and child scenes directly, so the getters only hand them out as const.
+   * Child scenes are not compiled themselves: the snapshot of the parent
+   * already covers them. Instanced scenes are shared and must be compiled
+   * by their owner.
+   */
+  void compile();
+
+  /**
+   * @brief Get the bounds of everything in the scene.
+   * @return World-space bounding box, infinite when the scene holds an
+   * unbounded primitive or has not been compiled.
+   */
+  [[nodiscard]] BoundingBox getBounds() const noexcept {
+    return m_compiled ? m_compiled->bounds : BoundingBox::infinite();
+  }
+
+  /**
+   * @brief Check whether the render snapshot is up to date.
+   * @return true if compile() was called since the last edit.
+   */
+  [[nodiscard]] bool isCompiled() const noexcept {
+    return m_compiled != nullptr;
+  }
+
+  /**
+   * @brief Get the lights of the compiled scene and its child scenes.
+   * @return Flat light list, empty if the scene has not been compiled.
+   */
+  [[nodiscard]] const std::vector<const ILight *> &getLightList() const {
+    static const std::vector<const ILight *> empty;
+    return m_compiled ? m_compiled->lights : empty;
+  }
+
+  /**
+   * @brief Get the tree over the positional lights of the compiled scene.
+   * @return Light tree, empty if the scene has not been compiled.
+   */
+  [[nodiscard]] const LightTree &getLightTree() const {
+    static const LightTree empty;
+    return m_compiled ? m_compiled->lightTree : empty;
+  }
+
+  /**
+   * @brief Get every distinct material used by the compiled scene.
+   * @return Flat material list, empty if the scene has not been compiled.
+   */
+  [[nodiscard]] const std::vector<const IMaterial *> &getMaterialList() const {
+    static const std::vector<const IMaterial *> empty;
+    return m_compiled ? m_compiled->materials : empty;
   }
 
   /**
    * @brief Check if a ray intersects with any primitive in the scene
+   *
+   * Meant for shadow rays: primitives are only asked whether they occlude
+   * the ray, and the search stops at the first occluder found.
    * @param ray The ray to test for intersection
    * @return true if any intersection is found, false otherwise
    */
   [[nodiscard]] bool hasIntersection(const Ray &ray) const;
 
+  /**
+   * @brief Check if a shadow ray cast towards a light hits any primitive.
+   *
+   * Neighbouring points are usually shadowed from a light by the same
+   * primitive. Each thread remembers, per light, the last entry that
+   * occluded such a ray and tests it before searching the hierarchy. The
+   * answer is always the one hasIntersection() gives.
+   * @param ray The shadow ray to test.
+   * @param light Light the ray is cast towards.
+   * @return true if any intersection is found, false otherwise
+   */
+  [[nodiscard]] bool hasIntersection(const Ray &ray, const ILight &light) const;
+
+  /**
+   * @brief Get the last-occluder cache counters of every thread.
+   * @return Lookups and hits since the last reset.
+   */
+  [[nodiscard]] static OccluderCacheStats getOccluderCacheStats();
+
+  /**
+   * @brief Reset the last-occluder cache counters of every thread.
+   */
+  static void resetOccluderCacheStats();
+
   /**
    * @brief Find the nearest intersection point for a ray in the scene
    * @param ray The ray to test for intersection
@@ -227,10 +451,121 @@ public:
   [[nodiscard]] std::optional<Intersection>
   findNearestIntersection(const Ray &ray) const;
 
+  /**
+   * @brief Find the nearest hit of a ray without computing surface data.
+   *
+   * Only hits strictly closer than @p hit.t are considered, so a record
+   * carried over from an earlier query keeps pruning the search. Equal
+   * distances resolve to the same primitive findNearestIntersection() would
+   * return.
+   * @param ray The ray to test for intersection.
+   * @param hit Closest hit so far, updated when a closer one is found.
+   * @return true if @p hit was updated.
+   */
+  [[nodiscard]] bool findHit(const Ray &ray, HitRecord &hit) const;
+
+  /**
+   * @brief Find the nearest hits of a packet of rays.
+   *
+   * Gives the same records as findHit() on each ray, but rays heading the
+   * same way walk the hierarchy together, see BVH::traversePacket().
+   * @param rays Rays to test, at most PACKET_SIZE.
+   * @param hits Closest hit so far of each ray, updated like findHit().
+   * @return Mask whose bit @c i is set if @c hits[i] was updated.
+   */
+  [[nodiscard]] std::uint32_t findHits(std::span<const Ray> rays,
+                                       std::span<HitRecord> hits) const;
+
+  /**
+   * @brief Find the nearest intersections of a packet of rays.
+   * @param rays Rays to test, at most PACKET_SIZE.
+   * @param intersections Filled with what findNearestIntersection() would
+   * return for each ray.
+   */
+  void findNearestIntersections(
+      std::span<const Ray> rays,
+      std::span<std::optional<Intersection>> intersections) const;
+
+  /**
+   * @brief Check which rays of a packet hit any primitive.
+   *
+   * Packet counterpart of hasIntersection(), meant for the shadow rays cast
+   * from several points towards the same light.
+   * @param rays Rays to test, at most PACKET_SIZE.
+   * @return Mask whose bit @c i is set if @c rays[i] is occluded.
+   */
+  [[nodiscard]] std::uint32_t findOccluded(std::span<const Ray> rays) const;
+
 private:
+  /**
+   * @struct Item
+   * @brief Entry of the top-level hierarchy; exactly one pointer is set.
+   */
+  struct Item {
+    const IPrimitive *primitive{nullptr};
+    const Instance *instance{nullptr};
+  };
+
+  /**
+   * @struct Compiled
+   * @brief Render snapshot built by compile(), never modified afterwards.
+   */
+  struct Compiled {
+    std::vector<Item> items;
+    std::vector<std::uint32_t> boundedItems;
+    std::vector<std::uint32_t> unboundedItems;
+    BVH bvh;
+    BoundingBox bounds;
+    std::vector<const IMaterial *> materials;
+    std::vector<const ILight *> lights;
+    LightTree lightTree;
+  };
+
+  /**
+   * @brief Append the primitives, child scenes and instances of a scene.
+   * @param scene Scene to flatten, in the order the exhaustive search
+   * visits it.
+   * @param compiled Snapshot being built.
+   * @param bounds Bounds of the bounded items added so far.
+   */
+  static void flatten(const Scene &scene, Compiled &compiled,
+                      std::vector<BoundingBox> &bounds);
+
+  /**
+   * @brief Find the nearest hit of a ray with one top-level entry.
+   * @param item Entry to test.
+   * @param ray The ray to test for intersection.
+   * @param hit Closest hit so far, updated when a closer one is found.
+   * @return true if @p hit was updated.
+   */
+  [[nodiscard]] static bool findItemHit(const Item &item, const Ray &ray,
+                                        HitRecord &hit);
+
+  /**
+   * @brief Check if a ray hits one top-level entry.
+   * @param item Entry to test.
+   * @param ray The ray to test for intersection.
+   * @return true if any intersection is found.
+   */
+  [[nodiscard]] static bool hitsItem(const Item &item, const Ray &ray);
+
+  /**
+   * @brief Find a top-level entry of the compiled scene hit by a ray.
+   * @param compiled Snapshot to search.
+   * @param ray The ray to test for intersection.
+   * @return Index of the first occluding entry found, if any.
+   */
+  [[nodiscard]] static std::optional<std::uint32_t>
+  findOccluder(const Compiled &compiled, const Ray &ray);
+
   Camera m_camera;
+  PathTermination m_pathTermination;
+  std::size_t m_lightSampleCount{0};
   std::unordered_map<std::string, std::unique_ptr<IPrimitive>> m_primitives;
   std::unordered_map<std::string, std::unique_ptr<ILight>> m_lights;
   std::unordered_map<std::string, std::unique_ptr<Scene>> m_childScenes;
+  std::unordered_map<std::string, Instance> m_instances;
+
+  std::unique_ptr<const Compiled> m_compiled;
 };
 } // namespace Raytracer::Core
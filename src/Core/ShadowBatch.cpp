@@ -0,0 +1,44 @@
+#include "Core/ShadowBatch.hpp"
+#include "Core/Scene.hpp"
+#include <algorithm>
+#include <array>
+#include <span>
+#include <unordered_map>
+
+namespace Raytracer::Core {
+
+void ShadowBatch::trace(const Scene &scene) {
+  std::unordered_map<const ILight *, std::uint32_t> groups;
+  const ILight *lastLight = nullptr;
+  std::uint32_t group = 0;
+  m_order.clear();
+  for (std::size_t i = 0; i < m_rays.size(); ++i) {
+    if (m_lights[i] != lastLight) {
+      lastLight = m_lights[i];
+      group = groups.try_emplace(lastLight,
+                                 static_cast<std::uint32_t>(groups.size()))
+                  .first->second;
+    }
+    m_order.push_back(static_cast<std::uint64_t>(group) << 32 | i);
+  }
+  std::sort(m_order.begin(), m_order.end());
+
+  m_occluded.assign(m_rays.size(), 0);
+  std::array<Ray, Scene::PACKET_SIZE> packet;
+  for (std::size_t first = 0; first < m_order.size();
+       first += Scene::PACKET_SIZE) {
+    const std::size_t count =
+        std::min(Scene::PACKET_SIZE, m_order.size() - first);
+    for (std::size_t lane = 0; lane < count; ++lane) {
+      packet[lane] = m_rays[m_order[first + lane] & 0xFFFFFFFFu];
+    }
+    const std::uint32_t occluded =
+        scene.findOccluded(std::span<const Ray>(packet.data(), count));
+    for (std::size_t lane = 0; lane < count; ++lane) {
+      m_occluded[m_order[first + lane] & 0xFFFFFFFFu] =
+          static_cast<std::uint8_t>(occluded >> lane & 1u);
+    }
+  }
+}
+
+} // namespace Raytracer::Core
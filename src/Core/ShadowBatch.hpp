@@ -0,0 +1,117 @@
+/**
+ * @file ShadowBatch.hpp
+ * @brief Defines the light terms whose shadow rays a wavefront batch traces
+ * as packets.
+ */
+
+#pragma once
+
+#include "Core/Color.hpp"
+#include "Core/ILight.hpp"
+#include "Core/Ray.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Raytracer::Core {
+
+class Scene;
+
+/**
+ * @class ShadowBatch
+ * @brief Light terms of a batch of hits, kept until their shadow rays are
+ * traced together.
+ *
+ * A material shading a hit of the wavefront path hands over each light
+ * term instead of adding it, together with the shadow ray that decides
+ * whether it counts. Once the whole batch is shaded, the shadow rays are
+ * traced as packets and resolve() adds the terms that are lit, in the
+ * order the material gave them, so the sum is the one the material would
+ * have computed itself. Terms are not clamped, like the material's sum.
+ */
+class ShadowBatch final {
+public:
+  /**
+   * @brief Forget every term and shadow ray.
+   */
+  void clear() noexcept {
+    m_terms.clear();
+    m_rays.clear();
+    m_lights.clear();
+    m_occluded.clear();
+  }
+
+  /**
+   * @brief Get the number of terms given so far.
+   * @return Index of the next term, to pass to resolve().
+   */
+  [[nodiscard]] std::size_t size() const noexcept { return m_terms.size(); }
+
+  /**
+   * @brief Add a term that no shadow ray can hide.
+   * @param term Radiance to add.
+   */
+  void add(const Radiance &term) { m_terms.push_back({term, NO_RAY}); }
+
+  /**
+   * @brief Add a term that only counts if a shadow ray reaches its light.
+   * @param term Radiance to add when the light is visible.
+   * @param ray Shadow ray cast towards the light.
+   * @param light Light the ray is cast towards.
+   */
+  void add(const Radiance &term, const Ray &ray, const ILight &light) {
+    m_terms.push_back({term, static_cast<std::uint32_t>(m_rays.size())});
+    m_rays.push_back(ray);
+    m_lights.push_back(&light);
+  }
+
+  /**
+   * @brief Trace every shadow ray.
+   *
+   * Rays towards the same light start from neighbouring hits and share a
+   * direction octant, so they are grouped by light, in order of first
+   * appearance, before being cut into packets.
+   * @param scene Scene to trace the rays in.
+   */
+  void trace(const Scene &scene);
+
+  /**
+   * @brief Add up the lit terms of one hit.
+   * @param radiance Radiance returned by the material, every lit term is
+   * added to it in order.
+   * @param first Value of size() before the hit was shaded.
+   * @param last Value of size() after the hit was shaded.
+   */
+  void resolve(Radiance &radiance, std::size_t first,
+               std::size_t last) const noexcept {
+    for (std::size_t i = first; i < last; ++i) {
+      const Term &term = m_terms[i];
+      if (term.ray == NO_RAY || !m_occluded[term.ray]) {
+        for (std::size_t c = 0; c < radiance.size(); ++c) {
+          radiance[c] += term.radiance[c];
+        }
+      }
+    }
+  }
+
+private:
+  /** Ray index of the terms that need no shadow ray. */
+  static constexpr std::uint32_t NO_RAY = UINT32_MAX;
+
+  /**
+   * @struct Term
+   * @brief Light term and the shadow ray it depends on.
+   */
+  struct Term {
+    Radiance radiance;
+    std::uint32_t ray;
+  };
+
+  std::vector<Term> m_terms;
+  std::vector<Ray> m_rays;
+  std::vector<const ILight *> m_lights;
+  std::vector<std::uint8_t> m_occluded;
+  std::vector<std::uint64_t> m_order;
+};
+
+} // namespace Raytracer::Core
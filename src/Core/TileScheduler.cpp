@@ -0,0 +1,155 @@
+#include "Core/TileScheduler.hpp"
+#include "Core/RenderThreadPool.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+
+namespace Raytracer::Core {
+
+namespace {
+/**
+ * @struct WorkerQueue
+ * @brief Tiles waiting to be rendered by one worker.
+ */
+struct WorkerQueue {
+  std::mutex mutex;
+  std::deque<std::size_t> tiles;
+};
+
+/**
+ * @brief Interleave the bits of two tile coordinates.
+ * @param x Tile column.
+ * @param y Tile row.
+ * @return Position of the tile along the Z-order curve.
+ */
+std::uint64_t mortonCode(std::uint32_t x, std::uint32_t y) noexcept {
+  auto spread = [](std::uint64_t v) {
+    v = (v | (v << 16)) & 0x0000FFFF0000FFFFULL;
+    v = (v | (v << 8)) & 0x00FF00FF00FF00FFULL;
+    v = (v | (v << 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    v = (v | (v << 2)) & 0x3333333333333333ULL;
+    v = (v | (v << 1)) & 0x5555555555555555ULL;
+    return v;
+  };
+  return spread(x) | (spread(y) << 1);
+}
+} // namespace
+
+TileScheduler::TileScheduler(std::size_t width, std::size_t height,
+                             std::size_t tileSize, TileOrder order) {
+  tileSize = std::max<std::size_t>(tileSize, 1);
+  const std::size_t columns = (width + tileSize - 1) / tileSize;
+  const std::size_t rows = (height + tileSize - 1) / tileSize;
+
+  m_tiles.reserve(columns * rows);
+  for (std::size_t row = 0; row < rows; ++row) {
+    for (std::size_t column = 0; column < columns; ++column) {
+      std::size_t x0 = column * tileSize;
+      std::size_t y0 = row * tileSize;
+      m_tiles.push_back({x0, y0, std::min(x0 + tileSize, width),
+                         std::min(y0 + tileSize, height)});
+    }
+  }
+
+  if (order == TileOrder::Morton) {
+    auto code = [tileSize](const Tile &tile) {
+      return mortonCode(static_cast<std::uint32_t>(tile.x0 / tileSize),
+                        static_cast<std::uint32_t>(tile.y0 / tileSize));
+    };
+    std::stable_sort(m_tiles.begin(), m_tiles.end(),
+                     [&](const Tile &a, const Tile &b) {
+                       return code(a) < code(b);
+                     });
+  } else if (order == TileOrder::CenterOut) {
+    const double centerX = static_cast<double>(width) / 2.0;
+    const double centerY = static_cast<double>(height) / 2.0;
+    auto distance = [&](const Tile &tile) {
+      double dx = static_cast<double>(tile.x0 + tile.x1) / 2.0 - centerX;
+      double dy = static_cast<double>(tile.y0 + tile.y1) / 2.0 - centerY;
+      return dx * dx + dy * dy;
+    };
+    std::stable_sort(m_tiles.begin(), m_tiles.end(),
+                     [&](const Tile &a, const Tile &b) {
+                       return distance(a) < distance(b);
+                     });
+  }
+}
+
+std::vector<WorkerStats>
+TileScheduler::run(unsigned int threadCount,
+                   const std::function<void(const Tile &)> &work,
+                   const std::atomic<bool> *cancelFlag) const {
+  threadCount = std::max(threadCount, 1u);
+  std::vector<WorkerStats> stats(threadCount);
+  std::vector<WorkerQueue> queues(threadCount);
+
+  for (unsigned int worker = 0; worker < threadCount; ++worker) {
+    std::size_t begin = m_tiles.size() * worker / threadCount;
+    std::size_t end = m_tiles.size() * (worker + 1) / threadCount;
+    for (std::size_t tile = begin; tile < end; ++tile) {
+      queues[worker].tiles.push_back(tile);
+    }
+  }
+
+  auto take = [&](unsigned int worker, std::size_t &tile, bool &stolen) {
+    for (unsigned int offset = 0; offset < threadCount; ++offset) {
+      WorkerQueue &queue = queues[(worker + offset) % threadCount];
+      std::lock_guard lock(queue.mutex);
+      if (queue.tiles.empty()) {
+        continue;
+      }
+      if (offset == 0) {
+        tile = queue.tiles.front();
+        queue.tiles.pop_front();
+      } else {
+        tile = queue.tiles.back();
+        queue.tiles.pop_back();
+      }
+      stolen = offset != 0;
+      return true;
+    }
+    return false;
+  };
+
+  auto worker = [&](unsigned int index) {
+    WorkerStats &own = stats[index];
+    std::size_t tile = 0;
+    bool stolen = false;
+    while (!(cancelFlag && cancelFlag->load(std::memory_order_relaxed)) &&
+           take(index, tile, stolen)) {
+      auto start = std::chrono::steady_clock::now();
+      work(m_tiles[tile]);
+      std::chrono::duration<double> elapsed =
+          std::chrono::steady_clock::now() - start;
+      own.busySeconds += elapsed.count();
+      ++own.tiles;
+      own.stolenTiles += stolen ? 1 : 0;
+    }
+  };
+
+  if (threadCount == 1) {
+    worker(0);
+    return stats;
+  }
+
+  RenderThreadPool::getInstance().run(threadCount, worker);
+  return stats;
+}
+
+std::optional<TileOrder>
+TileScheduler::parseOrder(std::string_view name) noexcept {
+  if (name == "scanline") {
+    return TileOrder::Scanline;
+  }
+  if (name == "morton") {
+    return TileOrder::Morton;
+  }
+  if (name == "center") {
+    return TileOrder::CenterOut;
+  }
+  return std::nullopt;
+}
+
+} // namespace Raytracer::Core
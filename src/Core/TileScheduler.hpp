@@ -0,0 +1,105 @@
+/**
+ * @file TileScheduler.hpp
+ * @brief Defines the tile-based work-stealing scheduler used by the renderer.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace Raytracer::Core {
+
+/**
+ * @enum TileOrder
+ * @brief Order in which the tiles of an image are handed out.
+ */
+enum class TileOrder {
+  Scanline, /**< Row by row, left to right. */
+  Morton,   /**< Along a Z-order curve, keeping neighbouring tiles close. */
+  CenterOut /**< From the image center outwards, nearest tiles first. */
+};
+
+/**
+ * @struct Tile
+ * @brief Rectangle of pixels, from (x0, y0) included to (x1, y1) excluded.
+ */
+struct Tile {
+  std::size_t x0{0};
+  std::size_t y0{0};
+  std::size_t x1{0};
+  std::size_t y1{0};
+};
+
+/**
+ * @struct WorkerStats
+ * @brief Work done by one thread during a scheduler run.
+ */
+struct WorkerStats {
+  /** Time spent rendering tiles, in seconds. */
+  double busySeconds{0.0};
+  /** Number of tiles rendered. */
+  std::size_t tiles{0};
+  /** Number of those tiles taken from another worker's queue. */
+  std::size_t stolenTiles{0};
+};
+
+/**
+ * @class TileScheduler
+ * @brief Splits an image into square tiles and renders them on a set of
+ * threads with work stealing.
+ *
+ * Each worker starts with a contiguous run of tiles in the chosen order and
+ * takes them from the front of its own queue. Once its queue is empty it
+ * steals from the back of the other workers' queues, so expensive regions
+ * of the image no longer leave the remaining threads idle.
+ */
+class TileScheduler final {
+public:
+  /**
+   * @brief Split an image into tiles.
+   * @param width Image width in pixels.
+   * @param height Image height in pixels.
+   * @param tileSize Tile side in pixels, 0 is treated as 1.
+   * @param order Order in which the tiles are handed out.
+   */
+  TileScheduler(std::size_t width, std::size_t height, std::size_t tileSize,
+                TileOrder order);
+
+  /**
+   * @brief Get the tiles in the order they are handed out.
+   * @return Tiles covering the image exactly once.
+   */
+  [[nodiscard]] const std::vector<Tile> &getTiles() const noexcept {
+    return m_tiles;
+  }
+
+  /**
+   * @brief Render every tile once.
+   * @param threadCount Number of workers, run on the render thread pool;
+   * the calling thread alone is used when it is 1 or less.
+   * @param work Called once per tile, from any worker.
+   * @param cancelFlag If non-null, workers stop taking tiles once it is set.
+   * @return Statistics of each worker.
+   */
+  std::vector<WorkerStats>
+  run(unsigned int threadCount, const std::function<void(const Tile &)> &work,
+      const std::atomic<bool> *cancelFlag = nullptr) const;
+
+  /**
+   * @brief Parse a tile order name.
+   * @param name One of "scanline", "morton" or "center".
+   * @return The matching order, std::nullopt if the name is unknown.
+   */
+  [[nodiscard]] static std::optional<TileOrder>
+  parseOrder(std::string_view name) noexcept;
+
+private:
+  std::vector<Tile> m_tiles;
+};
+
+} // namespace Raytracer::Core
@@ -0,0 +1,197 @@
+/**
+ * @file Affine.hpp
+ * @brief Defines the Affine class for 3x4 affine transformation matrices.
+ */
+#pragma once
+
+#include "Math/Matrix.hpp"
+#include "Math/Point.hpp"
+#include "Math/Vector.hpp"
+#include <array>
+#include <cmath>
+#include <cstddef>
+
+namespace Raytracer::Math {
+
+/**
+ * @class Affine
+ * @brief Affine transformation stored as the top three rows of a 4x4 matrix.
+ *
+ * The last row of a transformation matrix is always (0, 0, 0, 1), so it is
+ * left out: composing two transforms takes 36 multiplications instead of
+ * 64, applying one to a point 9 instead of 16, and the inverse is computed
+ * in closed form from the 3x3 linear part rather than from cofactors of the
+ * whole matrix.
+ */
+class Affine {
+public:
+  /**
+   * @brief Default constructor creates an identity transformation.
+   */
+  Affine() noexcept
+      : m_rows{{{1.0, 0.0, 0.0, 0.0},
+                {0.0, 1.0, 0.0, 0.0},
+                {0.0, 0.0, 1.0, 0.0}}} {}
+
+  /**
+   * @brief Construct from the top three rows of a 4x4 matrix.
+   * @param matrix Transformation matrix, its last row is ignored.
+   */
+  explicit Affine(const Matrix4 &matrix) noexcept {
+    for (std::size_t i = 0; i < 3; i++) {
+      for (std::size_t j = 0; j < 4; j++) {
+        m_rows[i][j] = matrix(i, j);
+      }
+    }
+  }
+
+  /**
+   * @brief Access matrix element (mutable).
+   * @param row Row index, between 0 and 2.
+   * @param col Column index, 3 being the translation.
+   * @return Reference to the element.
+   */
+  double &operator()(std::size_t row, std::size_t col) noexcept {
+    return m_rows[row][col];
+  }
+
+  /**
+   * @brief Access matrix element (const).
+   * @param row Row index, between 0 and 2.
+   * @param col Column index, 3 being the translation.
+   * @return Value of the element.
+   */
+  double operator()(std::size_t row, std::size_t col) const noexcept {
+    return m_rows[row][col];
+  }
+
+  /**
+   * @brief Compose with another transformation.
+   * @param other Transformation applied before this one.
+   * @return Product of the two matrices.
+   */
+  [[nodiscard]] Affine operator*(const Affine &other) const noexcept {
+    Affine result;
+    for (std::size_t i = 0; i < 3; i++) {
+      for (std::size_t j = 0; j < 4; j++) {
+        double sum = m_rows[i][0] * other.m_rows[0][j] +
+                     m_rows[i][1] * other.m_rows[1][j] +
+                     m_rows[i][2] * other.m_rows[2][j];
+        result.m_rows[i][j] = j == 3 ? sum + m_rows[i][3] : sum;
+      }
+    }
+    return result;
+  }
+
+  /**
+   * @brief Calculate the determinant of the linear part.
+   * @return Determinant, also that of the full 4x4 matrix.
+   */
+  [[nodiscard]] double determinant() const noexcept {
+    return m_rows[0][0] * (m_rows[1][1] * m_rows[2][2] -
+                           m_rows[1][2] * m_rows[2][1]) -
+           m_rows[0][1] * (m_rows[1][0] * m_rows[2][2] -
+                           m_rows[1][2] * m_rows[2][0]) +
+           m_rows[0][2] * (m_rows[1][0] * m_rows[2][1] -
+                           m_rows[1][1] * m_rows[2][0]);
+  }
+
+  /**
+   * @brief Calculate the inverse transformation.
+   *
+   * The linear part is inverted through its adjugate and the translation
+   * becomes -A^-1 t. Like Matrix::inverse(), a singular matrix yields the
+   * identity.
+   * @return Inverse transformation.
+   */
+  [[nodiscard]] Affine inverse() const noexcept {
+    double det = determinant();
+    if (std::abs(det) < 1e-8) {
+      return Affine();
+    }
+    double invDet = 1.0 / det;
+    const auto &m = m_rows;
+
+    Affine result;
+    auto &r = result.m_rows;
+    r[0][0] = (m[1][1] * m[2][2] - m[1][2] * m[2][1]) * invDet;
+    r[0][1] = (m[0][2] * m[2][1] - m[0][1] * m[2][2]) * invDet;
+    r[0][2] = (m[0][1] * m[1][2] - m[0][2] * m[1][1]) * invDet;
+    r[1][0] = (m[1][2] * m[2][0] - m[1][0] * m[2][2]) * invDet;
+    r[1][1] = (m[0][0] * m[2][2] - m[0][2] * m[2][0]) * invDet;
+    r[1][2] = (m[0][2] * m[1][0] - m[0][0] * m[1][2]) * invDet;
+    r[2][0] = (m[1][0] * m[2][1] - m[1][1] * m[2][0]) * invDet;
+    r[2][1] = (m[0][1] * m[2][0] - m[0][0] * m[2][1]) * invDet;
+    r[2][2] = (m[0][0] * m[1][1] - m[0][1] * m[1][0]) * invDet;
+    for (std::size_t i = 0; i < 3; i++) {
+      r[i][3] = -(r[i][0] * m[0][3] + r[i][1] * m[1][3] + r[i][2] * m[2][3]);
+    }
+    return result;
+  }
+
+  /**
+   * @brief Get the transpose of the linear part.
+   *
+   * Applied to the inverse of a transformation, this gives the matrix that
+   * transforms its normals.
+   * @return Transposed 3x3 linear part.
+   */
+  [[nodiscard]] Matrix<3, 3> transposedLinear() const noexcept {
+    Matrix<3, 3> result;
+    for (std::size_t i = 0; i < 3; i++) {
+      for (std::size_t j = 0; j < 3; j++) {
+        result(i, j) = m_rows[j][i];
+      }
+    }
+    return result;
+  }
+
+  /**
+   * @brief Expand to a full 4x4 matrix.
+   * @return Matrix with (0, 0, 0, 1) as last row.
+   */
+  [[nodiscard]] Matrix4 toMatrix() const noexcept {
+    Matrix4 result = Matrix4::identity();
+    for (std::size_t i = 0; i < 3; i++) {
+      for (std::size_t j = 0; j < 4; j++) {
+        result(i, j) = m_rows[i][j];
+      }
+    }
+    return result;
+  }
+
+  /**
+   * @brief Transform a point.
+   * @param point Point to transform.
+   * @return Transformed point.
+   */
+  [[nodiscard]] Point<3> transformPoint(const Point<3> &point) const noexcept {
+    const auto &p = point.m_components;
+    return Point<3>(
+        m_rows[0][0] * p[0] + m_rows[0][1] * p[1] + m_rows[0][2] * p[2] +
+            m_rows[0][3],
+        m_rows[1][0] * p[0] + m_rows[1][1] * p[1] + m_rows[1][2] * p[2] +
+            m_rows[1][3],
+        m_rows[2][0] * p[0] + m_rows[2][1] * p[1] + m_rows[2][2] * p[2] +
+            m_rows[2][3]);
+  }
+
+  /**
+   * @brief Transform a vector, ignoring the translation.
+   * @param vector Vector to transform.
+   * @return Transformed vector.
+   */
+  [[nodiscard]] Vector<3>
+  transformVector(const Vector<3> &vector) const noexcept {
+    const auto &v = vector.m_components;
+    return Vector<3>(
+        m_rows[0][0] * v[0] + m_rows[0][1] * v[1] + m_rows[0][2] * v[2],
+        m_rows[1][0] * v[0] + m_rows[1][1] * v[1] + m_rows[1][2] * v[2],
+        m_rows[2][0] * v[0] + m_rows[2][1] * v[1] + m_rows[2][2] * v[2]);
+  }
+
+private:
+  std::array<std::array<double, 4>, 3> m_rows;
+};
+
+} // namespace Raytracer::Math
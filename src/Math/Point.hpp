@@ -16,21 +16,23 @@ namespace Raytracer::Math {
  * @brief A class template representing a mathematical point in N-dimensional
  * space.
  * @tparam N The dimension of the point.
+ * @tparam T The type of the coordinates (default: double).
  */
-template <std::size_t N> class Point {
+template <std::size_t N, typename T> class Point {
 public:
-  std::array<double, N> m_components;
+  std::array<T, N> m_components;
 
   /**
    * @brief Default constructor initializes all components to zero.
    */
-  Point() { m_components.fill(0.0); }
+  Point() { m_components.fill(T{}); }
 
   /**
    * @brief Constructor that initializes the point with the given components.
    * @param args The components of the point.
    */
-  template <typename... Args> Point(Args... args) : m_components{args...} {
+  template <typename... Args>
+  Point(Args... args) : m_components{static_cast<T>(args)...} {
     static_assert(sizeof...(args) == N,
                   "Number of arguments must match point dimension");
     setComponents(0, args...);
@@ -41,8 +43,8 @@ public:
    * @param other The point to subtract from this point.
    * @return A vector representing the difference between the two points.
    */
-  Vector<N> operator-(const Point<N> &other) const {
-    Vector<N> result;
+  Vector<N, T> operator-(const Point &other) const {
+    Vector<N, T> result;
     for (size_t i = 0; i < N; ++i) {
       result.m_components[i] = m_components[i] - other.m_components[i];
     }
@@ -59,8 +61,8 @@ public:
    * @param vec The vector to add.
    * @return A new point that is the sum of the point and the vector.
    */
-  Point<N> operator+(const Vector<N> &vec) const {
-    Point<N> result;
+  Point operator+(const Vector<N, T> &vec) const {
+    Point result;
     for (size_t i = 0; i < N; ++i) {
       result.m_components[i] = m_components[i] + vec.m_components[i];
     }
@@ -72,7 +74,7 @@ public:
    * @param vec The vector to add.
    * @return A reference to the current point after addition.
    */
-  Point<N> &operator+=(const Vector<N> &vec) {
+  Point &operator+=(const Vector<N, T> &vec) {
     for (size_t i = 0; i < N; ++i) {
       m_components[i] += vec.m_components[i];
     }
@@ -84,8 +86,8 @@ public:
    * @param vec The vector to subtract.
    * @return A new point that is the difference of the point and the vector.
    */
-  Point<N> operator-(const Vector<N> &vec) const {
-    Point<N> result;
+  Point operator-(const Vector<N, T> &vec) const {
+    Point result;
     for (size_t i = 0; i < N; ++i) {
       result.m_components[i] = m_components[i] - vec.m_components[i];
     }
@@ -97,7 +99,7 @@ public:
    * @param vec The vector to subtract.
    * @return A reference to the current point after subtraction.
    */
-  Point<N> &operator-=(const Vector<N> &vec) {
+  Point &operator-=(const Vector<N, T> &vec) {
     for (size_t i = 0; i < N; ++i) {
       m_components[i] -= vec.m_components[i];
     }
@@ -117,9 +119,9 @@ private:
    * @param value The value to set.
    * @param args The remaining components to set.
    */
-  template <typename T, typename... Args>
-  void setComponents(size_t index, T value, Args... args) {
-    m_components[index] = static_cast<double>(value);
+  template <typename U, typename... Args>
+  void setComponents(size_t index, U value, Args... args) {
+    m_components[index] = static_cast<T>(value);
     setComponents(index + 1, args...);
   }
 };
@@ -0,0 +1,517 @@
+/**
+ * @file Simd.hpp
+ * @brief Defines the four-lane types used by the wide math kernels.
+ */
+
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace Raytracer::Math::Simd {
+
+/**
+ * @class Double4
+ * @brief Four doubles processed together.
+ *
+ * Maps to one AVX register when the compiler targets AVX, to two SSE2
+ * registers on any other x86-64 build and to a plain array elsewhere. Every
+ * lane goes through the same operations in the same order as scalar code,
+ * so lane results are bit-identical to it.
+ *
+ * Comparisons return masks with every bit of a lane set when it holds;
+ * they combine with @c & and @c | and turn into one bit per lane with
+ * mask().
+ */
+class Double4 final {
+public:
+  /** Type of a lane. */
+  using Scalar = double;
+
+  /** Number of lanes. */
+  static constexpr std::size_t WIDTH = 4;
+
+  /**
+   * @brief Default constructor, every lane set to zero.
+   */
+  Double4() noexcept : Double4(0.0) {}
+
+  /**
+   * @brief Construct with the same value in every lane.
+   * @param value Value of the lanes.
+   */
+  Double4(double value) noexcept {
+#if defined(__AVX__)
+    m_value = _mm256_set1_pd(value);
+#elif defined(__SSE2__)
+    m_low = _mm_set1_pd(value);
+    m_high = m_low;
+#else
+    m_lanes.fill(value);
+#endif
+  }
+
+  /**
+   * @brief Load four consecutive doubles.
+   * @param source First value, no alignment required.
+   * @return Lanes holding source[0] to source[3].
+   */
+  [[nodiscard]] static Double4 load(const double *source) noexcept {
+    Double4 result;
+#if defined(__AVX__)
+    result.m_value = _mm256_loadu_pd(source);
+#elif defined(__SSE2__)
+    result.m_low = _mm_loadu_pd(source);
+    result.m_high = _mm_loadu_pd(source + 2);
+#else
+    for (std::size_t i = 0; i < WIDTH; ++i) {
+      result.m_lanes[i] = source[i];
+    }
+#endif
+    return result;
+  }
+
+  /**
+   * @brief Store the lanes to four consecutive doubles.
+   * @param destination First value, no alignment required.
+   */
+  void store(double *destination) const noexcept {
+#if defined(__AVX__)
+    _mm256_storeu_pd(destination, m_value);
+#elif defined(__SSE2__)
+    _mm_storeu_pd(destination, m_low);
+    _mm_storeu_pd(destination + 2, m_high);
+#else
+    for (std::size_t i = 0; i < WIDTH; ++i) {
+      destination[i] = m_lanes[i];
+    }
+#endif
+  }
+
+  /**
+   * @brief Get one lane.
+   * @param lane Index of the lane.
+   * @return Value of the lane.
+   */
+  [[nodiscard]] double operator[](std::size_t lane) const noexcept {
+    std::array<double, WIDTH> lanes;
+    store(lanes.data());
+    return lanes[lane];
+  }
+
+  /**
+   * @brief Get one bit per lane from a comparison mask.
+   * @return Bit @c i set when lane @c i of the mask is set.
+   */
+  [[nodiscard]] unsigned mask() const noexcept {
+#if defined(__AVX__)
+    return static_cast<unsigned>(_mm256_movemask_pd(m_value));
+#elif defined(__SSE2__)
+    return static_cast<unsigned>(_mm_movemask_pd(m_low) |
+                                 (_mm_movemask_pd(m_high) << 2));
+#else
+    unsigned bits = 0;
+    for (std::size_t i = 0; i < WIDTH; ++i) {
+      bits |= std::signbit(m_lanes[i]) ? 1u << i : 0u;
+    }
+    return bits;
+#endif
+  }
+
+  /**
+   * @brief Get the absolute value of every lane.
+   * @return Lanes without their sign.
+   */
+  [[nodiscard]] Double4 abs() const noexcept {
+#if defined(__AVX__) || defined(__SSE2__)
+    return andNot(Double4(-0.0), *this);
+#else
+    return map([](double a, double) { return std::abs(a); }, *this);
+#endif
+  }
+
+  /**
+   * @brief Get the square root of every lane.
+   * @return Square roots, NaN for negative lanes.
+   */
+  [[nodiscard]] Double4 sqrt() const noexcept {
+#if defined(__AVX__)
+    return fromRegister(_mm256_sqrt_pd(m_value));
+#elif defined(__SSE2__)
+    return fromRegisters(_mm_sqrt_pd(m_low), _mm_sqrt_pd(m_high));
+#else
+    return map([](double a, double) { return std::sqrt(a); }, *this);
+#endif
+  }
+
+  friend Double4 operator+(const Double4 &lhs, const Double4 &rhs) noexcept {
+#if defined(__AVX__)
+    return fromRegister(_mm256_add_pd(lhs.m_value, rhs.m_value));
+#elif defined(__SSE2__)
+    return fromRegisters(_mm_add_pd(lhs.m_low, rhs.m_low),
+                         _mm_add_pd(lhs.m_high, rhs.m_high));
+#else
+    return lhs.map([](double a, double b) { return a + b; }, rhs);
+#endif
+  }
+
+  friend Double4 operator-(const Double4 &lhs, const Double4 &rhs) noexcept {
+#if defined(__AVX__)
+    return fromRegister(_mm256_sub_pd(lhs.m_value, rhs.m_value));
+#elif defined(__SSE2__)
+    return fromRegisters(_mm_sub_pd(lhs.m_low, rhs.m_low),
+                         _mm_sub_pd(lhs.m_high, rhs.m_high));
+#else
+    return lhs.map([](double a, double b) { return a - b; }, rhs);
+#endif
+  }
+
+  friend Double4 operator*(const Double4 &lhs, const Double4 &rhs) noexcept {
+#if defined(__AVX__)
+    return fromRegister(_mm256_mul_pd(lhs.m_value, rhs.m_value));
+#elif defined(__SSE2__)
+    return fromRegisters(_mm_mul_pd(lhs.m_low, rhs.m_low),
+                         _mm_mul_pd(lhs.m_high, rhs.m_high));
+#else
+    return lhs.map([](double a, double b) { return a * b; }, rhs);
+#endif
+  }
+
+  friend Double4 operator/(const Double4 &lhs, const Double4 &rhs) noexcept {
+#if defined(__AVX__)
+    return fromRegister(_mm256_div_pd(lhs.m_value, rhs.m_value));
+#elif defined(__SSE2__)
+    return fromRegisters(_mm_div_pd(lhs.m_low, rhs.m_low),
+                         _mm_div_pd(lhs.m_high, rhs.m_high));
+#else
+    return lhs.map([](double a, double b) { return a / b; }, rhs);
+#endif
+  }
+
+  friend Double4 operator&(const Double4 &lhs, const Double4 &rhs) noexcept {
+#if defined(__AVX__)
+    return fromRegister(_mm256_and_pd(lhs.m_value, rhs.m_value));
+#elif defined(__SSE2__)
+    return fromRegisters(_mm_and_pd(lhs.m_low, rhs.m_low),
+                         _mm_and_pd(lhs.m_high, rhs.m_high));
+#else
+    return lhs.map([](double a, double b) { return maskOf(a < 0 && b < 0); },
+                   rhs);
+#endif
+  }
+
+  friend Double4 operator|(const Double4 &lhs, const Double4 &rhs) noexcept {
+#if defined(__AVX__)
+    return fromRegister(_mm256_or_pd(lhs.m_value, rhs.m_value));
+#elif defined(__SSE2__)
+    return fromRegisters(_mm_or_pd(lhs.m_low, rhs.m_low),
+                         _mm_or_pd(lhs.m_high, rhs.m_high));
+#else
+    return lhs.map([](double a, double b) { return maskOf(a < 0 || b < 0); },
+                   rhs);
+#endif
+  }
+
+  friend Double4 operator<(const Double4 &lhs, const Double4 &rhs) noexcept {
+#if defined(__AVX__)
+    return fromRegister(_mm256_cmp_pd(lhs.m_value, rhs.m_value, _CMP_LT_OQ));
+#elif defined(__SSE2__)
+    return fromRegisters(_mm_cmplt_pd(lhs.m_low, rhs.m_low),
+                         _mm_cmplt_pd(lhs.m_high, rhs.m_high));
+#else
+    return lhs.map([](double a, double b) { return maskOf(a < b); }, rhs);
+#endif
+  }
+
+  friend Double4 operator<=(const Double4 &lhs, const Double4 &rhs) noexcept {
+#if defined(__AVX__)
+    return fromRegister(_mm256_cmp_pd(lhs.m_value, rhs.m_value, _CMP_LE_OQ));
+#elif defined(__SSE2__)
+    return fromRegisters(_mm_cmple_pd(lhs.m_low, rhs.m_low),
+                         _mm_cmple_pd(lhs.m_high, rhs.m_high));
+#else
+    return lhs.map([](double a, double b) { return maskOf(a <= b); }, rhs);
+#endif
+  }
+
+  friend Double4 operator>(const Double4 &lhs, const Double4 &rhs) noexcept {
+    return rhs < lhs;
+  }
+
+  friend Double4 operator>=(const Double4 &lhs, const Double4 &rhs) noexcept {
+    return rhs <= lhs;
+  }
+
+private:
+#if defined(__AVX__)
+  __m256d m_value;
+
+  [[nodiscard]] static Double4 fromRegister(__m256d value) noexcept {
+    Double4 result(0.0);
+    result.m_value = value;
+    return result;
+  }
+
+  [[nodiscard]] static Double4 andNot(const Double4 &lhs,
+                                      const Double4 &rhs) noexcept {
+    return fromRegister(_mm256_andnot_pd(lhs.m_value, rhs.m_value));
+  }
+#elif defined(__SSE2__)
+  __m128d m_low;
+  __m128d m_high;
+
+  [[nodiscard]] static Double4 fromRegisters(__m128d low,
+                                             __m128d high) noexcept {
+    Double4 result(0.0);
+    result.m_low = low;
+    result.m_high = high;
+    return result;
+  }
+
+  [[nodiscard]] static Double4 andNot(const Double4 &lhs,
+                                      const Double4 &rhs) noexcept {
+    return fromRegisters(_mm_andnot_pd(lhs.m_low, rhs.m_low),
+                         _mm_andnot_pd(lhs.m_high, rhs.m_high));
+  }
+#else
+  std::array<double, WIDTH> m_lanes;
+
+  [[nodiscard]] static double maskOf(bool set) noexcept {
+    return set ? -1.0 : 0.0;
+  }
+
+  template <typename Op>
+  [[nodiscard]] Double4 map(Op op, const Double4 &other) const noexcept {
+    Double4 result(0.0);
+    for (std::size_t i = 0; i < WIDTH; ++i) {
+      result.m_lanes[i] = op(m_lanes[i], other.m_lanes[i]);
+    }
+    return result;
+  }
+#endif
+};
+
+/**
+ * @class Float4
+ * @brief Four floats processed together.
+ *
+ * Same interface as Double4 for single-precision data. The four lanes fit
+ * one SSE register, where Double4 needs two of them on SSE2 builds, and
+ * take half the memory.
+ */
+class Float4 final {
+public:
+  /** Type of a lane. */
+  using Scalar = float;
+
+  /** Number of lanes. */
+  static constexpr std::size_t WIDTH = 4;
+
+  /**
+   * @brief Default constructor, every lane set to zero.
+   */
+  Float4() noexcept : Float4(0.0f) {}
+
+  /**
+   * @brief Construct with the same value in every lane.
+   * @param value Value of the lanes.
+   */
+  Float4(float value) noexcept {
+#if defined(__SSE2__)
+    m_value = _mm_set1_ps(value);
+#else
+    m_lanes.fill(value);
+#endif
+  }
+
+  /**
+   * @brief Load four consecutive floats.
+   * @param source First value, no alignment required.
+   * @return Lanes holding source[0] to source[3].
+   */
+  [[nodiscard]] static Float4 load(const float *source) noexcept {
+    Float4 result;
+#if defined(__SSE2__)
+    result.m_value = _mm_loadu_ps(source);
+#else
+    for (std::size_t i = 0; i < WIDTH; ++i) {
+      result.m_lanes[i] = source[i];
+    }
+#endif
+    return result;
+  }
+
+  /**
+   * @brief Store the lanes to four consecutive floats.
+   * @param destination First value, no alignment required.
+   */
+  void store(float *destination) const noexcept {
+#if defined(__SSE2__)
+    _mm_storeu_ps(destination, m_value);
+#else
+    for (std::size_t i = 0; i < WIDTH; ++i) {
+      destination[i] = m_lanes[i];
+    }
+#endif
+  }
+
+  /**
+   * @brief Get one lane.
+   * @param lane Index of the lane.
+   * @return Value of the lane.
+   */
+  [[nodiscard]] float operator[](std::size_t lane) const noexcept {
+    std::array<float, WIDTH> lanes;
+    store(lanes.data());
+    return lanes[lane];
+  }
+
+  /**
+   * @brief Get one bit per lane from a comparison mask.
+   * @return Bit @c i set when lane @c i of the mask is set.
+   */
+  [[nodiscard]] unsigned mask() const noexcept {
+#if defined(__SSE2__)
+    return static_cast<unsigned>(_mm_movemask_ps(m_value));
+#else
+    unsigned bits = 0;
+    for (std::size_t i = 0; i < WIDTH; ++i) {
+      bits |= std::signbit(m_lanes[i]) ? 1u << i : 0u;
+    }
+    return bits;
+#endif
+  }
+
+  /**
+   * @brief Get the absolute value of every lane.
+   * @return Lanes without their sign.
+   */
+  [[nodiscard]] Float4 abs() const noexcept {
+#if defined(__SSE2__)
+    return fromRegister(_mm_andnot_ps(_mm_set1_ps(-0.0f), m_value));
+#else
+    return map([](float a, float) { return std::abs(a); }, *this);
+#endif
+  }
+
+  /**
+   * @brief Get the square root of every lane.
+   * @return Square roots, NaN for negative lanes.
+   */
+  [[nodiscard]] Float4 sqrt() const noexcept {
+#if defined(__SSE2__)
+    return fromRegister(_mm_sqrt_ps(m_value));
+#else
+    return map([](float a, float) { return std::sqrt(a); }, *this);
+#endif
+  }
+
+  friend Float4 operator+(const Float4 &lhs, const Float4 &rhs) noexcept {
+#if defined(__SSE2__)
+    return fromRegister(_mm_add_ps(lhs.m_value, rhs.m_value));
+#else
+    return lhs.map([](float a, float b) { return a + b; }, rhs);
+#endif
+  }
+
+  friend Float4 operator-(const Float4 &lhs, const Float4 &rhs) noexcept {
+#if defined(__SSE2__)
+    return fromRegister(_mm_sub_ps(lhs.m_value, rhs.m_value));
+#else
+    return lhs.map([](float a, float b) { return a - b; }, rhs);
+#endif
+  }
+
+  friend Float4 operator*(const Float4 &lhs, const Float4 &rhs) noexcept {
+#if defined(__SSE2__)
+    return fromRegister(_mm_mul_ps(lhs.m_value, rhs.m_value));
+#else
+    return lhs.map([](float a, float b) { return a * b; }, rhs);
+#endif
+  }
+
+  friend Float4 operator/(const Float4 &lhs, const Float4 &rhs) noexcept {
+#if defined(__SSE2__)
+    return fromRegister(_mm_div_ps(lhs.m_value, rhs.m_value));
+#else
+    return lhs.map([](float a, float b) { return a / b; }, rhs);
+#endif
+  }
+
+  friend Float4 operator&(const Float4 &lhs, const Float4 &rhs) noexcept {
+#if defined(__SSE2__)
+    return fromRegister(_mm_and_ps(lhs.m_value, rhs.m_value));
+#else
+    return lhs.map([](float a, float b) { return maskOf(a < 0 && b < 0); },
+                   rhs);
+#endif
+  }
+
+  friend Float4 operator|(const Float4 &lhs, const Float4 &rhs) noexcept {
+#if defined(__SSE2__)
+    return fromRegister(_mm_or_ps(lhs.m_value, rhs.m_value));
+#else
+    return lhs.map([](float a, float b) { return maskOf(a < 0 || b < 0); },
+                   rhs);
+#endif
+  }
+
+  friend Float4 operator<(const Float4 &lhs, const Float4 &rhs) noexcept {
+#if defined(__SSE2__)
+    return fromRegister(_mm_cmplt_ps(lhs.m_value, rhs.m_value));
+#else
+    return lhs.map([](float a, float b) { return maskOf(a < b); }, rhs);
+#endif
+  }
+
+  friend Float4 operator<=(const Float4 &lhs, const Float4 &rhs) noexcept {
+#if defined(__SSE2__)
+    return fromRegister(_mm_cmple_ps(lhs.m_value, rhs.m_value));
+#else
+    return lhs.map([](float a, float b) { return maskOf(a <= b); }, rhs);
+#endif
+  }
+
+  friend Float4 operator>(const Float4 &lhs, const Float4 &rhs) noexcept {
+    return rhs < lhs;
+  }
+
+  friend Float4 operator>=(const Float4 &lhs, const Float4 &rhs) noexcept {
+    return rhs <= lhs;
+  }
+
+private:
+#if defined(__SSE2__)
+  __m128 m_value;
+
+  [[nodiscard]] static Float4 fromRegister(__m128 value) noexcept {
+    Float4 result(0.0f);
+    result.m_value = value;
+    return result;
+  }
+#else
+  std::array<float, WIDTH> m_lanes;
+
+  [[nodiscard]] static float maskOf(bool set) noexcept {
+    return set ? -1.0f : 0.0f;
+  }
+
+  template <typename Op>
+  [[nodiscard]] Float4 map(Op op, const Float4 &other) const noexcept {
+    Float4 result(0.0f);
+    for (std::size_t i = 0; i < WIDTH; ++i) {
+      result.m_lanes[i] = op(m_lanes[i], other.m_lanes[i]);
+    }
+    return result;
+  }
+#endif
+};
+
+} // namespace Raytracer::Math::Simd
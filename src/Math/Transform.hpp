@@ -6,6 +6,7 @@
 
 #include "Core/BoundingBox.hpp"
 #include "Core/Ray.hpp"
+#include "Math/Affine.hpp"
 #include "Math/Matrix.hpp"
 #include "Math/Point.hpp"
 #include "Math/Vector.hpp"
@@ -15,29 +16,48 @@ namespace Raytracer::Math {
 /**
  * @class Transform
  * @brief Represents a spatial transformation with matrix and its inverse.
+ *
+ * Both matrices are affine 3x4 matrices, and the matrix that transforms
+ * normals, the transpose of the inverse's linear part, is cached next to
+ * them.
  */
 class Transform {
 public:
   /**
    * @brief Default constructor creates an identity transform.
    */
-  Transform() noexcept
-      : m_matrix(Matrix4::identity()), m_inverse(Matrix4::identity()) {}
+  Transform() noexcept : m_normal(Matrix<3, 3>::identity()) {}
 
   /**
-   * @brief Construct from a transformation matrix.
+   * @brief Construct from an affine matrix.
+   * @param matrix The transformation matrix.
+   */
+  explicit Transform(const Affine &matrix) noexcept
+      : Transform(matrix, matrix.inverse()) {}
+
+  /**
+   * @brief Construct from an affine matrix and its precomputed inverse.
    * @param matrix The transformation matrix.
+   * @param inverse The inverse transformation matrix.
+   */
+  Transform(const Affine &matrix, const Affine &inverse) noexcept
+      : m_matrix(matrix), m_inverse(inverse),
+        m_normal(inverse.transposedLinear()) {}
+
+  /**
+   * @brief Construct from a transformation matrix.
+   * @param matrix The transformation matrix, its last row is ignored.
    */
   explicit Transform(const Matrix4 &matrix) noexcept
-      : m_matrix(matrix), m_inverse(matrix.inverse()) {}
+      : Transform(Affine(matrix)) {}
 
   /**
    * @brief Construct from a transformation matrix and its precomputed inverse.
-   * @param matrix The transformation matrix.
+   * @param matrix The transformation matrix, its last row is ignored.
    * @param inverse The inverse transformation matrix.
    */
   Transform(const Matrix4 &matrix, const Matrix4 &inverse) noexcept
-      : m_matrix(matrix), m_inverse(inverse) {}
+      : Transform(Affine(matrix), Affine(inverse)) {}
 
   /**
    * @brief Create a translation transform.
@@ -47,12 +67,12 @@ public:
    * @return Translation transform.
    */
   static Transform translate(double tx, double ty, double tz) noexcept {
-    Matrix4 matrix = Matrix4::identity();
+    Affine matrix;
     matrix(0, 3) = tx;
     matrix(1, 3) = ty;
     matrix(2, 3) = tz;
 
-    Matrix4 inverse = Matrix4::identity();
+    Affine inverse;
     inverse(0, 3) = -tx;
     inverse(1, 3) = -ty;
     inverse(2, 3) = -tz;
@@ -78,13 +98,13 @@ public:
     double sin = std::sin(angle);
     double cos = std::cos(angle);
 
-    Matrix4 matrix = Matrix4::identity();
+    Affine matrix;
     matrix(1, 1) = cos;
     matrix(1, 2) = -sin;
     matrix(2, 1) = sin;
     matrix(2, 2) = cos;
 
-    Matrix4 inverse = Matrix4::identity();
+    Affine inverse;
     inverse(1, 1) = cos;
     inverse(1, 2) = sin;
     inverse(2, 1) = -sin;
@@ -101,13 +121,13 @@ public:
     double sin = std::sin(angle);
     double cos = std::cos(angle);
 
-    Matrix4 matrix = Matrix4::identity();
+    Affine matrix;
     matrix(0, 0) = cos;
     matrix(0, 2) = sin;
     matrix(2, 0) = -sin;
     matrix(2, 2) = cos;
 
-    Matrix4 inverse = Matrix4::identity();
+    Affine inverse;
     inverse(0, 0) = cos;
     inverse(0, 2) = -sin;
     inverse(2, 0) = sin;
@@ -124,13 +144,13 @@ public:
     double sin_t = std::sin(angle);
     double cos_t = std::cos(angle);
 
-    Matrix4 matrix = Matrix4::identity();
+    Affine matrix;
     matrix(0, 0) = cos_t;
     matrix(0, 1) = -sin_t;
     matrix(1, 0) = sin_t;
     matrix(1, 1) = cos_t;
 
-    Matrix4 inverse = Matrix4::identity();
+    Affine inverse;
     inverse(0, 0) = cos_t;
     inverse(0, 1) = sin_t;
     inverse(1, 0) = -sin_t;
@@ -161,7 +181,7 @@ public:
    */
   static Transform shear(double xy, double xz, double yx, double yz, double zx,
                          double zy) noexcept {
-    Matrix4 matrix = Matrix4::identity();
+    Affine matrix;
     matrix(0, 1) = xy;
     matrix(0, 2) = xz;
     matrix(1, 0) = yx;
@@ -212,12 +232,12 @@ public:
    * @return Scale transform.
    */
   static Transform scale(double sx, double sy, double sz) noexcept {
-    Matrix4 matrix = Matrix4::identity();
+    Affine matrix;
     matrix(0, 0) = sx;
     matrix(1, 1) = sy;
     matrix(2, 2) = sz;
 
-    Matrix4 inverse = Matrix4::identity();
+    Affine inverse;
     inverse(0, 0) = 1.0 / sx;
     inverse(1, 1) = 1.0 / sy;
     inverse(2, 2) = 1.0 / sz;
@@ -238,13 +258,13 @@ public:
    * @brief Get the transformation matrix.
    * @return The transformation matrix.
    */
-  [[nodiscard]] const Matrix4 &getMatrix() const noexcept { return m_matrix; }
+  [[nodiscard]] const Affine &getMatrix() const noexcept { return m_matrix; }
 
   /**
    * @brief Get the inverse transformation matrix.
    * @return The inverse transformation matrix.
    */
-  [[nodiscard]] const Matrix4 &getInverse() const noexcept { return m_inverse; }
+  [[nodiscard]] const Affine &getInverse() const noexcept { return m_inverse; }
 
   /**
    * @brief Get the inverse transform.
@@ -260,8 +280,7 @@ public:
    * @return Combined transform.
    */
   [[nodiscard]] Transform combine(const Transform &other) const noexcept {
-    return Transform(m_matrix.multiply(other.m_matrix),
-                     other.m_inverse.multiply(m_inverse));
+    return Transform(m_matrix * other.m_matrix, other.m_inverse * m_inverse);
   }
 
   /**
@@ -279,7 +298,7 @@ public:
    * @return Transformed point.
    */
   [[nodiscard]] Point<3> transformPoint(const Point<3> &point) const noexcept {
-    return Math::transformPoint(m_matrix, point);
+    return m_matrix.transformPoint(point);
   }
 
   /**
@@ -289,7 +308,7 @@ public:
    */
   [[nodiscard]] Vector<3>
   transformVector(const Vector<3> &vector) const noexcept {
-    return Math::transformVector(m_matrix, vector);
+    return m_matrix.transformVector(vector);
   }
 
   /**
@@ -299,7 +318,14 @@ public:
    */
   [[nodiscard]] Vector<3>
   transformNormal(const Vector<3> &normal) const noexcept {
-    return Math::transformNormal(m_inverse, normal).normalize();
+    const auto &n = normal.m_components;
+    return Vector<3>(m_normal(0, 0) * n[0] + m_normal(0, 1) * n[1] +
+                         m_normal(0, 2) * n[2],
+                     m_normal(1, 0) * n[0] + m_normal(1, 1) * n[1] +
+                         m_normal(1, 2) * n[2],
+                     m_normal(2, 0) * n[0] + m_normal(2, 1) * n[1] +
+                         m_normal(2, 2) * n[2])
+        .normalize();
   }
 
   /**
@@ -321,8 +347,8 @@ public:
    */
   [[nodiscard]] Core::Ray
   inverseTransformRay(const Core::Ray &ray) const noexcept {
-    Point<3> origin = Math::transformPoint(m_inverse, ray.getOrigin());
-    Vector<3> direction = Math::transformVector(m_inverse, ray.getDirection());
+    Point<3> origin = m_inverse.transformPoint(ray.getOrigin());
+    Vector<3> direction = m_inverse.transformVector(ray.getDirection());
     return Core::Ray(origin, direction, ray.getMinDistance(),
                      ray.getMaxDistance());
   }
@@ -369,8 +395,9 @@ public:
   }
 
 private:
-  Matrix4 m_matrix;
-  Matrix4 m_inverse;
+  Affine m_matrix;
+  Affine m_inverse;
+  Matrix<3, 3> m_normal;
 };
 
 } // namespace Raytracer::Math
\ No newline at end of file
@@ -0,0 +1,112 @@
+/**
+ * @file Vector3x4.hpp
+ * @brief Defines the types holding four 3D vectors in SIMD lanes.
+ */
+
+#pragma once
+
+#include "Math/Point.hpp"
+#include "Math/Simd.hpp"
+#include "Math/Vector.hpp"
+
+namespace Raytracer::Math::Simd {
+
+/**
+ * @struct BasicVector3x4
+ * @brief Four 3D vectors stored one axis per group of lanes.
+ * @tparam Lanes Four-lane type holding one axis, Double4 or Float4.
+ *
+ * Offers the arithmetic of Vector<3> lane by lane, with the same operation
+ * order, so kernels written against Vector<3> translate line for line and
+ * handle four primitives or rays per call.
+ */
+template <typename Lanes> struct BasicVector3x4 {
+  /** Type of a component. */
+  using Scalar = typename Lanes::Scalar;
+
+  Lanes x;
+  Lanes y;
+  Lanes z;
+
+  /**
+   * @brief Default constructor, every vector set to zero.
+   */
+  BasicVector3x4() noexcept = default;
+
+  /**
+   * @brief Construct from one group of lanes per axis.
+   * @param xs X components.
+   * @param ys Y components.
+   * @param zs Z components.
+   */
+  BasicVector3x4(const Lanes &xs, const Lanes &ys, const Lanes &zs) noexcept
+      : x(xs), y(ys), z(zs) {}
+
+  /**
+   * @brief Construct with the same vector in every lane.
+   * @param vector Vector to broadcast, rounded to the lane type.
+   */
+  explicit BasicVector3x4(const Vector<3> &vector) noexcept
+      : x(static_cast<Scalar>(vector.m_components[0])),
+        y(static_cast<Scalar>(vector.m_components[1])),
+        z(static_cast<Scalar>(vector.m_components[2])) {}
+
+  /**
+   * @brief Construct with the coordinates of a point in every lane.
+   * @param point Point to broadcast, rounded to the lane type.
+   */
+  explicit BasicVector3x4(const Point<3> &point) noexcept
+      : x(static_cast<Scalar>(point.m_components[0])),
+        y(static_cast<Scalar>(point.m_components[1])),
+        z(static_cast<Scalar>(point.m_components[2])) {}
+
+  /**
+   * @brief Load four vectors from per-axis arrays.
+   * @param xs First of four X components.
+   * @param ys First of four Y components.
+   * @param zs First of four Z components.
+   * @return Vectors built from xs[i], ys[i] and zs[i].
+   */
+  [[nodiscard]] static BasicVector3x4 load(const Scalar *xs, const Scalar *ys,
+                                           const Scalar *zs) noexcept {
+    return {Lanes::load(xs), Lanes::load(ys), Lanes::load(zs)};
+  }
+
+  /**
+   * @brief Subtract two vectors lane by lane.
+   * @param other Vectors to subtract.
+   * @return Differences.
+   */
+  [[nodiscard]] BasicVector3x4
+  operator-(const BasicVector3x4 &other) const noexcept {
+    return {x - other.x, y - other.y, z - other.z};
+  }
+
+  /**
+   * @brief Calculate the dot products lane by lane.
+   * @param other Vectors to multiply with.
+   * @return Dot product of each lane.
+   */
+  [[nodiscard]] Lanes dot(const BasicVector3x4 &other) const noexcept {
+    return x * other.x + y * other.y + z * other.z;
+  }
+
+  /**
+   * @brief Calculate the cross products lane by lane.
+   * @param other Vectors to multiply with.
+   * @return Cross product of each lane.
+   */
+  [[nodiscard]] BasicVector3x4
+  cross(const BasicVector3x4 &other) const noexcept {
+    return {y * other.z - z * other.y, z * other.x - x * other.z,
+            x * other.y - y * other.x};
+  }
+};
+
+/** Four double-precision 3D vectors. */
+using Vector3x4 = BasicVector3x4<Double4>;
+
+/** Four single-precision 3D vectors. */
+using Vector3x4f = BasicVector3x4<Float4>;
+
+} // namespace Raytracer::Math::Simd
@@ -17,7 +17,17 @@ SceneParser::parseFile(const std::string &filename) {
       builder.buildChildScenes(m_config.lookup("childScenes"));
     }
 
-    return builder.getResult();
+    if (m_config.exists("pathTermination")) {
+      builder.buildPathTermination(m_config.lookup("pathTermination"));
+    }
+
+    if (m_config.exists("lightSampling")) {
+      builder.buildLightSampling(m_config.lookup("lightSampling"));
+    }
+
+    auto scene = builder.getResult();
+    scene->compile();
+    return scene;
   } catch (const libconfig::FileIOException &) {
     return std::nullopt;
   } catch (const libconfig::ParseException &) {
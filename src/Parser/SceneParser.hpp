@@ -188,6 +188,53 @@ public:
     }
   }
 
+  /**
+   * @brief Parse a placement transform from the configuration.
+   *
+   * Reads the same position, rotation (in degrees) and scale settings as
+   * applyTransformations(), composed in the same order as primitives.
+   * @param config The libconfig setting to parse.
+   * @return The composed transform, identity for missing settings.
+   */
+  static Math::Transform parseTransform(const libconfig::Setting &config) {
+    Math::Transform translation;
+    Math::Transform rotation;
+    Math::Transform scale;
+
+    try {
+      auto position = parsePoint3(config.lookup("position"));
+      if (position) {
+        translation = Math::Transform::translate(position->m_components[0],
+                                                 position->m_components[1],
+                                                 position->m_components[2]);
+      }
+    } catch (const libconfig::SettingNotFoundException &) {
+    }
+
+    try {
+      auto angles = parsePoint3(config.lookup("rotation"));
+      if (angles) {
+        rotation = Math::Transform::rotate(
+            angles->m_components[0] * M_PI / 180.0,
+            angles->m_components[1] * M_PI / 180.0,
+            angles->m_components[2] * M_PI / 180.0);
+      }
+    } catch (const libconfig::SettingNotFoundException &) {
+    }
+
+    try {
+      auto factors = parsePoint3(config.lookup("scale"));
+      if (factors) {
+        scale = Math::Transform::scale(factors->m_components[0],
+                                       factors->m_components[1],
+                                       factors->m_components[2]);
+      }
+    } catch (const libconfig::SettingNotFoundException &) {
+    }
+
+    return translation * rotation * scale;
+  }
+
 private:
   libconfig::Config m_config;
 };
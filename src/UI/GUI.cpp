@@ -1,17 +1,31 @@
 #include "UI/GUI.hpp"
 #include "Core/Camera.hpp"
 #include "Parser/SceneParser.hpp"
+#include <chrono>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
 
 using namespace Raytracer::UI;
 
+namespace {
+/**
+ * @brief Check whether a render job has finished without blocking.
+ * @param job Job to check, may be empty.
+ * @return true if the job holds a result.
+ */
+bool isFinished(const std::future<void> &job) {
+  return job.valid() && job.wait_for(std::chrono::seconds(0)) ==
+                            std::future_status::ready;
+}
+} // namespace
+
 GUI::GUI(const std::string &title, const sf::Vector2u &size,
          const std::string &sceneFile)
     : m_window({size.x, size.y}, title), m_renderer(size.x, size.y),
       m_previewRenderer(size.x / 2, size.y / 2), m_sceneFile(sceneFile) {
   m_window.setFramerateLimit(60);
+  m_previewRenderer.setProgressive(true, PREVIEW_MAX_PASSES);
 
   m_previewTexture.create(size.x, size.y);
   m_previewTexture.create(size.x, size.y);
@@ -67,13 +81,11 @@ GUI::GUI(const std::string &title, const sf::Vector2u &size,
       auto currentWriteTime = std::filesystem::last_write_time(m_sceneFile);
       if (currentWriteTime != m_lastConfigWriteTime) {
         m_lastConfigWriteTime = currentWriteTime;
-        m_cancelRequested.store(true, std::memory_order_relaxed);
-
-        if (m_renderThread.joinable())
-          m_renderThread.join();
+        stopRender();
+        stopPreview();
 
-        m_rendering = false;
         m_btnRender->setText("Render");
+        m_btnPreview->setText("Preview");
         m_pixelBuffer.assign(m_renderer.getWidth() * m_renderer.getHeight() * 4,
                              0);
         m_previewBuffer.assign(m_previewRenderer.getWidth() *
@@ -90,13 +102,15 @@ GUI::GUI(const std::string &title, const sf::Vector2u &size,
     } catch (const std::filesystem::filesystem_error &) {
     }
 
-    if (!m_rendering && m_renderThread.joinable()) {
-      m_renderThread.join();
+    if (m_rendering && isFinished(m_renderJob)) {
+      m_renderJob.get();
+      m_rendering = false;
       m_btnRender->setText("Render");
     }
 
-    if (!m_previewRendering && m_previewThread.joinable()) {
-      m_previewThread.join();
+    if (m_previewRendering && isFinished(m_previewJob)) {
+      m_previewJob.get();
+      m_previewRendering = false;
       m_btnPreview->setText("Preview");
     }
 
@@ -151,6 +165,7 @@ GUI::GUI(const std::string &title, const sf::Vector2u &size,
           break;
         }
         if (moved) {
+          stopPreview();
           camera.setOrigin(origin);
           double aspect =
               double(m_renderer.getWidth()) / double(m_renderer.getHeight());
@@ -189,10 +204,8 @@ GUI::GUI(const std::string &title, const sf::Vector2u &size,
     }
 
     if (m_previewRendering) {
-      size_t done = m_previewRowsDone.load(std::memory_order_relaxed);
-      size_t total = m_previewRenderer.getHeight();
-      int progress = int(double(done) * 100.0 / double(total));
-      m_btnPreview->setText("Stop (" + std::to_string(progress) + "%)");
+      size_t passes = m_previewPassesDone.load(std::memory_order_relaxed);
+      m_btnPreview->setText("Stop (pass " + std::to_string(passes + 1) + ")");
     }
 
     m_btnPreview->draw(m_window);
@@ -218,9 +231,8 @@ GUI::GUI(const std::string &title, const sf::Vector2u &size,
 }
 
 GUI::~GUI() {
-  m_cancelRequested.store(true);
-  if (m_renderThread.joinable())
-    m_renderThread.join();
+  stopRender();
+  stopPreview();
   m_window.close();
 }
 
@@ -237,62 +249,40 @@ bool GUI::loadScene(const std::string &fn) {
 void GUI::onPreviewButton() {
   if (!m_previewRendering) {
     if (!m_pixelBuffer.empty()) {
+      stopRender();
       m_pixelBuffer.clear();
       m_btnRender->setText("Render");
     }
-    if (m_previewThread.joinable())
-      m_previewThread.join();
-
-    m_previewCancelRequested.store(false, std::memory_order_relaxed);
-    m_previewRowsDone.store(0, std::memory_order_relaxed);
-    m_previewRendering = true;
-    m_btnPreview->setText("Stop (0%)");
-
-    size_t w = m_previewRenderer.getWidth();
-    size_t h = m_previewRenderer.getHeight();
-    m_previewBuffer.assign(w * h * 4, 0);
-    m_previewThread = std::thread([this]() {
-      m_previewRenderer.renderToBuffer(*m_scene, m_previewBuffer,
-                                       &m_previewCancelRequested,
-                                       &m_previewRowsDone);
-      m_previewRendering = false;
-    });
+    restartPreview();
   } else {
-    m_previewCancelRequested.store(true, std::memory_order_relaxed);
-    if (m_previewThread.joinable())
-      m_previewThread.join();
-
-    m_previewRendering = false;
+    stopPreview();
     m_btnPreview->setText("Preview");
   }
 }
 
 void GUI::onRenderButton() {
   if (!m_rendering) {
+    stopRender();
     if (!m_pixelBuffer.empty()) {
       m_pixelBuffer.clear();
       m_btnPreview->setText("Preview");
     }
-    if (m_renderThread.joinable())
-      m_renderThread.join();
 
-    m_cancelRequested.store(false, std::memory_order_relaxed);
+    m_renderToken = Core::CancellationToken();
     m_rowsDone.store(0, std::memory_order_relaxed);
     m_rendering = true;
     m_btnRender->setText("Stop (0%)");
 
     m_pixelBuffer.assign(m_renderer.getWidth() * m_renderer.getHeight() * 4, 0);
-    m_renderThread = std::thread([this]() {
-      m_renderer.renderToBuffer(*m_scene, m_pixelBuffer, &m_cancelRequested,
-                                &m_rowsDone);
-      m_rendering = false;
-    });
+    Core::CancellationToken token = m_renderToken;
+    m_renderJob = Core::RenderThreadPool::getInstance().submit(
+        [this, token]() {
+          m_renderer.renderToBuffer(*m_scene, m_pixelBuffer, token.getFlag(),
+                                    &m_rowsDone);
+        },
+        token);
   } else {
-    m_cancelRequested.store(true, std::memory_order_relaxed);
-    if (m_renderThread.joinable())
-      m_renderThread.join();
-
-    m_rendering = false;
+    stopRender();
     m_btnRender->setText("Render");
   }
 }
@@ -336,26 +326,42 @@ void GUI::onToggleMultiThreading() {
 }
 
 void GUI::restartPreview() {
-  if (m_previewRendering) {
-    m_previewCancelRequested.store(true, std::memory_order_relaxed);
-    if (m_previewThread.joinable())
-      m_previewThread.join();
-    m_previewRendering = false;
-  }
+  stopPreview();
 
-  m_previewCancelRequested.store(false, std::memory_order_relaxed);
+  m_previewToken = Core::CancellationToken();
   m_previewRowsDone.store(0, std::memory_order_relaxed);
+  m_previewPassesDone.store(0, std::memory_order_relaxed);
   m_previewRendering = true;
-  m_btnPreview->setText("Stop (0%)");
+  m_btnPreview->setText("Stop (pass 1)");
 
   size_t width = m_previewRenderer.getWidth();
   size_t height = m_previewRenderer.getHeight();
   m_previewBuffer.assign(width * height * 4, 0);
 
-  m_previewThread = std::thread([this]() {
-    m_previewRenderer.renderToBuffer(*m_scene, m_previewBuffer,
-                                     &m_previewCancelRequested,
-                                     &m_previewRowsDone);
-    m_previewRendering = false;
-  });
+  Core::CancellationToken token = m_previewToken;
+  m_previewJob = Core::RenderThreadPool::getInstance().submit(
+      [this, token]() {
+        m_previewRenderer.renderToBuffer(*m_scene, m_previewBuffer,
+                                         token.getFlag(), &m_previewRowsDone,
+                                         &m_previewPassesDone);
+      },
+      token);
+}
+
+void GUI::stopRender() {
+  m_renderToken.cancel();
+  if (m_renderJob.valid()) {
+    m_renderJob.wait();
+    m_renderJob = std::future<void>();
+  }
+  m_rendering = false;
+}
+
+void GUI::stopPreview() {
+  m_previewToken.cancel();
+  if (m_previewJob.valid()) {
+    m_previewJob.wait();
+    m_previewJob = std::future<void>();
+  }
+  m_previewRendering = false;
 }
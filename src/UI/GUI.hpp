@@ -1,11 +1,12 @@
 #pragma once
 
+#include "Core/RenderThreadPool.hpp"
 #include "Core/Renderer.hpp"
 #include "Core/Scene.hpp"
 #include "UI/Button.hpp"
 #include <SFML/Graphics.hpp>
 #include <filesystem>
-#include <thread>
+#include <future>
 
 namespace Raytracer::UI {
 /**
@@ -66,8 +67,19 @@ private:
    */
   void restartPreview();
 
+  /**
+   * @brief Cancel the full-size render and wait for its job to stop.
+   */
+  void stopRender();
+
+  /**
+   * @brief Cancel the preview render and wait for its job to stop.
+   */
+  void stopPreview();
+
 private:
   static constexpr float CAMERA_MOVE_STEP = 2.0f;
+  static constexpr std::size_t PREVIEW_MAX_PASSES = 256;
 
   sf::RenderWindow m_window;
   Core::Renderer m_renderer;
@@ -80,17 +92,18 @@ private:
   std::unique_ptr<Button> m_btnToggleAASS;
   std::unique_ptr<Button> m_btnToggleMultiThreading;
 
-  std::atomic<bool> m_cancelRequested{false};
+  Core::CancellationToken m_renderToken;
   std::atomic<size_t> m_rowsDone{0};
   bool m_rendering = false;
-  std::thread m_renderThread;
+  std::future<void> m_renderJob;
   std::vector<uint8_t> m_pixelBuffer;
   sf::Texture m_previewTexture;
 
-  std::atomic<bool> m_previewCancelRequested{false};
+  Core::CancellationToken m_previewToken;
   std::atomic<size_t> m_previewRowsDone{0};
+  std::atomic<size_t> m_previewPassesDone{0};
   bool m_previewRendering = false;
-  std::thread m_previewThread;
+  std::future<void> m_previewJob;
   std::vector<uint8_t> m_previewBuffer;
   sf::Texture m_previewTextureLowRes;
 
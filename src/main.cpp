@@ -7,9 +7,13 @@
 #include "Parser/SceneParser.hpp"
 #include "Plugin/PluginManager.hpp"
 #include "UI/GUI.hpp"
+#include <charconv>
+#include <chrono>
 #include <iostream>
+#include <limits>
 #include <memory>
 #include <optional>
+#include <string>
 #include <string_view>
 
 /**
@@ -22,11 +26,40 @@ void printUsage(const std::string_view programName) {
             << "OPTIONS:\n"
             << "\t-d: enable debug mode\n"
             << "\t-m: disable multithreading (enabled by default)\n"
+            << "\t--threads <N>: number of render threads, at most one "
+               "more than the render pool has (default: all hardware "
+               "threads)\n"
+            << "\t--pin: pin each render thread to its own CPU\n"
+            << "\t--budget <MS>: render the best image possible in MS "
+               "milliseconds\n"
             << "\t-o <FILENAME>: specify output file (default: output.ppm)\n"
             << "\t-g: enable interactive gui mode\n"
+            << "\t--tile-size <PIXELS>: side of render tiles (default: 16)\n"
+            << "\t--tile-order <scanline|morton|center>: tile render order "
+               "(default: scanline)\n"
+            << "\t--wavefront: trace each tile breadth-first, one batch of "
+               "rays per bounce\n"
+            << "\t--sort-rays: with --wavefront, sort secondary rays by "
+               "direction and origin before tracing them\n"
             << "\t-h, --help: show this help message\n";
 }
 
+/**
+ * @brief Parse a strictly positive integer option value.
+ * @param text Argument to parse.
+ * @return The value, or std::nullopt if the argument is not made only of
+ * digits or is zero.
+ */
+std::optional<std::size_t> parsePositive(const std::string_view text) {
+  std::size_t value = 0;
+  const char *end = text.data() + text.size();
+  auto [ptr, error] = std::from_chars(text.data(), end, value);
+  if (error != std::errc() || ptr != end || value == 0) {
+    return std::nullopt;
+  }
+  return value;
+}
+
 /**
  * @brief Main function for the raytracer application.
  * @param argc Number of command-line arguments.
@@ -52,6 +85,13 @@ int main(int argc, char *argv[]) {
   [[maybe_unused]] bool useMultithreading = true;
   [[maybe_unused]] std::string outputFile = "output.ppm";
   [[maybe_unused]] bool guiMode = false;
+  unsigned int threadCount = 0;
+  bool pinThreads = false;
+  bool wavefront = false;
+  bool sortRays = false;
+  std::chrono::milliseconds timeBudget{0};
+  std::size_t tileSize = 16;
+  Raytracer::Core::TileOrder tileOrder = Raytracer::Core::TileOrder::Scanline;
 
   for (int i = 2; i < argc; i++) {
     const std::string_view arg = argv[i];
@@ -63,6 +103,42 @@ int main(int argc, char *argv[]) {
       outputFile = argv[++i];
     } else if (arg == "-g") {
       guiMode = true;
+    } else if (arg == "--threads" && i + 1 < argc) {
+      auto count = parsePositive(argv[++i]);
+      if (!count || *count > std::numeric_limits<unsigned int>::max()) {
+        printUsage(programName);
+        return 84;
+      }
+      threadCount = static_cast<unsigned int>(*count);
+    } else if (arg == "--budget" && i + 1 < argc) {
+      auto budget = parsePositive(argv[++i]);
+      if (!budget ||
+          *budget > static_cast<std::size_t>(
+                        std::chrono::milliseconds::max().count())) {
+        printUsage(programName);
+        return 84;
+      }
+      timeBudget = std::chrono::milliseconds(*budget);
+    } else if (arg == "--pin") {
+      pinThreads = true;
+    } else if (arg == "--wavefront") {
+      wavefront = true;
+    } else if (arg == "--sort-rays") {
+      sortRays = true;
+    } else if (arg == "--tile-size" && i + 1 < argc) {
+      auto size = parsePositive(argv[++i]);
+      if (!size) {
+        printUsage(programName);
+        return 84;
+      }
+      tileSize = *size;
+    } else if (arg == "--tile-order" && i + 1 < argc) {
+      auto order = Raytracer::Core::TileScheduler::parseOrder(argv[++i]);
+      if (!order) {
+        printUsage(programName);
+        return 84;
+      }
+      tileOrder = *order;
     } else {
       printUsage(programName);
       return 84;
@@ -85,7 +161,40 @@ int main(int argc, char *argv[]) {
 
       Raytracer::Core::Renderer renderer(1920, 1080);
       renderer.setMultithreading(useMultithreading);
+      const unsigned int maxThreads =
+          Raytracer::Core::Renderer::getMaxThreadCount();
+      if (useMultithreading && threadCount > maxThreads) {
+        std::cerr << "Warning: --threads " << threadCount
+                  << " is more than the render pool can run, using "
+                  << maxThreads << "\n";
+      }
+      renderer.setThreadCount(threadCount);
+      renderer.setThreadPinning(pinThreads);
+      renderer.setWavefront(wavefront);
+      renderer.setRaySorting(sortRays);
+      renderer.setTimeBudget(timeBudget);
+      renderer.setTileSize(tileSize);
+      renderer.setTileOrder(tileOrder);
       renderer.render(*scene.value(), outputFile);
+
+      if (debug) {
+        if (timeBudget.count() > 0) {
+          std::cout << "Budget: " << renderer.getLastPassCount()
+                    << " passes completed\n";
+        }
+        const auto &stats = renderer.getLastRenderStats();
+        for (std::size_t i = 0; i < stats.size(); ++i) {
+          std::cout << "Thread " << i << ": " << stats[i].busySeconds
+                    << "s busy, " << stats[i].tiles << " tiles ("
+                    << stats[i].stolenTiles << " stolen)\n";
+        }
+        const auto occluders =
+            Raytracer::Core::Scene::getOccluderCacheStats();
+        if (occluders.lookups > 0) {
+          std::cout << "Shadow occluder cache: " << occluders.hits << "/"
+                    << occluders.lookups << " hits\n";
+        }
+      }
     }
   } catch (const std::exception &e) {
     std::cerr << "Error: " << e.what() << "\n";
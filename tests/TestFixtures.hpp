@@ -0,0 +1,98 @@
+/**
+ * @file TestFixtures.hpp
+ * @brief Primitives and lights shared by the unit tests.
+ */
+
+#pragma once
+
+#include "../src/Core/ALight.hpp"
+#include "../src/Core/APrimitive.hpp"
+#include "../src/Core/BoundingBox.hpp"
+#include "../src/Core/HitRecord.hpp"
+#include "../src/Core/Intersection.hpp"
+#include "../src/Core/Ray.hpp"
+#include "../src/Math/Point.hpp"
+#include "../src/Math/Vector.hpp"
+#include <cmath>
+#include <optional>
+
+namespace Raytracer::Tests {
+
+/**
+ * @class TestSphere
+ * @brief Analytic sphere that counts how often each query reaches it.
+ */
+class TestSphere : public Core::APrimitive {
+public:
+  TestSphere(const Math::Point<3> &center, double radius)
+      : m_center(center), m_radius(radius) {}
+
+  [[nodiscard]] std::optional<Core::Intersection>
+  intersect(const Core::Ray &ray) const noexcept override {
+    ++intersectCalls;
+    Math::Vector<3> oc = ray.getOrigin() - m_center;
+    double a = ray.getDirection().dot(ray.getDirection());
+    double b = 2.0 * oc.dot(ray.getDirection());
+    double c = oc.dot(oc) - m_radius * m_radius;
+    double delta = b * b - 4.0 * a * c;
+    if (delta < 0.0) {
+      return std::nullopt;
+    }
+    double t = (-b - std::sqrt(delta)) / (2.0 * a);
+    if (t < ray.getMinDistance()) {
+      t = (-b + std::sqrt(delta)) / (2.0 * a);
+    }
+    if (t < ray.getMinDistance() || t > ray.getMaxDistance()) {
+      return std::nullopt;
+    }
+    Math::Point<3> point = ray.at(t);
+    Math::Vector<3> normal = (point - m_center) / m_radius;
+    return Core::Intersection(point, normal, getMaterial().get(),
+                              (point - ray.getOrigin()).length(), false,
+                              Math::Point<2>(0.0, 0.0));
+  }
+
+  [[nodiscard]] Core::BoundingBox getBoundingBox() const noexcept override {
+    Math::Vector<3> extent(m_radius, m_radius, m_radius);
+    return Core::BoundingBox(m_center - extent, m_center + extent);
+  }
+
+  [[nodiscard]] bool occluded(const Core::Ray &ray) const noexcept override {
+    ++occludedCalls;
+    return APrimitive::occluded(ray);
+  }
+
+  [[nodiscard]] Core::Intersection
+  computeIntersection(const Core::Ray &ray,
+                      const Core::HitRecord &hit) const noexcept override {
+    ++shadeCalls;
+    return APrimitive::computeIntersection(ray, hit);
+  }
+
+  mutable int intersectCalls{0};
+  mutable int occludedCalls{0};
+  mutable int shadeCalls{0};
+
+private:
+  Math::Point<3> m_center;
+  double m_radius;
+};
+
+/**
+ * @class TestPointLight
+ * @brief Shadow-casting point light that fully lights every point.
+ */
+class TestPointLight : public Core::APositionalLight {
+public:
+  using Core::APositionalLight::APositionalLight;
+
+  [[nodiscard]] double
+  computeIllumination(const Math::Point<3> &, const Math::Vector<3> &,
+                      const Core::Scene &) const noexcept override {
+    return 1.0;
+  }
+
+  [[nodiscard]] bool castsShadow() const noexcept override { return true; }
+};
+
+} // namespace Raytracer::Tests
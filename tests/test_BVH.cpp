@@ -0,0 +1,483 @@
+/**
+ * @file test_BVH.cpp
+ * @brief Unit tests for the BVH class and BVH-accelerated scene queries.
+ */
+
+#include "../src/Core/ALight.hpp"
+#include "../src/Core/APrimitive.hpp"
+#include "../src/Core/BVH.hpp"
+#include "../src/Core/BoundingBox.hpp"
+#include "../src/Core/HitRecord.hpp"
+#include "../src/Core/Intersection.hpp"
+#include "../src/Core/Ray.hpp"
+#include "../src/Core/Scene.hpp"
+#include "../src/Math/Point.hpp"
+#include "../src/Math/Transform.hpp"
+#include "../src/Math/Vector.hpp"
+#include "TestFixtures.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <criterion/criterion.h>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+using Raytracer::Core::BoundingBox;
+using Raytracer::Core::BVH;
+using Raytracer::Core::HitRecord;
+using Raytracer::Core::Intersection;
+using Raytracer::Core::Ray;
+using Raytracer::Core::Scene;
+using Raytracer::Math::Point;
+using Raytracer::Math::Transform;
+using Raytracer::Math::Vector;
+using Raytracer::Tests::TestPointLight;
+using Raytracer::Tests::TestSphere;
+
+namespace {
+
+std::vector<BoundingBox> randomBoxes(std::size_t count, unsigned seed) {
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<double> position(-10.0, 10.0);
+  std::uniform_real_distribution<double> size(0.05, 1.0);
+  std::vector<BoundingBox> boxes;
+  for (std::size_t i = 0; i < count; ++i) {
+    Point<3> min(position(rng), position(rng), position(rng));
+    Vector<3> extent(size(rng), size(rng), size(rng));
+    boxes.emplace_back(min, min + extent);
+  }
+  return boxes;
+}
+
+Ray randomRay(std::mt19937 &rng) {
+  std::uniform_real_distribution<double> position(-15.0, 15.0);
+  std::uniform_real_distribution<double> direction(-1.0, 1.0);
+  return Ray(Point<3>(position(rng), position(rng), position(rng)),
+             Vector<3>(direction(rng), direction(rng), direction(rng)), 0.0,
+             std::numeric_limits<double>::infinity());
+}
+
+void fillScene(Scene &scene, std::size_t count, unsigned seed) {
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<double> position(-10.0, 10.0);
+  std::uniform_real_distribution<double> radius(0.1, 1.0);
+  for (std::size_t i = 0; i < count; ++i) {
+    Point<3> center(position(rng), position(rng), position(rng));
+    scene.addPrimitive("sphere" + std::to_string(i),
+                       std::make_unique<TestSphere>(center, radius(rng)));
+  }
+}
+
+} // namespace
+
+Test(BVHSuite, EmptyBuild) {
+  BVH bvh;
+  bvh.build({});
+  Ray ray(Point<3>(0.0, 0.0, 0.0), Vector<3>(0.0, 0.0, 1.0));
+  int visits = 0;
+
+  cr_assert(bvh.empty(), "BVH built from no boxes should be empty.");
+  cr_assert_not(bvh.traverse(ray, [&](std::uint32_t, double &) {
+    ++visits;
+    return true;
+  }));
+  cr_assert_eq(visits, 0, "Empty BVH should not visit any item.");
+}
+
+Test(BVHSuite, RootBoundsEncloseItems) {
+  auto boxes = randomBoxes(200, 7);
+  BVH bvh;
+  bvh.build(boxes);
+  BoundingBox root = bvh.getBounds();
+
+  for (const auto &box : boxes) {
+    cr_assert(root.contains(box.getMin()) && root.contains(box.getMax()),
+              "Root bounds should enclose every item box.");
+  }
+}
+
+Test(BVHSuite, VisitsEveryOverlappedItem) {
+  auto boxes = randomBoxes(500, 42);
+  BVH bvh;
+  bvh.build(boxes);
+  std::mt19937 rng(1);
+
+  for (int i = 0; i < 200; ++i) {
+    Ray ray = randomRay(rng);
+    std::vector<std::uint32_t> visited;
+    bvh.traverse(ray, [&](std::uint32_t item, double &) {
+      visited.push_back(item);
+      return false;
+    });
+    std::sort(visited.begin(), visited.end());
+
+    for (std::uint32_t item = 0; item < boxes.size(); ++item) {
+      if (boxes[item].intersect(ray)) {
+        cr_assert(std::binary_search(visited.begin(), visited.end(), item),
+                  "Item %u overlapped by the ray was not visited.", item);
+      }
+    }
+  }
+}
+
+Test(BVHSuite, SinglePrecisionNodesVisitEveryOverlappedItem) {
+  auto boxes = randomBoxes(500, 42);
+  Raytracer::Core::BasicBVH<float> bvh;
+  bvh.build(boxes);
+  std::mt19937 rng(1);
+
+  for (int i = 0; i < 200; ++i) {
+    Ray ray = randomRay(rng);
+    std::vector<std::uint32_t> visited;
+    bvh.traverse(ray, [&](std::uint32_t item, double &) {
+      visited.push_back(item);
+      return false;
+    });
+    std::sort(visited.begin(), visited.end());
+
+    for (std::uint32_t item = 0; item < boxes.size(); ++item) {
+      if (boxes[item].intersect(ray)) {
+        cr_assert(std::binary_search(visited.begin(), visited.end(), item),
+                  "Item %u overlapped by the ray was not visited.", item);
+      }
+    }
+  }
+}
+
+Test(BVHSuite, TerminatesOnRequest) {
+  auto boxes = randomBoxes(100, 3);
+  BVH bvh;
+  bvh.build(boxes);
+  Ray ray(Point<3>(-20.0, 0.0, 0.0), Vector<3>(1.0, 0.01, 0.02));
+  int visits = 0;
+
+  bool stopped = bvh.traverse(ray, [&](std::uint32_t, double &) {
+    ++visits;
+    return true;
+  });
+
+  cr_assert_eq(stopped, visits > 0);
+  cr_assert_leq(visits, 1, "Traversal should stop at the first request.");
+}
+
+Test(BVHSuite, SceneMatchesBruteForce) {
+  Scene bruteForce;
+  Scene accelerated;
+  fillScene(bruteForce, 300, 11);
+  fillScene(accelerated, 300, 11);
+  accelerated.compile();
+  std::mt19937 rng(5);
+
+  cr_assert_not(bruteForce.isCompiled());
+  cr_assert(accelerated.isCompiled());
+  for (int i = 0; i < 500; ++i) {
+    Ray ray = randomRay(rng);
+    auto expected = bruteForce.findNearestIntersection(ray);
+    auto actual = accelerated.findNearestIntersection(ray);
+
+    cr_assert_eq(expected.has_value(), actual.has_value());
+    cr_assert_eq(bruteForce.hasIntersection(ray),
+                 accelerated.hasIntersection(ray));
+    if (expected) {
+      cr_assert_eq(expected->getDistance(), actual->getDistance(),
+                   "Nearest hit differs from the exhaustive search.");
+    }
+  }
+}
+
+Test(BVHSuite, EditInvalidatesFinalize) {
+  Scene scene;
+  fillScene(scene, 10, 2);
+  scene.compile();
+  scene.addPrimitive("extra", std::make_unique<TestSphere>(
+                                  Point<3>(0.0, 0.0, 50.0), 1.0));
+
+  cr_assert_not(scene.isCompiled(),
+                "Adding a primitive should require a new compile.");
+  Ray ray(Point<3>(0.0, 0.0, 40.0), Vector<3>(0.0, 0.0, 1.0), 0.0,
+          std::numeric_limits<double>::infinity());
+  cr_assert(scene.findNearestIntersection(ray).has_value(),
+            "Primitive added after compile should still be found.");
+}
+
+Test(BVHSuite, ChildScenesMatchBruteForce) {
+  Scene bruteForce;
+  Scene accelerated;
+  fillScene(bruteForce, 50, 21);
+  fillScene(accelerated, 50, 21);
+  for (unsigned child = 0; child < 4; ++child) {
+    auto bruteForceChild = std::make_unique<Scene>();
+    auto acceleratedChild = std::make_unique<Scene>();
+    fillScene(*bruteForceChild, 50, 100 + child);
+    fillScene(*acceleratedChild, 50, 100 + child);
+    bruteForce.addChildScene("child" + std::to_string(child),
+                             std::move(bruteForceChild));
+    accelerated.addChildScene("child" + std::to_string(child),
+                              std::move(acceleratedChild));
+  }
+  accelerated.compile();
+  std::mt19937 rng(9);
+
+  cr_assert(accelerated.isCompiled());
+  cr_assert_not(accelerated.getChildScene("child0")->isCompiled(),
+                "Child scenes are flattened into the parent's snapshot.");
+  for (int i = 0; i < 500; ++i) {
+    Ray ray = randomRay(rng);
+    auto expected = bruteForce.findNearestIntersection(ray);
+    auto actual = accelerated.findNearestIntersection(ray);
+
+    cr_assert_eq(expected.has_value(), actual.has_value());
+    if (expected) {
+      cr_assert_eq(expected->getDistance(), actual->getDistance());
+    }
+  }
+}
+
+Test(BVHSuite, MissedChildSceneIsSkipped) {
+  Scene scene;
+  auto child = std::make_unique<Scene>();
+  auto sphere =
+      std::make_unique<TestSphere>(Point<3>(100.0, 0.0, 0.0), 1.0);
+  const TestSphere *childSphere = sphere.get();
+  child->addPrimitive("far", std::move(sphere));
+  scene.addChildScene("child", std::move(child));
+  fillScene(scene, 20, 4);
+  scene.compile();
+
+  Ray ray(Point<3>(0.0, 0.0, -30.0), Vector<3>(0.0, 0.0, 1.0), 0.0,
+          std::numeric_limits<double>::infinity());
+  (void)scene.findNearestIntersection(ray);
+  (void)scene.hasIntersection(ray);
+
+  cr_assert_eq(childSphere->intersectCalls, 0,
+               "A ray missing the child scene bounds should not reach its "
+               "primitives.");
+}
+
+Test(BVHSuite, InstancesShareScene) {
+  auto prototype = std::make_shared<Scene>();
+  prototype->addPrimitive("sphere", std::make_unique<TestSphere>(
+                                        Point<3>(0.0, 0.0, 0.0), 1.0));
+  prototype->compile();
+  std::shared_ptr<const Scene> shared = prototype;
+
+  Scene scene;
+  scene.addInstance("left", shared, Transform::translate(-5.0, 0.0, 0.0));
+  scene.addInstance("right", shared,
+                    Transform::translate(5.0, 0.0, 0.0) *
+                        Transform::scale(2.0, 2.0, 2.0));
+  scene.compile();
+
+  cr_assert_eq(scene.getInstances().size(), 2);
+  cr_assert_eq(shared.use_count(), 4,
+               "Both instances should reference the same scene.");
+
+  Ray left(Point<3>(-5.0, 0.0, -10.0), Vector<3>(0.0, 0.0, 1.0), 0.0,
+           std::numeric_limits<double>::infinity());
+  auto leftHit = scene.findNearestIntersection(left);
+  cr_assert(leftHit.has_value());
+  cr_assert_float_eq(leftHit->getDistance(), 9.0, 1e-9);
+  cr_assert_float_eq(leftHit->getPoint().m_components[0], -5.0, 1e-9);
+
+  Ray right(Point<3>(5.0, 0.0, -10.0), Vector<3>(0.0, 0.0, 1.0), 0.0,
+            std::numeric_limits<double>::infinity());
+  auto rightHit = scene.findNearestIntersection(right);
+  cr_assert(rightHit.has_value());
+  cr_assert_float_eq(rightHit->getDistance(), 8.0, 1e-9);
+  cr_assert_float_eq(rightHit->getNormal().m_components[2], -1.0, 1e-9);
+
+  Ray between(Point<3>(0.0, 0.0, -10.0), Vector<3>(0.0, 0.0, 1.0), 0.0,
+              std::numeric_limits<double>::infinity());
+  cr_assert_not(scene.hasIntersection(between));
+  cr_assert(scene.hasIntersection(right));
+}
+
+Test(BVHSuite, ShadowQueriesUseOccluded) {
+  Scene scene;
+  auto sphere = std::make_unique<TestSphere>(Point<3>(0.0, 0.0, 0.0), 1.0);
+  const TestSphere *raw = sphere.get();
+  scene.addPrimitive("sphere", std::move(sphere));
+  scene.compile();
+
+  Ray ray(Point<3>(0.0, 0.0, -10.0), Vector<3>(0.0, 0.0, 1.0), 1e-4, 20.0);
+
+  cr_assert(scene.hasIntersection(ray));
+  cr_assert_eq(raw->occludedCalls, 1,
+               "Any-hit queries should go through occluded().");
+  cr_assert_eq(raw->intersectCalls, 1,
+               "The default occluded() should defer to intersect().");
+
+  Ray shortRay(Point<3>(0.0, 0.0, -10.0), Vector<3>(0.0, 0.0, 1.0), 1e-4,
+               5.0);
+  cr_assert_not(scene.hasIntersection(shortRay),
+                "Hits beyond the ray max distance should not occlude.");
+}
+
+Test(BVHSuite, OnlyNearestHitIsShaded) {
+  Scene scene;
+  std::vector<const TestSphere *> spheres;
+  for (int i = 0; i < 8; ++i) {
+    auto sphere = std::make_unique<TestSphere>(
+        Point<3>(0.0, 0.0, 3.0 * static_cast<double>(i)), 1.0);
+    spheres.push_back(sphere.get());
+    scene.addPrimitive("sphere" + std::to_string(i), std::move(sphere));
+  }
+  scene.compile();
+
+  Ray ray(Point<3>(0.0, 0.0, 30.0), Vector<3>(0.0, 0.0, -1.0), 0.0,
+          std::numeric_limits<double>::infinity());
+  auto hit = scene.findNearestIntersection(ray);
+
+  cr_assert(hit.has_value());
+  cr_assert_float_eq(hit->getDistance(), 8.0, 1e-9);
+  for (std::size_t i = 0; i < spheres.size(); ++i) {
+    cr_assert_eq(spheres[i]->shadeCalls, i + 1 == spheres.size() ? 1 : 0,
+                 "Only the nearest primitive should compute surface data.");
+  }
+}
+
+Test(BVHSuite, FindHitOnlyAcceptsCloserHits) {
+  Scene scene;
+  fillScene(scene, 100, 17);
+  scene.compile();
+  std::mt19937 rng(23);
+
+  for (int i = 0; i < 200; ++i) {
+    Ray ray = randomRay(rng);
+    HitRecord hit;
+    bool found = scene.findHit(ray, hit);
+    auto nearest = scene.findNearestIntersection(ray);
+
+    cr_assert_eq(found, nearest.has_value());
+    if (!found) {
+      continue;
+    }
+    cr_assert_not_null(hit.primitive);
+    cr_assert_float_eq(hit.t * ray.getDirection().length(),
+                       nearest->getDistance(), 1e-9);
+
+    HitRecord bounded;
+    bounded.t = hit.t;
+    cr_assert_not(scene.findHit(ray, bounded),
+                  "A hit at the current distance should not replace it.");
+    cr_assert_null(bounded.primitive);
+  }
+}
+
+Test(BVHSuite, FindHitRecordsInstance) {
+  auto prototype = std::make_shared<Scene>();
+  prototype->addPrimitive("sphere", std::make_unique<TestSphere>(
+                                        Point<3>(0.0, 0.0, 0.0), 1.0));
+  prototype->compile();
+
+  Scene scene;
+  scene.addInstance("moved", prototype, Transform::translate(0.0, 4.0, 0.0));
+  scene.addPrimitive("direct", std::make_unique<TestSphere>(
+                                   Point<3>(0.0, 0.0, 0.0), 1.0));
+  scene.compile();
+
+  Ray throughInstance(Point<3>(0.0, 4.0, -10.0), Vector<3>(0.0, 0.0, 2.0),
+                      0.0, std::numeric_limits<double>::infinity());
+  HitRecord hit;
+  cr_assert(scene.findHit(throughInstance, hit));
+  cr_assert_eq(hit.instance, &scene.getInstances().at("moved"));
+  cr_assert_float_eq(hit.t, 4.5, 1e-9);
+
+  Ray direct(Point<3>(0.0, 0.0, -10.0), Vector<3>(0.0, 0.0, 1.0), 0.0,
+             std::numeric_limits<double>::infinity());
+  HitRecord directHit;
+  cr_assert(scene.findHit(direct, directHit));
+  cr_assert_null(directHit.instance);
+  cr_assert_eq(directHit.primitive, scene.getPrimitive("direct"));
+}
+
+Test(BVHSuite, PacketsMatchSingleRays) {
+  Scene scene;
+  fillScene(scene, 300, 17);
+  scene.compile();
+  std::mt19937 rng(23);
+  std::uniform_real_distribution<double> spread(-0.3, 0.3);
+
+  // Odd packets share an origin and a direction octant and are traced
+  // together; even ones point anywhere and fall back to single rays.
+  for (int packet = 0; packet < 60; ++packet) {
+    std::array<Ray, Scene::PACKET_SIZE> rays;
+    Point<3> origin(0.0, 0.0, -20.0);
+    for (Ray &ray : rays) {
+      ray = packet % 2 == 0
+                ? randomRay(rng)
+                : Ray(origin,
+                      Vector<3>(spread(rng), spread(rng), 1.0).normalize(),
+                      0.0, std::numeric_limits<double>::infinity());
+    }
+
+    std::array<HitRecord, Scene::PACKET_SIZE> hits{};
+    const std::uint32_t found = scene.findHits(rays, hits);
+    const std::uint32_t occluded = scene.findOccluded(rays);
+    for (std::size_t lane = 0; lane < rays.size(); ++lane) {
+      HitRecord expected;
+      const bool hit = scene.findHit(rays[lane], expected);
+      cr_assert_eq((found >> lane & 1u) != 0, hit);
+      cr_assert_eq((occluded >> lane & 1u) != 0,
+                   scene.hasIntersection(rays[lane]));
+      if (hit) {
+        cr_assert_eq(hits[lane].t, expected.t);
+        cr_assert_eq(hits[lane].primitive, expected.primitive,
+                     "Packets should keep the single-ray tie-breaking.");
+      }
+    }
+  }
+}
+
+Test(BVHSuite, PartialPacketLeavesOtherLanes) {
+  Scene scene;
+  scene.addPrimitive("sphere", std::make_unique<TestSphere>(
+                                   Point<3>(0.0, 0.0, 0.0), 1.0));
+  scene.compile();
+
+  std::array<Ray, 2> rays = {
+      Ray(Point<3>(0.0, 0.0, -10.0), Vector<3>(0.0, 0.0, 1.0), 0.0, 20.0),
+      Ray(Point<3>(5.0, 0.0, -10.0), Vector<3>(0.0, 0.0, 1.0), 0.0, 20.0)};
+  std::array<std::optional<Intersection>, Scene::PACKET_SIZE> hits;
+  scene.findNearestIntersections(rays, hits);
+
+  cr_assert(hits[0].has_value());
+  cr_assert_float_eq(hits[0]->getDistance(), 9.0, 1e-9);
+  cr_assert_not(hits[1].has_value());
+  cr_assert_eq(scene.findOccluded(rays), 1u);
+}
+
+Test(BVHSuite, ShadowQueriesReuseLastOccluder) {
+  Scene scene;
+  fillScene(scene, 50, 29);
+  auto blocker = std::make_unique<TestSphere>(Point<3>(0.0, 0.0, 0.0), 2.0);
+  const TestSphere *raw = blocker.get();
+  scene.addPrimitive("blocker", std::move(blocker));
+  scene.compile();
+  TestPointLight light(Point<3>(0.0, 0.0, 30.0));
+  Scene::resetOccluderCacheStats();
+
+  Ray first(Point<3>(0.0, 0.0, -20.0), Vector<3>(0.0, 0.0, 1.0), 1e-4, 50.0);
+  Ray second(Point<3>(0.5, 0.0, -20.0), Vector<3>(0.0, 0.0, 1.0), 1e-4,
+             50.0);
+  cr_assert(scene.hasIntersection(first, light));
+  const int callsBefore = raw->occludedCalls;
+  cr_assert(scene.hasIntersection(second, light));
+
+  auto stats = Scene::getOccluderCacheStats();
+  cr_assert_eq(stats.lookups, 2u);
+  cr_assert_eq(stats.hits, 1u,
+               "The second ray should be answered by the cached occluder.");
+  cr_assert_eq(raw->occludedCalls, callsBefore + 1);
+
+  std::mt19937 rng(31);
+  for (int i = 0; i < 200; ++i) {
+    Ray ray = randomRay(rng);
+    cr_assert_eq(scene.hasIntersection(ray, light),
+                 scene.hasIntersection(ray));
+  }
+}
@@ -0,0 +1,139 @@
+/**
+ * @file test_BoundingBox.cpp
+ * @brief Unit tests for the BoundingBox class.
+ */
+
+#include "../src/Core/BoundingBox.hpp"
+#include "../src/Core/Ray.hpp"
+#include "../src/Math/Point.hpp"
+#include "../src/Math/Vector.hpp"
+#include <cmath>
+#include <criterion/criterion.h>
+#include <limits>
+
+using Raytracer::Core::BoundingBox;
+using Raytracer::Core::Ray;
+using Raytracer::Math::Point;
+using Raytracer::Math::Vector;
+
+static constexpr double EQ_APPROX = 1e-9;
+
+static BoundingBox unitBox() {
+  return BoundingBox(Point<3>(-1.0, -1.0, -1.0), Point<3>(1.0, 1.0, 1.0));
+}
+
+Test(BoundingBoxSuite, RayHitsBox) {
+  Ray ray(Point<3>(0.0, 0.0, -5.0), Vector<3>(0.0, 0.0, 1.0));
+
+  cr_assert(unitBox().intersect(ray), "Ray aimed at the box should hit it.");
+}
+
+Test(BoundingBoxSuite, RayMissesBox) {
+  Ray ray(Point<3>(0.0, 3.0, -5.0), Vector<3>(0.0, 0.0, 1.0));
+
+  cr_assert_not(unitBox().intersect(ray),
+                "Ray passing above the box should miss it.");
+}
+
+Test(BoundingBoxSuite, RayPointingAwayMisses) {
+  Ray ray(Point<3>(0.0, 0.0, -5.0), Vector<3>(0.0, 0.0, -1.0));
+
+  cr_assert_not(unitBox().intersect(ray),
+                "Box behind the ray origin should not be hit.");
+}
+
+Test(BoundingBoxSuite, RayInsideBoxHits) {
+  Ray ray(Point<3>(0.0, 0.0, 0.0), Vector<3>(1.0, 2.0, 3.0));
+
+  cr_assert(unitBox().intersect(ray), "Ray starting inside should hit.");
+}
+
+Test(BoundingBoxSuite, RangeLimitsHit) {
+  Ray shortRay(Point<3>(0.0, 0.0, -5.0), Vector<3>(0.0, 0.0, 1.0), 0.0, 3.0);
+
+  cr_assert_not(unitBox().intersect(shortRay),
+                "Box beyond the ray max distance should be missed.");
+}
+
+Test(BoundingBoxSuite, EntryDistance) {
+  BoundingBox box = unitBox();
+  Vector<3> invDirection(std::numeric_limits<double>::infinity(),
+                         std::numeric_limits<double>::infinity(), 0.5);
+  double entry = 0.0;
+
+  cr_assert(box.intersect(Point<3>(0.0, 0.0, -5.0), invDirection, 0.0,
+                          std::numeric_limits<double>::infinity(), entry));
+  cr_assert_float_eq(entry, 2.0, EQ_APPROX);
+}
+
+Test(BoundingBoxSuite, AxisAlignedRayOnFace) {
+  Ray ray(Point<3>(1.0, 0.0, -5.0), Vector<3>(0.0, 0.0, 1.0));
+
+  cr_assert(unitBox().intersect(ray),
+            "Ray grazing a face of the box should count as a hit.");
+}
+
+Test(BoundingBoxSuite, FlatBoxIsHit) {
+  BoundingBox flat(Point<3>(-1.0, 0.0, -1.0), Point<3>(1.0, 0.0, 1.0));
+  Ray ray(Point<3>(0.2, 5.0, 0.3), Vector<3>(0.0, -1.0, 0.0));
+
+  cr_assert(flat.intersect(ray), "Zero-thickness box should still be hit.");
+}
+
+Test(BoundingBoxSuite, Unite) {
+  BoundingBox a(Point<3>(0.0, 0.0, 0.0), Point<3>(1.0, 1.0, 1.0));
+  BoundingBox b(Point<3>(-2.0, 0.5, 0.5), Point<3>(0.5, 3.0, 0.75));
+  BoundingBox united = a.unite(b);
+
+  cr_assert_float_eq(united.getMin().m_components[0], -2.0, EQ_APPROX);
+  cr_assert_float_eq(united.getMin().m_components[1], 0.0, EQ_APPROX);
+  cr_assert_float_eq(united.getMin().m_components[2], 0.0, EQ_APPROX);
+  cr_assert_float_eq(united.getMax().m_components[0], 1.0, EQ_APPROX);
+  cr_assert_float_eq(united.getMax().m_components[1], 3.0, EQ_APPROX);
+  cr_assert_float_eq(united.getMax().m_components[2], 1.0, EQ_APPROX);
+}
+
+Test(BoundingBoxSuite, Contains) {
+  BoundingBox box = unitBox();
+
+  cr_assert(box.contains(Point<3>(0.0, 0.5, -0.5)));
+  cr_assert(box.contains(Point<3>(1.0, 1.0, 1.0)));
+  cr_assert_not(box.contains(Point<3>(1.5, 0.0, 0.0)));
+}
+
+Test(BoundingBoxSuite, CenterAndSurfaceArea) {
+  BoundingBox box(Point<3>(0.0, 0.0, 0.0), Point<3>(2.0, 3.0, 4.0));
+  Point<3> center = box.getCenter();
+
+  cr_assert_float_eq(center.m_components[0], 1.0, EQ_APPROX);
+  cr_assert_float_eq(center.m_components[1], 1.5, EQ_APPROX);
+  cr_assert_float_eq(center.m_components[2], 2.0, EQ_APPROX);
+  cr_assert_float_eq(box.surfaceArea(), 52.0, EQ_APPROX);
+}
+
+Test(BoundingBoxSuite, IsBounded) {
+  double inf = std::numeric_limits<double>::infinity();
+  BoundingBox infinite(Point<3>(-inf, -inf, -inf), Point<3>(inf, inf, inf));
+
+  cr_assert(unitBox().isBounded());
+  cr_assert_not(infinite.isBounded());
+}
+
+Test(BoundingBoxSuite, SinglePrecisionBoxEnclosesSource) {
+  BoundingBox box(Point<3>(0.1, -1.0 / 3.0, 1e-3),
+                  Point<3>(0.7, 2.0 / 3.0, 1e5 + 0.1));
+  auto compact = Raytracer::Core::BasicBoundingBox<float>::enclosing(box);
+
+  for (std::size_t i = 0; i < 3; ++i) {
+    const double low = compact.getMin().m_components[i];
+    const double high = compact.getMax().m_components[i];
+    cr_assert_leq(low, box.getMin().m_components[i]);
+    cr_assert_geq(high, box.getMax().m_components[i]);
+    cr_assert(std::nextafter(compact.getMin().m_components[i], 1e30f) >
+                  box.getMin().m_components[i],
+              "Lower bound %zu should be the closest float.", i);
+  }
+  Ray grazing(Point<3>(0.1, 0.0, -5.0), Vector<3>(0.0, 0.0, 1.0));
+  cr_assert(compact.intersect(grazing),
+            "Ray on a face of the source box should hit the rounded box.");
+}
@@ -0,0 +1,58 @@
+/**
+ * @file test_ConePlugin.cpp
+ * @brief Unit tests for the ConePlugin primitive.
+ */
+
+#include "../plugins/ConePlugin.hpp"
+#include <criterion/criterion.h>
+#include <limits>
+#include <random>
+#include <string>
+
+using Raytracer::Core::Ray;
+using Raytracer::Math::Point;
+using Raytracer::Math::Vector;
+using Raytracer::Plugins::ConePlugin;
+
+Test(ConePluginSuite, OccludedMatchesIntersect) {
+  std::mt19937 rng(43);
+  std::uniform_real_distribution<double> position(-3.0, 3.0);
+  std::uniform_real_distribution<double> direction(-1.0, 1.0);
+  std::uniform_real_distribution<double> size(0.5, 2.0);
+  std::uniform_real_distribution<double> angle(0.0, 90.0);
+  std::uniform_real_distribution<double> reach(0.5, 1.5);
+
+  int hits = 0;
+  int misses = 0;
+  for (const std::string axis : {"X", "Y", "Z"}) {
+    for (int shape = 0; shape < 4; ++shape) {
+      ConePlugin cone;
+      Point<3> apex(position(rng), position(rng), position(rng));
+      cone.setAxisPositionRadiusHeight(axis, apex, size(rng), size(rng));
+      cone.setPosition(apex);
+      if (shape % 2 == 1) {
+        cone.setRotation(Vector<3>(angle(rng), angle(rng), angle(rng)));
+      }
+
+      for (int i = 0; i < 2000; ++i) {
+        // Rays reach the point they aim at for t = 1. Half of them stop
+        // around there, before the cone, inside it, or past it.
+        double maxDistance = std::numeric_limits<double>::infinity();
+        if (i % 2 == 1) {
+          maxDistance = reach(rng);
+        }
+        Point<3> origin(2.0 * position(rng), 2.0 * position(rng),
+                        2.0 * position(rng));
+        Vector<3> offset(direction(rng), direction(rng), direction(rng));
+        Ray ray(origin, apex + offset * 2.0 - origin, 1e-4, maxDistance);
+        bool hit = cone.intersect(ray).has_value();
+
+        cr_assert_eq(cone.occluded(ray), hit,
+                     "occluded() should agree with intersect().");
+        ++(hit ? hits : misses);
+      }
+    }
+  }
+  cr_assert_gt(hits, 1000, "Many rays should hit the cones.");
+  cr_assert_gt(misses, 1000, "Many rays should miss the cones.");
+}
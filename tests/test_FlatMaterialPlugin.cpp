@@ -0,0 +1,101 @@
+/**
+ * @file test_FlatMaterialPlugin.cpp
+ * @brief Unit tests for the FlatMaterialPlugin material.
+ */
+
+#include "../plugins/FlatMaterialPlugin.hpp"
+#include "../src/Core/Renderer.hpp"
+#include "../src/Core/Scene.hpp"
+#include "TestFixtures.hpp"
+#include <algorithm>
+#include <cmath>
+#include <criterion/criterion.h>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using Raytracer::Core::Color;
+using Raytracer::Core::Renderer;
+using Raytracer::Core::Scene;
+using Raytracer::Math::Point;
+using Raytracer::Plugins::FlatMaterialPlugin;
+using Raytracer::Tests::TestPointLight;
+using Raytracer::Tests::TestSphere;
+
+namespace {
+
+constexpr std::size_t SIZE = 16;
+constexpr std::size_t PASSES = 512;
+
+/**
+ * @brief Fill a scene with a flat wall facing the camera, lit by point
+ * lights behind the camera, three in four of them hidden by a small sphere.
+ *
+ * The visible lights together stay well below white, but the light tree
+ * does not know about shadows, so a sampled visible light weighted by the
+ * inverse of its probability often goes past it.
+ */
+void fillLitWall(Scene &scene) {
+  auto material = std::make_shared<FlatMaterialPlugin>();
+  material->setDiffuseColor(Color(150.0, 120.0, 90.0));
+  material->setDiffuseCoefficient(1.0);
+  auto wall = std::make_unique<TestSphere>(Point<3>(0.5, 0.5, 30.0), 25.0);
+  wall->setMaterial(material);
+  scene.addPrimitive("wall", std::move(wall));
+
+  std::mt19937 rng(22);
+  std::uniform_real_distribution<double> lateral(-3.0, 4.0);
+  std::uniform_real_distribution<double> depth(-3.0, -1.5);
+  std::uniform_real_distribution<double> intensity(0.2, 0.6);
+  for (int i = 0; i < 8; ++i) {
+    const double x = lateral(rng);
+    const double y = lateral(rng);
+    const double z = depth(rng);
+    auto light = std::make_unique<TestPointLight>(Point<3>(x, y, z));
+    light->setIntensity(intensity(rng));
+    light->setColor(Color(255.0, 255.0, 255.0));
+    scene.addLight("light" + std::to_string(i), std::move(light));
+    if (i % 4 != 0) {
+      auto blocker = std::make_unique<TestSphere>(Point<3>(x, y, z + 0.6), 0.4);
+      blocker->setMaterial(material);
+      scene.addPrimitive("blocker" + std::to_string(i), std::move(blocker));
+    }
+  }
+  scene.compile();
+}
+
+} // namespace
+
+Test(FlatMaterialSuite, SampledLightsConvergeToEveryLight) {
+  Scene scene;
+  fillLitWall(scene);
+  Renderer renderer(SIZE, SIZE);
+  std::vector<uint8_t> reference(SIZE * SIZE * 4, 0);
+  renderer.renderToBuffer(scene, reference);
+
+  scene.setLightSampleCount(1);
+  std::vector<uint8_t> single(SIZE * SIZE * 4, 0);
+  renderer.renderToBuffer(scene, single);
+  std::vector<uint8_t> sampled(SIZE * SIZE * 4, 0);
+  renderer.setProgressive(true, PASSES);
+  renderer.renderToBuffer(scene, sampled);
+
+  int brightest = 0;
+  int clipped = 0;
+  double difference = 0.0;
+  for (std::size_t i = 0; i < reference.size(); i += 4) {
+    for (std::size_t c = 0; c < 3; ++c) {
+      brightest = std::max<int>(brightest, reference[i + c]);
+      clipped += single[i + c] == 255 ? 1 : 0;
+      difference += static_cast<double>(sampled[i + c]) - reference[i + c];
+    }
+  }
+  difference /= static_cast<double>(SIZE * SIZE * 3);
+  cr_assert_lt(brightest, 200, "The scene should not saturate.");
+  cr_assert_gt(clipped, 0, "Some single samples should go past white.");
+  cr_assert_lt(std::abs(difference), 2.0,
+               "The sampled mean should converge to every light, got %f.",
+               difference);
+}
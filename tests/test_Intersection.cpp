@@ -19,7 +19,7 @@ public:
 
   Raytracer::Core::Color
   computeColor(const Intersection &, const Raytracer::Core::Ray &,
-               const std::vector<std::shared_ptr<Raytracer::Core::ILight>> &)
+               const std::vector<const Raytracer::Core::ILight *> &)
       const override {
     return Raytracer::Core::Color(0, 0, 0);
   }
@@ -79,7 +79,7 @@ Test(IntersectionSuite, DefaultConstructor) {
   Vector<3> expectedNormal(0.0, 0.0, 0.0);
   assert_vector3d_eq(intersection.getNormal(), expectedNormal);
 
-  cr_assert_null(intersection.getMaterial().get());
+  cr_assert_null(intersection.getMaterial());
 
   cr_assert_float_eq(intersection.getDistance(), 0.0, EQ_APPROX);
 
@@ -99,13 +99,14 @@ Test(IntersectionSuite, ParameterizedConstructor) {
 
   IMaterial *materialRawPtr = material.get();
 
-  Intersection intersection(point, normal, material, distance, isInside, uv);
+  Intersection intersection(point, normal, material.get(), distance, isInside,
+                            uv);
 
   assert_point3d_eq(intersection.getPoint(), point);
   assert_vector3d_eq(intersection.getNormal(), normal);
 
-  cr_assert_not_null(intersection.getMaterial().get());
-  cr_assert_eq(intersection.getMaterial().get(), materialRawPtr);
+  cr_assert_not_null(intersection.getMaterial());
+  cr_assert_eq(intersection.getMaterial(), materialRawPtr);
 
   cr_assert_float_eq(intersection.getDistance(), distance, EQ_APPROX);
   cr_assert_eq(intersection.getIsInside(), isInside);
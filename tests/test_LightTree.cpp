@@ -0,0 +1,152 @@
+/**
+ * @file test_LightTree.cpp
+ * @brief Unit tests for the LightTree class.
+ */
+
+#include "../src/Core/ALight.hpp"
+#include "../src/Core/LightTree.hpp"
+#include <algorithm>
+#include <cmath>
+#include <criterion/criterion.h>
+#include <memory>
+#include <random>
+#include <vector>
+
+using Raytracer::Core::Color;
+using Raytracer::Core::ILight;
+using Raytracer::Core::LightTree;
+using Raytracer::Core::Scene;
+using Raytracer::Math::Point;
+using Raytracer::Math::Vector;
+
+namespace {
+
+class LightTreeTestLight : public Raytracer::Core::APositionalLight {
+public:
+  LightTreeTestLight(const Point<3> &position, double intensity,
+                     const Color &color)
+      : APositionalLight(position) {
+    setIntensity(intensity);
+    setColor(color);
+  }
+
+  [[nodiscard]] double
+  computeIllumination(const Point<3> &, const Vector<3> &,
+                      const Scene &) const noexcept override {
+    return 1.0;
+  }
+
+  [[nodiscard]] bool castsShadow() const noexcept override { return true; }
+};
+
+class LightTreeTestSun : public Raytracer::Core::ADirectionalLight {
+public:
+  [[nodiscard]] bool castsShadow() const noexcept override { return false; }
+};
+
+std::vector<const ILight *>
+listOf(const std::vector<std::unique_ptr<ILight>> &lights) {
+  std::vector<const ILight *> list;
+  for (const auto &light : lights) {
+    list.push_back(light.get());
+  }
+  return list;
+}
+
+double contribution(const ILight &light, const Point<3> &point,
+                    const Vector<3> &normal) {
+  const auto &positional =
+      dynamic_cast<const Raytracer::Core::IPositionalLight &>(light);
+  Vector<3> toLight = positional.getPosition() - point;
+  const double cosine = normal.dot(toLight) / toLight.length();
+  const Color &color = light.getColor();
+  return std::max(cosine, 0.0) * light.getIntensity() *
+         (color.getR() + color.getG() + color.getB()) / (3.0 * 255.0);
+}
+
+} // namespace
+
+Test(LightTreeSuite, EmptyTreeSamplesNothing) {
+  LightTreeTestSun sun;
+  LightTree tree;
+  tree.build({&sun});
+
+  cr_assert(tree.empty());
+  cr_assert_eq(tree.getOtherLights().size(), 1u);
+  LightTree::Sample sample =
+      tree.sample(Point<3>(0.0, 0.0, 0.0), Vector<3>(0.0, 0.0, 1.0), 0.5);
+  cr_assert_null(sample.light);
+  cr_assert_eq(sample.pdf, 0.0);
+}
+
+Test(LightTreeSuite, SingleLightHasUnitProbability) {
+  LightTreeTestLight light(Point<3>(1.0, 2.0, 5.0), 0.8,
+                           Color(255.0, 255.0, 255.0));
+  LightTree tree;
+  tree.build({&light});
+
+  cr_assert_eq(tree.size(), 1u);
+  LightTree::Sample sample =
+      tree.sample(Point<3>(0.0, 0.0, 0.0), Vector<3>(0.0, 0.0, 1.0), 0.99);
+  cr_assert_eq(sample.light, &light);
+  cr_assert_eq(sample.positional, &light);
+  cr_assert_float_eq(sample.pdf, 1.0, 1e-12);
+}
+
+Test(LightTreeSuite, LightsBehindTheSurfaceAreNeverPicked) {
+  std::vector<std::unique_ptr<ILight>> lights;
+  for (int i = 0; i < 16; ++i) {
+    const double z = (i % 2 == 0) ? 5.0 : -5.0;
+    lights.push_back(std::make_unique<LightTreeTestLight>(
+        Point<3>(static_cast<double>(i), 0.0, z), 1.0,
+        Color(255.0, 255.0, 255.0)));
+  }
+  LightTree tree;
+  tree.build(listOf(lights));
+  const Point<3> point(7.5, 0.0, 0.0);
+  const Vector<3> normal(0.0, 0.0, 1.0);
+
+  for (int i = 0; i < 1000; ++i) {
+    LightTree::Sample sample = tree.sample(point, normal, (i + 0.5) / 1000.0);
+    cr_assert_not_null(sample.light);
+    cr_assert_gt(sample.positional->getPosition().m_components[2], 0.0);
+    cr_assert_gt(sample.pdf, 0.0);
+  }
+}
+
+Test(LightTreeSuite, WeightedSamplesMatchTheSumOverLights) {
+  std::mt19937 rng(17);
+  std::uniform_real_distribution<double> position(-10.0, 10.0);
+  std::uniform_real_distribution<double> channel(0.0, 255.0);
+  std::uniform_real_distribution<double> intensity(0.1, 1.0);
+  std::vector<std::unique_ptr<ILight>> lights;
+  for (int i = 0; i < 64; ++i) {
+    lights.push_back(std::make_unique<LightTreeTestLight>(
+        Point<3>(position(rng), position(rng), position(rng)), intensity(rng),
+        Color(channel(rng), channel(rng), channel(rng))));
+  }
+  LightTree tree;
+  tree.build(listOf(lights));
+  const Point<3> point(0.5, -1.0, 0.0);
+  const Vector<3> normal = Vector<3>(0.3, 0.2, 1.0).normalize();
+
+  double exact = 0.0;
+  for (const auto &light : lights) {
+    exact += contribution(*light, point, normal);
+  }
+
+  const int samples = 100000;
+  double estimate = 0.0;
+  for (int i = 0; i < samples; ++i) {
+    LightTree::Sample sample = tree.sample(point, normal, (i + 0.5) / samples);
+    if (!sample.light) {
+      continue;
+    }
+    estimate += contribution(*sample.light, point, normal) / sample.pdf;
+  }
+  estimate /= samples;
+
+  cr_assert_float_eq(estimate, exact, exact * 0.01,
+                     "Sampling should be unbiased: got %f, expected %f.",
+                     estimate, exact);
+}
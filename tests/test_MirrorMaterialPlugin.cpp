@@ -0,0 +1,117 @@
+/**
+ * @file test_MirrorMaterialPlugin.cpp
+ * @brief Unit tests for the MirrorMaterialPlugin material.
+ */
+
+#include "../plugins/MirrorMaterialPlugin.hpp"
+#include "../src/Core/Scene.hpp"
+#include <cmath>
+#include <criterion/criterion.h>
+#include <vector>
+
+using Raytracer::Core::Color;
+using Raytracer::Core::Intersection;
+using Raytracer::Core::Ray;
+using Raytracer::Core::RenderContext;
+using Raytracer::Core::Sampler;
+using Raytracer::Core::ScatterResult;
+using Raytracer::Core::Scene;
+using Raytracer::Math::Point;
+using Raytracer::Math::Vector;
+using Raytracer::Plugins::MirrorMaterialPlugin;
+
+namespace {
+
+constexpr std::uint32_t BRANCH_SAMPLES = 4096;
+
+/**
+ * @brief Glass filling z > 0, hit from z < 0 at an angle to the normal.
+ */
+struct GlassHit {
+  explicit GlassHit(double angle)
+      : ray(Point<3>(-std::sin(angle), 0.0, -std::cos(angle)),
+            Vector<3>(std::sin(angle), 0.0, std::cos(angle))),
+        hit(Point<3>(0.0, 0.0, 0.0), Vector<3>(0.0, 0.0, -1.0), nullptr, 1.0,
+            false, Point<2>(0.0, 0.0)) {
+    material.setAmbientColor(Color(2.0, 2.0, 2.0));
+    material.setDiffuseColor(Color(2.0, 2.0, 2.0));
+    material.setAmbientCoefficient(0.5);
+    material.setDiffuseCoefficient(0.5);
+    material.setReflectionCoefficient(1.0);
+    material.setRefractionCoefficient(1.0);
+    material.setRefractiveIndex(1.5);
+  }
+
+  /**
+   * @brief Shade the hit with one sample of the path sampler.
+   * @param sample Sample index of the path.
+   * @return Scattered rays.
+   */
+  ScatterResult scatter(std::uint32_t sample) const {
+    RenderContext context{Sampler(7, sample)};
+    return material.scatter(hit, ray, {}, scene, context);
+  }
+
+  MirrorMaterialPlugin material;
+  Ray ray;
+  Intersection hit;
+  Scene scene;
+};
+
+bool isReflected(const Raytracer::Core::ScatteredRay &scattered) {
+  return scattered.ray.getDirection().m_components[2] < 0.0;
+}
+
+/**
+ * @brief Color the scattered rays bring back, reflections seeing 1 and
+ * refractions 3, or the miss color if the ray escapes.
+ * @param result Scattered rays.
+ * @return Sum of the weighted colors.
+ */
+double estimate(const ScatterResult &result) {
+  double sum = 0.0;
+  for (std::size_t i = 0; i < result.rayCount; ++i) {
+    const auto &scattered = result.rays[i];
+    sum += scattered.weight * (isReflected(scattered) ? 1.0 : 3.0);
+    sum += scattered.missWeight * scattered.missColor.getR();
+  }
+  return sum;
+}
+
+} // namespace
+
+Test(MirrorMaterialSuite, OneBranchAveragesToBoth) {
+  for (double angle : {0.0, 0.7, 1.3, 1.57}) {
+    GlassHit glass(angle);
+    double expected = estimate(glass.scatter(0));
+    glass.material.setStochastic(true);
+
+    double sum = 0.0;
+    for (std::uint32_t sample = 0; sample < BRANCH_SAMPLES; ++sample) {
+      ScatterResult result = glass.scatter(sample);
+      cr_assert_eq(result.rayCount, 1u, "Only one branch should be traced.");
+      sum += estimate(result);
+    }
+    cr_assert_float_eq(sum / BRANCH_SAMPLES, expected, 0.01 * expected,
+                       "One branch should average to both branches.");
+  }
+}
+
+Test(MirrorMaterialSuite, ClampKeepsBothBranches) {
+  // Schlick's reflectance is 0.04 at normal incidence and over 0.99 this
+  // close to grazing, both past the clamp.
+  for (double angle : {0.0, 1.5706}) {
+    GlassHit glass(angle);
+    glass.material.setStochastic(true);
+
+    std::uint32_t reflected = 0;
+    for (std::uint32_t sample = 0; sample < BRANCH_SAMPLES; ++sample) {
+      ScatterResult result = glass.scatter(sample);
+      reflected += isReflected(result.rays[0]) ? 1 : 0;
+    }
+    double share = static_cast<double>(reflected) / BRANCH_SAMPLES;
+    double rarer = std::min(share, 1.0 - share);
+    cr_assert_float_eq(rarer, MirrorMaterialPlugin::MIN_BRANCH_PROBABILITY,
+                       0.005, "The rarer branch should be clamped up.");
+  }
+}
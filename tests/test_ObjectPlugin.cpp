@@ -0,0 +1,220 @@
+/**
+ * @file test_ObjectPlugin.cpp
+ * @brief Unit tests for the ObjectPlugin mesh primitive.
+ */
+
+#include "../plugins/ObjectPlugin.hpp"
+#include <array>
+#include <cmath>
+#include <criterion/criterion.h>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+using Raytracer::Core::HitRecord;
+using Raytracer::Core::Ray;
+using Raytracer::Math::Point;
+using Raytracer::Math::Vector;
+
+namespace {
+
+using MeshTriangle = std::array<Point<3>, 3>;
+
+/**
+ * @brief Write triangles to a temporary OBJ file, one face each.
+ * @param triangles Triangles to write.
+ * @return Path of the file, to remove once loaded.
+ */
+std::filesystem::path writeMesh(const std::vector<MeshTriangle> &triangles) {
+  std::filesystem::path path = std::filesystem::temp_directory_path() /
+                               "raytracer_test_mesh.obj";
+  std::ofstream file(path);
+  file.precision(17);
+  for (const MeshTriangle &triangle : triangles) {
+    for (const Point<3> &vertex : triangle) {
+      file << "v " << vertex.m_components[0] << ' ' << vertex.m_components[1]
+           << ' ' << vertex.m_components[2] << '\n';
+    }
+  }
+  for (std::size_t i = 0; i < triangles.size(); ++i) {
+    file << "f " << 3 * i + 1 << ' ' << 3 * i + 2 << ' ' << 3 * i + 3
+         << '\n';
+  }
+  return path;
+}
+
+/**
+ * @brief Load triangles into an ObjectPlugin.
+ * @param object Plugin to load into.
+ * @param triangles Triangles of the mesh.
+ */
+void loadMesh(ObjectPlugin &object,
+              const std::vector<MeshTriangle> &triangles) {
+  std::filesystem::path path = writeMesh(triangles);
+  cr_assert(object.loadFromFile(path.string()), "The mesh should load.");
+  std::filesystem::remove(path);
+}
+
+std::vector<MeshTriangle> randomTriangles(std::size_t count,
+                                          std::mt19937 &rng) {
+  std::uniform_real_distribution<double> position(-2.0, 2.0);
+  std::uniform_real_distribution<double> offset(-0.8, 0.8);
+  std::vector<MeshTriangle> triangles;
+  for (std::size_t i = 0; i < count; ++i) {
+    Point<3> center(position(rng), position(rng), position(rng));
+    MeshTriangle triangle;
+    for (Point<3> &vertex : triangle) {
+      vertex = center + Vector<3>(offset(rng), offset(rng), offset(rng));
+    }
+    triangles.push_back(triangle);
+  }
+  return triangles;
+}
+
+Ray randomMeshRay(std::mt19937 &rng) {
+  std::uniform_real_distribution<double> position(-4.0, 4.0);
+  std::uniform_real_distribution<double> direction(-1.0, 1.0);
+  return Ray(Point<3>(position(rng), position(rng), position(rng)),
+             Vector<3>(direction(rng), direction(rng), direction(rng)), 0.0,
+             std::numeric_limits<double>::infinity());
+}
+
+/**
+ * @brief Scalar Möller–Trumbore test of a ray against one triangle.
+ * @param ray Ray to test.
+ * @param triangle Triangle to test.
+ * @return Ray parameter of the hit, or infinity on a miss.
+ */
+double scalarHit(const Ray &ray, const MeshTriangle &triangle) {
+  const double miss = std::numeric_limits<double>::infinity();
+  Vector<3> e1 = triangle[1] - triangle[0];
+  Vector<3> e2 = triangle[2] - triangle[0];
+  Vector<3> p = ray.getDirection().cross(e2);
+  double det = e1.dot(p);
+  if (std::abs(det) < 1e-8) {
+    return miss;
+  }
+  double invDet = 1.0 / det;
+  Vector<3> s = ray.getOrigin() - triangle[0];
+  double u = s.dot(p) * invDet;
+  if (u < 0.0 || u > 1.0) {
+    return miss;
+  }
+  Vector<3> q = s.cross(e1);
+  double v = ray.getDirection().dot(q) * invDet;
+  if (v < 0.0 || u + v > 1.0) {
+    return miss;
+  }
+  double t = e2.dot(q) * invDet;
+  if (t <= ray.getMinDistance() || t >= ray.getMaxDistance()) {
+    return miss;
+  }
+  return t;
+}
+
+} // namespace
+
+Test(ObjectPluginSuite, BlocksMatchScalarTest) {
+  std::mt19937 rng(23);
+
+  // Leaves of 1 and 6 triangles, and a 37-triangle hierarchy, all leave
+  // lanes of their last block unused.
+  for (std::size_t count : {1u, 6u, 37u}) {
+    std::vector<MeshTriangle> triangles = randomTriangles(count, rng);
+    ObjectPlugin object;
+    loadMesh(object, triangles);
+    cr_assert_eq(object.getTriangleCount(), count);
+
+    int hits = 0;
+    for (int i = 0; i < 2000; ++i) {
+      Ray ray = randomMeshRay(rng);
+      double expected = std::numeric_limits<double>::infinity();
+      for (const MeshTriangle &triangle : triangles) {
+        expected = std::min(expected, scalarHit(ray, triangle));
+      }
+      HitRecord hit;
+      bool found = object.findHit(ray, hit);
+
+      cr_assert_eq(found, std::isfinite(expected),
+                   "Blocks and scalar test should agree on hits.");
+      cr_assert_eq(object.occluded(ray), found,
+                   "occluded() should agree with findHit().");
+      if (found) {
+        ++hits;
+        cr_assert_float_eq(hit.t, expected, 1e-9 * expected,
+                           "The closest hit should be the scalar one.");
+      }
+    }
+    cr_assert_gt(hits, 0, "Some rays should hit the mesh.");
+  }
+}
+
+Test(ObjectPluginSuite, SinglePrecisionMatchesDouble) {
+  std::mt19937 rng(24);
+  std::uniform_real_distribution<double> unit(0.0, 1.0);
+  std::uniform_real_distribution<double> offset(-1.0, 1.0);
+  std::vector<MeshTriangle> triangles = randomTriangles(300, rng);
+  // Millimetre triangles, meant to be seen from far away.
+  for (int i = 0; i < 40; ++i) {
+    Point<3> corner(offset(rng), offset(rng), offset(rng));
+    triangles.push_back({corner,
+                         corner + Vector<3>(1e-3 * unit(rng), 1e-3, 0.0),
+                         corner + Vector<3>(0.0, 1e-3 * unit(rng), 1e-3)});
+  }
+  ObjectPlugin precise;
+  ObjectPlugin compact;
+  loadMesh(precise, triangles);
+  loadMesh(compact, triangles);
+  compact.setPrecision(ObjectPlugin::Precision::Single);
+
+  std::vector<Ray> rays;
+  for (int i = 0; i < 3000; ++i) {
+    rays.push_back(randomMeshRay(rng));
+  }
+  // Rays from far away aimed at points of the small triangles, edges
+  // included, which the float test can only round badly.
+  for (std::size_t i = 300; i < triangles.size(); ++i) {
+    const MeshTriangle &triangle = triangles[i];
+    for (int j = 0; j < 50; ++j) {
+      double u = unit(rng);
+      double v = (1.0 - u) * unit(rng);
+      if (j % 2 == 0) {
+        v = 1.0 - u;
+      }
+      Point<3> target = triangle[0] + (triangle[1] - triangle[0]) * u +
+                        (triangle[2] - triangle[0]) * v;
+      Point<3> origin(1e4 * offset(rng), 1e4 * offset(rng), 1e4);
+      rays.emplace_back(origin, target - origin, 0.0,
+                        std::numeric_limits<double>::infinity());
+    }
+  }
+
+  int hits = 0;
+  for (const Ray &ray : rays) {
+    HitRecord expected;
+    HitRecord hit;
+    bool found = precise.findHit(ray, expected);
+
+    cr_assert_eq(compact.findHit(ray, hit), found,
+                 "Both precisions should agree on hits.");
+    cr_assert_eq(compact.occluded(ray), found,
+                 "Both precisions should agree on shadow rays.");
+    if (!found) {
+      continue;
+    }
+    ++hits;
+    cr_assert_eq(hit.t, expected.t, "Both precisions should agree on t.");
+    Vector<3> normal = compact.computeIntersection(ray, hit).getNormal();
+    Vector<3> reference =
+        precise.computeIntersection(ray, expected).getNormal();
+    for (std::size_t axis = 0; axis < 3; ++axis) {
+      cr_assert_eq(normal.m_components[axis],
+                   reference.m_components[axis],
+                   "Both precisions should agree on normals.");
+    }
+  }
+  cr_assert_gt(hits, 1000, "Most aimed rays should hit.");
+}
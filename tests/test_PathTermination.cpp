@@ -0,0 +1,60 @@
+/**
+ * @file test_PathTermination.cpp
+ * @brief Unit tests for the PathTermination rules.
+ */
+
+#include "../src/Core/PathTermination.hpp"
+#include <criterion/criterion.h>
+
+using Raytracer::Core::PathTermination;
+using Raytracer::Core::Sampler;
+
+Test(PathTerminationSuite, DefaultsKeepEveryRay) {
+  PathTermination termination;
+  Sampler sampler(0, 0);
+
+  cr_assert_not(termination.isEnabled());
+  cr_assert_eq(termination.survivalWeight(10, 1e-9, sampler), 1.0);
+  cr_assert_eq(sampler.getDimension(), 0u);
+}
+
+Test(PathTerminationSuite, CutoffDropsDimRays) {
+  PathTermination termination;
+  termination.minContribution = 0.05;
+  Sampler sampler(0, 0);
+
+  cr_assert(termination.isEnabled());
+  cr_assert_eq(termination.survivalWeight(1, 0.01, sampler), 0.0);
+  cr_assert_eq(termination.survivalWeight(1, 0.1, sampler), 1.0);
+}
+
+Test(PathTerminationSuite, RouletteWaitsForDepth) {
+  PathTermination termination;
+  termination.rouletteDepth = 3;
+  termination.rouletteThreshold = 0.5;
+  Sampler sampler(0, 0);
+
+  cr_assert_eq(termination.survivalWeight(2, 0.1, sampler), 1.0);
+  cr_assert_eq(termination.survivalWeight(3, 0.6, sampler), 1.0);
+  cr_assert_eq(sampler.getDimension(), 0u,
+               "No value should be drawn when roulette does not apply.");
+}
+
+Test(PathTerminationSuite, RouletteKeepsExpectedThroughput) {
+  PathTermination termination;
+  termination.rouletteDepth = 0;
+  termination.rouletteThreshold = 0.5;
+  const double throughput = 0.1;
+  const int samples = 4096;
+  double total = 0.0;
+
+  for (int i = 0; i < samples; ++i) {
+    Sampler sampler(7, static_cast<std::uint32_t>(i));
+    double weight = termination.survivalWeight(1, throughput, sampler);
+    cr_assert(weight == 0.0 || weight == 5.0);
+    total += throughput * weight;
+  }
+
+  cr_assert_float_eq(total / samples, throughput, 0.01,
+                     "Survivors should make up for the dropped rays.");
+}
@@ -0,0 +1,42 @@
+/**
+ * @file test_RaySort.cpp
+ * @brief Unit tests for the ray ordering of the wavefront path.
+ */
+
+#include "../src/Core/RaySort.hpp"
+#include <array>
+#include <criterion/criterion.h>
+#include <vector>
+
+using Raytracer::Core::Ray;
+using Raytracer::Core::sortRays;
+using Raytracer::Math::Point;
+using Raytracer::Math::Vector;
+
+Test(RaySortSuite, GroupsOctantsThenOrigins) {
+  const std::vector<Ray> rays = {
+      Ray(Point<3>(0.0, 0.0, 0.0), Vector<3>(-1.0, 1.0, 1.0)),
+      Ray(Point<3>(8.0, 8.0, 8.0), Vector<3>(1.0, 1.0, 1.0)),
+      Ray(Point<3>(0.0, 0.0, 0.0), Vector<3>(1.0, 1.0, 1.0)),
+      Ray(Point<3>(8.0, 8.0, 8.0), Vector<3>(-1.0, 1.0, 1.0)),
+      Ray(Point<3>(0.0, 0.0, 0.0), Vector<3>(1.0, 2.0, 1.0))};
+  const std::array<std::uint64_t, 5> expected = {2, 4, 1, 0, 3};
+  std::vector<std::uint64_t> order;
+
+  sortRays(rays, order);
+
+  cr_assert_eq(order.size(), rays.size());
+  for (std::size_t i = 0; i < expected.size(); ++i) {
+    cr_assert_eq(order[i] & 0xFFFFFFFFu, expected[i],
+                 "Rays should be ordered by octant, then origin cell, "
+                 "then input order.");
+  }
+}
+
+Test(RaySortSuite, EmptyBatchClearsOrder) {
+  std::vector<std::uint64_t> order = {1, 2, 3};
+
+  sortRays({}, order);
+
+  cr_assert(order.empty(), "Keys of a previous batch should not remain.");
+}
@@ -0,0 +1,134 @@
+/**
+ * @file test_RenderThreadPool.cpp
+ * @brief Unit tests for the RenderThreadPool class.
+ */
+
+#include "../src/Core/RenderThreadPool.hpp"
+#include <atomic>
+#include <chrono>
+#include <criterion/criterion.h>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using Raytracer::Core::CancellationToken;
+using Raytracer::Core::RenderThreadPool;
+
+Test(RenderThreadPoolSuite, RunCallsEveryIndexOnce) {
+  std::vector<std::atomic<int>> calls(100);
+
+  RenderThreadPool::getInstance().run(100, [&](unsigned int index) {
+    calls[index].fetch_add(1);
+  });
+
+  for (const auto &count : calls) {
+    cr_assert_eq(count.load(), 1);
+  }
+}
+
+Test(RenderThreadPoolSuite, RunRethrowsAfterEveryIndex) {
+  RenderThreadPool &pool = RenderThreadPool::getInstance();
+
+  for (unsigned int failing : {0u, 5u, 63u}) {
+    std::atomic<int> finished{0};
+    bool thrown = false;
+    try {
+      pool.run(64, [&](unsigned int index) {
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+        if (index == failing) {
+          throw std::runtime_error("task failed");
+        }
+        finished.fetch_add(1);
+      });
+    } catch (const std::runtime_error &) {
+      thrown = true;
+    }
+
+    cr_assert(thrown, "run() should rethrow the exception of a task.");
+    cr_assert_eq(finished.load(), 63,
+                 "Every other index should be done when run() throws.");
+  }
+
+  std::atomic<int> calls{0};
+  pool.run(16, [&](unsigned int) { calls.fetch_add(1); });
+  cr_assert_eq(calls.load(), 16, "The pool should survive a failed run.");
+}
+
+Test(RenderThreadPoolSuite, WorkersAreReused) {
+  RenderThreadPool &pool = RenderThreadPool::getInstance();
+  std::set<std::thread::id> threads;
+  std::mutex mutex;
+
+  for (int i = 0; i < 20; ++i) {
+    pool.run(8, [&](unsigned int) {
+      std::lock_guard lock(mutex);
+      threads.insert(std::this_thread::get_id());
+    });
+  }
+
+  cr_assert_leq(threads.size(), pool.getWorkerCount() + 1,
+                "Runs should only use pool threads and the caller.");
+}
+
+Test(RenderThreadPoolSuite, SubmittedJobCompletes) {
+  std::atomic<bool> ran{false};
+
+  std::future<void> job =
+      RenderThreadPool::getInstance().submit([&]() { ran = true; });
+
+  cr_assert(job.wait_for(std::chrono::seconds(5)) ==
+            std::future_status::ready);
+  cr_assert(ran.load());
+}
+
+Test(RenderThreadPoolSuite, NestedRunInsideJob) {
+  RenderThreadPool &pool = RenderThreadPool::getInstance();
+  std::atomic<int> calls{0};
+
+  std::future<void> job = pool.submit([&]() {
+    pool.run(pool.getWorkerCount() * 2,
+             [&](unsigned int) { calls.fetch_add(1); });
+  });
+
+  cr_assert(job.wait_for(std::chrono::seconds(5)) ==
+                std::future_status::ready,
+            "A job waiting on its own run should not deadlock.");
+  cr_assert_eq(calls.load(), static_cast<int>(pool.getWorkerCount() * 2));
+}
+
+Test(RenderThreadPoolSuite, CancelledJobIsSkipped) {
+  CancellationToken token;
+  std::atomic<bool> ran{false};
+
+  token.cancel();
+  std::future<void> job =
+      RenderThreadPool::getInstance().submit([&]() { ran = true; }, token);
+
+  job.wait();
+  cr_assert_not(ran.load());
+}
+
+Test(RenderThreadPoolSuite, TokenCopiesShareFlag) {
+  CancellationToken token;
+  CancellationToken copy = token;
+
+  cr_assert_not(copy.isCancelled());
+  token.cancel();
+  cr_assert(copy.isCancelled());
+  cr_assert(copy.getFlag()->load());
+}
+
+Test(RenderThreadPoolSuite, PinnedWorkersStillRun) {
+  RenderThreadPool &pool = RenderThreadPool::getInstance();
+  std::atomic<int> calls{0};
+
+  bool pinned = pool.setPinned(true);
+  cr_assert_eq(pool.isPinned(), pinned);
+  pool.run(16, [&](unsigned int) { calls.fetch_add(1); });
+  pool.setPinned(false);
+
+  cr_assert_eq(calls.load(), 16);
+  cr_assert_not(pool.isPinned());
+}
@@ -3,13 +3,181 @@
  * @brief Unit tests for the Renderer class.
  */
 
+#include "../src/Core/AMaterial.hpp"
+#include "../src/Core/APrimitive.hpp"
 #include "../src/Core/Renderer.hpp"
+#include "TestFixtures.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <criterion/criterion.h>
 #include <cstdio>
 #include <fstream>
+#include <memory>
 #include <string>
+#include <thread>
+#include <utility>
 
 using namespace Raytracer::Core;
+using Raytracer::Tests::TestSphere;
+
+class MockRendererWall : public APrimitive {
+public:
+  [[nodiscard]] std::optional<Intersection>
+  intersect(const Ray &ray) const noexcept override {
+    return Intersection(ray.getOrigin() + ray.getDirection(),
+                        ray.getDirection() * -1.0, getMaterial().get(), 1.0,
+                        false, {});
+  }
+
+  [[nodiscard]] BoundingBox getBoundingBox() const noexcept override {
+    return BoundingBox();
+  }
+};
+
+class MockBounceMaterial : public AMaterial {
+public:
+  explicit MockBounceMaterial(double value = 40.0) : m_value(value) {}
+
+  [[nodiscard]] ScatterResult
+  scatter(const Intersection &, const Ray &ray,
+          const std::vector<const ILight *> &, const Scene &,
+          RenderContext &) const override {
+    ScatterResult result{Color(m_value, m_value, m_value).toRadiance()};
+    if (ray.getDepth() < 3) {
+      Ray bounce(ray.getOrigin(), ray.getDirection(), 0.001, 100.0);
+      bounce.setDepth(ray.getDepth() + 1);
+      result.addRay(bounce, 0.5);
+    }
+    return result;
+  }
+
+private:
+  double m_value;
+};
+
+class MockMirrorMaterial : public AMaterial {
+public:
+  explicit MockMirrorMaterial(double value) : m_value(value) {}
+
+  [[nodiscard]] ScatterResult
+  scatter(const Intersection &hit, const Ray &ray,
+          const std::vector<const ILight *> &, const Scene &,
+          RenderContext &) const override {
+    ScatterResult result{
+        Color(m_value, m_value * 0.5, 255.0 - m_value).toRadiance()};
+    if (ray.getDepth() < 3) {
+      const Raytracer::Math::Vector<3> &normal = hit.getNormal();
+      Raytracer::Math::Vector<3> direction =
+          ray.getDirection() - normal * (2.0 * ray.getDirection().dot(normal));
+      Ray bounce(hit.getPoint(), direction, 0.001, 100.0);
+      bounce.setDepth(ray.getDepth() + 1);
+      result.addRay(bounce, 0.5);
+    }
+    return result;
+  }
+
+private:
+  double m_value;
+};
+
+class MockCancellingMaterial : public MockBounceMaterial {
+public:
+  explicit MockCancellingMaterial(std::atomic<bool> &cancel)
+      : m_cancel(cancel) {}
+
+  [[nodiscard]] ScatterResult
+  scatter(const Intersection &hit, const Ray &ray,
+          const std::vector<const ILight *> &lights, const Scene &scene,
+          RenderContext &context) const override {
+    m_cancel.store(true);
+    return MockBounceMaterial::scatter(hit, ray, lights, scene, context);
+  }
+
+private:
+  std::atomic<bool> &m_cancel;
+};
+
+class MockSlowMaterial : public AMaterial {
+public:
+  explicit MockSlowMaterial(std::chrono::milliseconds delay) : m_delay(delay) {}
+
+  [[nodiscard]] ScatterResult
+  scatter(const Intersection &hit, const Ray &,
+          const std::vector<const ILight *> &, const Scene &,
+          RenderContext &) const override {
+    std::this_thread::sleep_for(m_delay);
+    const Raytracer::Math::Point<3> &point = hit.getPoint();
+    return ScatterResult{
+        Color(point.m_components[0] * 200.0, point.m_components[1] * 200.0,
+              50.0)
+            .toRadiance()};
+  }
+
+private:
+  std::chrono::milliseconds m_delay;
+};
+
+class MockSamplerMaterial : public AMaterial {
+public:
+  [[nodiscard]] ScatterResult
+  scatter(const Intersection &hit, const Ray &ray,
+          const std::vector<const ILight *> &, const Scene &,
+          RenderContext &context) const override {
+    auto [red, green] = context.sampler.next2D();
+    ScatterResult result{
+        Color(red * 255.0, green * 255.0, 40.0).toRadiance()};
+    if (ray.getDepth() < 2) {
+      Ray bounce(hit.getPoint(), ray.getDirection(), 0.001, 100.0);
+      bounce.setDepth(ray.getDepth() + 1);
+      result.addRay(bounce, context.sampler.next1D());
+    }
+    return result;
+  }
+};
+
+/**
+ * @brief Fill a scene with mirror balls all around the camera.
+ *
+ * Reflected rays leave in every direction and from many places, and the
+ * ball silhouettes give adaptive supersampling edges to refine.
+ */
+void fillBallScene(Scene &scene) {
+  const std::array<std::array<double, 4>, 6> balls = {{{0.5, 0.5, 4.0, 1.0},
+                                                       {0.0, 0.0, 5.0, 1.0},
+                                                       {1.0, 1.0, 5.0, 1.5},
+                                                       {0.8, 0.2, 3.0, 0.5},
+                                                       {0.0, 0.0, -4.0, 2.0},
+                                                       {5.0, 0.5, 1.0, 1.5}}};
+  for (std::size_t i = 0; i < balls.size(); ++i) {
+    const auto &[x, y, z, radius] = balls[i];
+    auto ball = std::make_unique<TestSphere>(
+        Raytracer::Math::Point<3>(x, y, z), radius);
+    ball->setMaterial(std::make_shared<MockMirrorMaterial>(40.0 * i));
+    scene.addPrimitive("ball" + std::to_string(i), std::move(ball));
+  }
+  scene.compile();
+}
+
+/**
+ * @brief Render a scene with the depth-first path, then the wavefront one.
+ * @param renderer Renderer, left with the wavefront path enabled.
+ * @param scene Scene to render.
+ * @return Depth-first image, then wavefront image.
+ */
+std::pair<std::vector<uint8_t>, std::vector<uint8_t>>
+renderBothPaths(Renderer &renderer, const Scene &scene) {
+  const std::size_t size = renderer.getWidth() * renderer.getHeight() * 4;
+  std::vector<uint8_t> depthFirst(size, 0);
+  std::vector<uint8_t> wavefront(size, 0);
+
+  renderer.setTileSize(4);
+  renderer.setWavefront(false);
+  renderer.renderToBuffer(scene, depthFirst);
+  renderer.setWavefront(true);
+  renderer.renderToBuffer(scene, wavefront);
+  return {std::move(depthFirst), std::move(wavefront)};
+}
 
 bool fileExists(const std::string &filename) {
   std::ifstream f(filename.c_str());
@@ -41,3 +209,251 @@ Test(RendererSuite, SetDimensions) {
   cr_assert_eq(renderer.getHeight(), newHeight,
                "Height mismatch after setDimensions.");
 }
+
+Test(RendererSuite, ThreadCount) {
+  Renderer renderer(10, 10);
+
+  cr_assert_geq(renderer.getThreadCount(), 1);
+  renderer.setThreadCount(3);
+  cr_assert_eq(renderer.getThreadCount(), 3);
+  renderer.setThreadCount(Renderer::getMaxThreadCount() + 5);
+  cr_assert_eq(renderer.getThreadCount(), Renderer::getMaxThreadCount(),
+               "The thread count should not exceed what the pool runs.");
+  renderer.setMultithreading(false);
+  cr_assert_eq(renderer.getThreadCount(), 1,
+               "Disabling multithreading should override the thread count.");
+}
+
+Test(RendererSuite, ProgressivePassesPublishFrame) {
+  Renderer renderer(8, 6);
+  Scene scene;
+  std::vector<uint8_t> out(8 * 6 * 4, 0);
+  std::atomic<size_t> passes{0};
+
+  renderer.setProgressive(true, 3);
+  renderer.renderToBuffer(scene, out, nullptr, nullptr, &passes);
+
+  cr_assert_eq(passes.load(), 3);
+  for (size_t i = 3; i < out.size(); i += 4) {
+    cr_assert_eq(out[i], 255, "Every pixel should be published.");
+  }
+}
+
+Test(RendererSuite, CancelledProgressiveRender) {
+  Renderer renderer(8, 6);
+  Scene scene;
+  std::vector<uint8_t> out(8 * 6 * 4, 0);
+  std::atomic<bool> cancel{true};
+  std::atomic<size_t> passes{0};
+
+  renderer.setProgressive(true);
+  renderer.renderToBuffer(scene, out, &cancel, nullptr, &passes);
+
+  cr_assert_eq(passes.load(), 0);
+  cr_assert_eq(out[3], 0, "No pixel should be written once cancelled.");
+}
+
+Test(RendererSuite, AdaptiveSamplingSharesCorners) {
+  Renderer renderer(2, 2);
+  Scene scene;
+  std::vector<uint8_t> out(2 * 2 * 4, 0);
+
+  renderer.setAdaptiveSupersampling(true, 0, 20.0);
+  renderer.renderToBuffer(scene, out);
+
+  const SamplingStats &stats = renderer.getLastSamplingStats();
+  cr_assert_eq(stats.raysTraced, 13, "3x3 corners and 4 centers expected.");
+  cr_assert_eq(stats.raysSaved, 7);
+}
+
+Test(RendererSuite, AdaptiveSamplingIgnoresPartialTiles) {
+  Renderer renderer(13, 11);
+  Scene scene;
+  fillBallScene(scene);
+  std::vector<uint8_t> singleTile(13 * 11 * 4, 0);
+  std::vector<uint8_t> tiled(13 * 11 * 4, 0);
+
+  renderer.setAdaptiveSupersampling(true, 2, 20.0);
+  renderer.setTileSize(16);
+  renderer.renderToBuffer(scene, singleTile);
+  const std::size_t singleTileRays = renderer.getLastSamplingStats().raysTraced;
+  renderer.setTileSize(4);
+  renderer.renderToBuffer(scene, tiled);
+
+  cr_assert_gt(singleTileRays, 14 * 12 + 13 * 11,
+               "Ball edges should be refined past pixel corners and centers.");
+  cr_assert_gt(renderer.getLastSamplingStats().raysTraced, singleTileRays,
+               "Corners on tile borders should be traced once per tile.");
+  cr_assert(singleTile == tiled,
+            "Partial tiles should not change the image.");
+}
+
+Test(RendererSuite, TimeBudgetCompletesFrame) {
+  Renderer renderer(16, 16);
+  Scene scene;
+  std::vector<uint8_t> out(16 * 16 * 4, 0);
+  std::atomic<size_t> passes{0};
+
+  renderer.setTimeBudget(std::chrono::milliseconds(1000));
+  renderer.renderToBuffer(scene, out, nullptr, nullptr, &passes);
+
+  cr_assert_geq(passes.load(), 1, "The coarse pass should always finish.");
+  cr_assert_eq(renderer.getLastPassCount(), passes.load());
+  for (size_t i = 3; i < out.size(); i += 4) {
+    cr_assert_eq(out[i], 255, "Every pixel should be written.");
+  }
+}
+
+Test(RendererSuite, TimeBudgetFallsBackToCoarsePass) {
+  Renderer renderer(16, 16);
+  Scene slow;
+  Scene fast;
+  auto slowWall = std::make_unique<MockRendererWall>();
+  slowWall->setMaterial(
+      std::make_shared<MockSlowMaterial>(std::chrono::milliseconds(2)));
+  slow.addPrimitive("wall", std::move(slowWall));
+  auto fastWall = std::make_unique<MockRendererWall>();
+  fastWall->setMaterial(
+      std::make_shared<MockSlowMaterial>(std::chrono::milliseconds(0)));
+  fast.addPrimitive("wall", std::move(fastWall));
+  std::vector<uint8_t> reference(16 * 16 * 4, 0);
+  std::vector<uint8_t> out(16 * 16 * 4, 0);
+  std::atomic<size_t> passes{0};
+
+  renderer.renderToBuffer(fast, reference);
+  // Every coarse block alone takes longer than the whole budget.
+  renderer.setTimeBudget(std::chrono::milliseconds(1));
+  renderer.renderToBuffer(slow, out, nullptr, nullptr, &passes);
+
+  cr_assert_eq(passes.load(), 1, "Only the coarse pass should finish.");
+  cr_assert_eq(renderer.getLastPassCount(), 1);
+  cr_assert(out != reference, "The frame should not be refined.");
+  for (size_t y = 0; y < 16; ++y) {
+    for (size_t x = 0; x < 16; ++x) {
+      const size_t block = ((y / 4 * 4) * 16 + x / 4 * 4) * 4;
+      for (size_t channel = 0; channel < 4; ++channel) {
+        cr_assert_eq(out[(y * 16 + x) * 4 + channel],
+                     reference[block + channel],
+                     "Each 4x4 block should show its corner pixel.");
+      }
+    }
+  }
+}
+
+Test(RendererSuite, SampledImageIndependentOfScheduling) {
+  Renderer renderer(21, 13);
+  Scene scene;
+  auto wall = std::make_unique<MockRendererWall>();
+  wall->setMaterial(std::make_shared<MockSamplerMaterial>());
+  scene.addPrimitive("wall", std::move(wall));
+  std::vector<uint8_t> reference(21 * 13 * 4, 0);
+
+  renderer.setTileSize(4);
+  renderer.setMultithreading(true);
+  renderer.setThreadCount(1);
+  renderer.setTileOrder(TileOrder::Scanline);
+  renderer.renderToBuffer(scene, reference);
+
+  cr_assert(std::any_of(reference.begin(), reference.end(),
+                        [&](uint8_t value) { return value != reference[0]; }),
+            "Pixels should draw different sample values.");
+  for (unsigned int threads : {1u, 4u, 8u}) {
+    for (TileOrder order : {TileOrder::Scanline, TileOrder::Morton}) {
+      std::vector<uint8_t> out(reference.size(), 0);
+      renderer.setThreadCount(threads);
+      renderer.setTileOrder(order);
+      renderer.renderToBuffer(scene, out);
+      cr_assert(out == reference,
+                "Thread count and tile order should not change the image.");
+    }
+  }
+}
+
+Test(RendererSuite, TraceRayFollowsScatteredRays) {
+  Renderer renderer(2, 2);
+  Scene scene;
+  auto wall = std::make_unique<MockRendererWall>();
+  wall->setMaterial(std::make_shared<MockBounceMaterial>());
+  scene.addPrimitive("wall", std::move(wall));
+  std::vector<uint8_t> out(2 * 2 * 4, 0);
+
+  renderer.renderToBuffer(scene, out);
+
+  cr_assert_eq(out[0], 75, "Each bounce should add its color times its "
+                           "weight: 40 * (1 + 0.5 + 0.25 + 0.125).");
+}
+
+Test(RendererSuite, ScatterResultKeepsMaxRays) {
+  ScatterResult result;
+  Ray ray;
+
+  for (std::size_t i = 0; i <= ScatterResult::MAX_RAYS; ++i) {
+    result.addRay(ray, 1.0);
+  }
+
+  cr_assert_eq(result.rayCount, ScatterResult::MAX_RAYS);
+}
+
+Test(RendererSuite, ProgressiveSaturatesBrightPixels) {
+  Renderer renderer(2, 2);
+  Scene scene;
+  auto wall = std::make_unique<MockRendererWall>();
+  wall->setMaterial(std::make_shared<MockBounceMaterial>(200.0));
+  scene.addPrimitive("wall", std::move(wall));
+  std::vector<uint8_t> out(2 * 2 * 4, 0);
+
+  renderer.setProgressive(true, 2);
+  renderer.renderToBuffer(scene, out);
+
+  cr_assert_eq(out[0], 255, "Radiance above 255 should saturate, not wrap.");
+}
+
+Test(RendererSuite, WavefrontMatchesDepthFirst) {
+  Renderer renderer(6, 5);
+  Scene scene;
+  auto wall = std::make_unique<MockRendererWall>();
+  wall->setMaterial(std::make_shared<MockBounceMaterial>());
+  scene.addPrimitive("wall", std::move(wall));
+
+  auto [depthFirst, wavefront] = renderBothPaths(renderer, scene);
+
+  cr_assert(renderer.isWavefront());
+  cr_assert(depthFirst == wavefront,
+            "Both render paths should produce the same image.");
+  cr_assert_eq(wavefront[0], 75);
+}
+
+Test(RendererSuite, SortedWavefrontMatchesDepthFirst) {
+  Renderer renderer(13, 11);
+  Scene scene;
+  fillBallScene(scene);
+  renderer.setRaySorting(true);
+
+  auto [depthFirst, sorted] = renderBothPaths(renderer, scene);
+
+  cr_assert(renderer.isRaySorting());
+  cr_assert(depthFirst == sorted,
+            "Sorting secondary rays should not change the image.");
+  cr_assert(std::any_of(sorted.begin(), sorted.end(),
+                        [&](uint8_t value) { return value != sorted[0]; }),
+            "The balls should not all shade alike.");
+}
+
+Test(RendererSuite, CancelledWavefrontStopsBetweenBounces) {
+  Renderer renderer(6, 5);
+  Scene scene;
+  std::atomic<bool> cancel{false};
+  auto wall = std::make_unique<MockRendererWall>();
+  wall->setMaterial(std::make_shared<MockCancellingMaterial>(cancel));
+  scene.addPrimitive("wall", std::move(wall));
+  std::vector<uint8_t> out(6 * 5 * 4, 0);
+
+  renderer.setWavefront(true);
+  renderer.renderToBuffer(scene, out, &cancel);
+
+  cr_assert(cancel.load());
+  for (size_t i = 3; i < out.size(); i += 4) {
+    cr_assert_eq(out[i], 0, "A tile cancelled mid-path should not be "
+                            "written.");
+  }
+}
@@ -4,6 +4,7 @@
  */
 
 #include "../src/Core/ALight.hpp"
+#include "../src/Core/AMaterial.hpp"
 #include "../src/Core/APrimitive.hpp"
 #include "../src/Core/BoundingBox.hpp"
 #include "../src/Core/Camera.hpp"
@@ -14,6 +15,7 @@
 #include "../src/Math/Rectangle.hpp"
 #include "../src/Math/Vector.hpp"
 #include "Core/IPrimitive.hpp"
+#include <algorithm>
 #include <array>
 #include <criterion/criterion.h>
 #include <memory>
@@ -54,6 +56,16 @@ public:
   [[nodiscard]] bool castsShadow() const noexcept override { return true; }
 };
 
+class MockSceneMaterial : public Raytracer::Core::AMaterial {
+public:
+  [[nodiscard]] Raytracer::Core::ScatterResult
+  scatter(const Intersection &, const Ray &,
+          const std::vector<const ILight *> &, const Scene &,
+          Raytracer::Core::RenderContext &) const override {
+    return {Color(0, 0, 0).toRadiance()};
+  }
+};
+
 template <std::size_t N>
 void assert_point_eq(const Raytracer::Math::Point<N> &p,
                      const std::array<double, N> &ref, double eps = EQ_APPROX) {
@@ -104,7 +116,7 @@ Test(SceneSuite, AddAndGetPrimitive) {
   cr_assert_eq(scene.getPrimitives().size(), 1,
                "Primitive count should be 1 after add.");
 
-  IPrimitive *retrievedPrimitivePtr = scene.getPrimitive(id1);
+  const IPrimitive *retrievedPrimitivePtr = scene.getPrimitive(id1);
 
   cr_assert_not_null(retrievedPrimitivePtr,
                      "Failed to retrieve existing primitive pointer.");
@@ -176,7 +188,7 @@ Test(SceneSuite, AddAndGetLight) {
                  "Original light unique_ptr should be null after move.");
   cr_assert_eq(scene.getLights().size(), 1, "Light count should be 1.");
 
-  ILight *retrievedLightPtr = scene.getLight(id1);
+  const ILight *retrievedLightPtr = scene.getLight(id1);
 
   cr_assert_not_null(retrievedLightPtr, "Failed to get light pointer.");
   cr_assert_eq(retrievedLightPtr, light1RawPtr,
@@ -316,3 +328,49 @@ Test(SceneSuite, GetContainers) {
   cr_assert(primitives.find("non_existent_prim") == primitives.end());
   cr_assert(lights.find("non_existent_light") == lights.end());
 }
+
+Test(SceneSuite, CompileFlattensLights) {
+  Scene scene;
+  auto light = std::make_unique<MockDirectionalLight>();
+  const ILight *lightPtr = light.get();
+  scene.addLight("light", std::move(light));
+  auto child = std::make_unique<Scene>();
+  auto childLight = std::make_unique<MockDirectionalLight>();
+  const ILight *childLightPtr = childLight.get();
+  child->addLight("light", std::move(childLight));
+  scene.addChildScene("child", std::move(child));
+
+  cr_assert(scene.getLightList().empty(),
+            "An uncompiled scene should not expose a light list.");
+  scene.compile();
+
+  const auto &lights = scene.getLightList();
+  cr_assert_eq(lights.size(), 2);
+  cr_assert_eq(lights[0], lightPtr);
+  cr_assert_eq(lights[1], childLightPtr);
+
+  scene.removeLight("light");
+  cr_assert_not(scene.isCompiled(),
+                "Removing a light should invalidate the snapshot.");
+}
+
+Test(SceneSuite, CompileListsDistinctMaterials) {
+  Scene scene;
+  auto shared = std::make_shared<MockSceneMaterial>();
+  auto other = std::make_shared<MockSceneMaterial>();
+  for (int i = 0; i < 3; ++i) {
+    auto primitive = std::make_unique<MockPrimitive>();
+    primitive->setMaterial(i == 2 ? other : shared);
+    scene.addPrimitive("primitive" + std::to_string(i), std::move(primitive));
+  }
+  scene.addPrimitive("bare", std::make_unique<MockPrimitive>());
+  scene.compile();
+
+  const auto &materials = scene.getMaterialList();
+  cr_assert_eq(materials.size(), 2,
+               "Each material should be listed once, without nullptr.");
+  cr_assert(std::find(materials.begin(), materials.end(), shared.get()) !=
+            materials.end());
+  cr_assert(std::find(materials.begin(), materials.end(), other.get()) !=
+            materials.end());
+}
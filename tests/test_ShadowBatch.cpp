@@ -0,0 +1,107 @@
+/**
+ * @file test_ShadowBatch.cpp
+ * @brief Unit tests for the ShadowBatch class.
+ */
+
+#include "../src/Core/Scene.hpp"
+#include "../src/Core/ShadowBatch.hpp"
+#include "TestFixtures.hpp"
+#include <criterion/criterion.h>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using Raytracer::Core::Radiance;
+using Raytracer::Core::Ray;
+using Raytracer::Core::Scene;
+using Raytracer::Core::ShadowBatch;
+using Raytracer::Math::Point;
+using Raytracer::Math::Vector;
+using Raytracer::Tests::TestPointLight;
+using Raytracer::Tests::TestSphere;
+
+namespace {
+
+Ray shadowRay(const Point<3> &origin, const Point<3> &target) {
+  Vector<3> toTarget = target - origin;
+  double distance = toTarget.length();
+  return Ray(origin, toTarget / distance, 1e-4, distance);
+}
+
+} // namespace
+
+Test(ShadowBatchSuite, EmptyBatchKeepsColor) {
+  ShadowBatch batch;
+  Scene scene;
+  scene.compile();
+  batch.trace(scene);
+  Radiance radiance{10.0, 20.0, 30.0};
+  batch.resolve(radiance, 0, 0);
+
+  cr_assert_eq(batch.size(), 0u);
+  cr_assert_eq(radiance[0], 10.0);
+  cr_assert_eq(radiance[1], 20.0);
+  cr_assert_eq(radiance[2], 30.0);
+}
+
+Test(ShadowBatchSuite, MatchesSingleRayTests) {
+  Scene scene;
+  std::mt19937 rng(19);
+  std::uniform_real_distribution<double> position(-6.0, 6.0);
+  std::uniform_real_distribution<double> radius(0.3, 1.2);
+  for (int i = 0; i < 40; ++i) {
+    scene.addPrimitive("sphere" + std::to_string(i),
+                       std::make_unique<TestSphere>(
+                           Point<3>(position(rng), position(rng),
+                                    position(rng)),
+                           radius(rng)));
+  }
+  scene.compile();
+  std::vector<std::unique_ptr<TestPointLight>> lights;
+  for (int i = 0; i < 3; ++i) {
+    lights.push_back(std::make_unique<TestPointLight>(
+        Point<3>(position(rng), position(rng), position(rng))));
+  }
+
+  ShadowBatch batch;
+  std::vector<std::size_t> firsts;
+  std::vector<std::size_t> lasts;
+  std::vector<Radiance> expected;
+  int shadowed = 0;
+  for (int hit = 0; hit < 100; ++hit) {
+    Point<3> origin(position(rng), position(rng), position(rng));
+    Radiance sum{1.0, 0.0, 0.0};
+    firsts.push_back(batch.size());
+    batch.add(Radiance{1.0, 0.0, 0.0});
+    for (std::size_t l = 0; l < lights.size(); ++l) {
+      Ray ray = shadowRay(origin, lights[(hit + l) % lights.size()]
+                                      ->getPosition());
+      Radiance term{0.0, 1.0 + static_cast<double>(l), 0.5};
+      batch.add(term, ray, *lights[(hit + l) % lights.size()]);
+      if (scene.hasIntersection(ray)) {
+        ++shadowed;
+      } else {
+        for (std::size_t c = 0; c < sum.size(); ++c) {
+          sum[c] += term[c];
+        }
+      }
+    }
+    lasts.push_back(batch.size());
+    expected.push_back(sum);
+  }
+  batch.trace(scene);
+
+  cr_assert_gt(shadowed, 0, "Some shadow rays should be blocked.");
+  cr_assert_lt(shadowed, 300, "Some shadow rays should reach their light.");
+  for (std::size_t i = 0; i < expected.size(); ++i) {
+    Radiance radiance{};
+    batch.resolve(radiance, firsts[i], lasts[i]);
+    cr_assert_eq(radiance[0], expected[i][0],
+                 "Terms without a shadow ray should always count.");
+    cr_assert_eq(radiance[1], expected[i][1],
+                 "Batched shadow rays should match single ray tests.");
+    cr_assert_eq(radiance[2], expected[i][2],
+                 "Batched shadow rays should match single ray tests.");
+  }
+}
@@ -0,0 +1,114 @@
+/**
+ * @file test_TileScheduler.cpp
+ * @brief Unit tests for the TileScheduler class.
+ */
+
+#include "../src/Core/TileScheduler.hpp"
+#include <atomic>
+#include <criterion/criterion.h>
+#include <mutex>
+#include <vector>
+
+using Raytracer::Core::Tile;
+using Raytracer::Core::TileOrder;
+using Raytracer::Core::TileScheduler;
+using Raytracer::Core::WorkerStats;
+
+static std::vector<int> coverage(const std::vector<Tile> &tiles,
+                                 std::size_t width, std::size_t height) {
+  std::vector<int> counts(width * height, 0);
+  for (const Tile &tile : tiles) {
+    for (std::size_t y = tile.y0; y < tile.y1; ++y) {
+      for (std::size_t x = tile.x0; x < tile.x1; ++x) {
+        ++counts[y * width + x];
+      }
+    }
+  }
+  return counts;
+}
+
+Test(TileSchedulerSuite, TilesCoverImageOnce) {
+  for (TileOrder order :
+       {TileOrder::Scanline, TileOrder::Morton, TileOrder::CenterOut}) {
+    TileScheduler scheduler(37, 21, 8, order);
+
+    cr_assert_eq(scheduler.getTiles().size(), 15);
+    for (int count : coverage(scheduler.getTiles(), 37, 21)) {
+      cr_assert_eq(count, 1, "Every pixel should belong to exactly one tile.");
+    }
+  }
+}
+
+Test(TileSchedulerSuite, ScanlineOrder) {
+  TileScheduler scheduler(32, 32, 16, TileOrder::Scanline);
+  const auto &tiles = scheduler.getTiles();
+
+  cr_assert_eq(tiles[1].x0, 16);
+  cr_assert_eq(tiles[1].y0, 0);
+  cr_assert_eq(tiles[2].x0, 0);
+  cr_assert_eq(tiles[2].y0, 16);
+}
+
+Test(TileSchedulerSuite, MortonOrder) {
+  TileScheduler scheduler(64, 64, 16, TileOrder::Morton);
+  const auto &tiles = scheduler.getTiles();
+
+  cr_assert_eq(tiles[2].x0, 0, "Morton order should finish a 2x2 block "
+                               "before moving right.");
+  cr_assert_eq(tiles[2].y0, 16);
+  cr_assert_eq(tiles[4].x0, 32);
+  cr_assert_eq(tiles[4].y0, 0);
+}
+
+Test(TileSchedulerSuite, CenterOutOrder) {
+  TileScheduler scheduler(90, 90, 30, TileOrder::CenterOut);
+  const Tile &first = scheduler.getTiles().front();
+
+  cr_assert_eq(first.x0, 30, "The central tile should come first.");
+  cr_assert_eq(first.y0, 30);
+}
+
+Test(TileSchedulerSuite, RunVisitsEveryTileOnce) {
+  TileScheduler scheduler(100, 60, 7, TileOrder::Morton);
+  std::vector<Tile> visited;
+  std::mutex mutex;
+
+  std::vector<WorkerStats> stats = scheduler.run(4, [&](const Tile &tile) {
+    std::lock_guard lock(mutex);
+    visited.push_back(tile);
+  });
+
+  cr_assert_eq(stats.size(), 4);
+  std::size_t tiles = 0;
+  for (const WorkerStats &worker : stats) {
+    tiles += worker.tiles;
+  }
+  cr_assert_eq(tiles, scheduler.getTiles().size());
+  for (int count : coverage(visited, 100, 60)) {
+    cr_assert_eq(count, 1);
+  }
+}
+
+Test(TileSchedulerSuite, CancelStopsRun) {
+  TileScheduler scheduler(64, 64, 8, TileOrder::Scanline);
+  std::atomic<bool> cancel{false};
+  std::size_t calls = 0;
+
+  std::vector<WorkerStats> stats = scheduler.run(
+      1,
+      [&](const Tile &) {
+        ++calls;
+        cancel = true;
+      },
+      &cancel);
+
+  cr_assert_eq(calls, 1, "No tile should start after cancellation.");
+  cr_assert_eq(stats[0].tiles, 1);
+}
+
+Test(TileSchedulerSuite, ParseOrder) {
+  cr_assert(TileScheduler::parseOrder("morton") == TileOrder::Morton);
+  cr_assert(TileScheduler::parseOrder("center") == TileOrder::CenterOut);
+  cr_assert(TileScheduler::parseOrder("scanline") == TileOrder::Scanline);
+  cr_assert_not(TileScheduler::parseOrder("spiral").has_value());
+}
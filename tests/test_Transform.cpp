@@ -1,3 +1,4 @@
+#include "../src/Core/APrimitive.hpp"
 #include "../src/Core/Ray.hpp"
 #include "../src/Math/Transform.hpp"
 #include <criterion/criterion.h>
@@ -25,6 +26,31 @@ void assert_vector_equal(const Vector<3> &a, const Vector<3> &b) {
   }
 }
 
+void assert_transform_equal(const Transform &a, const Transform &b) {
+  for (size_t i = 0; i < 3; i++) {
+    for (size_t j = 0; j < 4; j++) {
+      cr_assert_float_eq(a.getMatrix()(i, j), b.getMatrix()(i, j), EQ_APPROX,
+                         "Element (%zu, %zu) mismatch", i, j);
+      cr_assert_float_eq(a.getInverse()(i, j), b.getInverse()(i, j),
+                         EQ_APPROX, "Inverse element (%zu, %zu) mismatch", i,
+                         j);
+    }
+  }
+}
+
+class TransformTestPrimitive : public Raytracer::Core::APrimitive {
+public:
+  [[nodiscard]] std::optional<Raytracer::Core::Intersection>
+  intersect(const Ray &) const noexcept override {
+    return std::nullopt;
+  }
+
+  [[nodiscard]] Raytracer::Core::BoundingBox
+  getBoundingBox() const noexcept override {
+    return Raytracer::Core::BoundingBox();
+  }
+};
+
 Test(TransformSuite, DefaultConstructor) {
   Transform t;
   Point<3> p(1.0, 2.0, 3.0);
@@ -82,4 +108,74 @@ Test(TransformSuite, RayTransformation) {
   Ray inverseRay = t.inverseTransformRay(ray);
   assert_point_equal(inverseRay.getOrigin(), Point<3>(0.0, 0.0, -5.0));
   assert_vector_equal(inverseRay.getDirection(), direction);
-}
\ No newline at end of file
+}
+
+Test(TransformSuite, ShearedCompositeInverse) {
+  Transform t = Transform::translate(1.0, -2.0, 3.0) *
+                Transform::shear(0.3, 0.0, 0.2, 0.5, 0.0, -0.4) *
+                Transform::rotate(0.3, -1.1, 2.0) *
+                Transform::scale(2.0, 0.5, 3.0);
+  Raytracer::Math::Affine product = t.getMatrix() * t.getInverse();
+
+  for (size_t i = 0; i < 3; i++) {
+    for (size_t j = 0; j < 4; j++) {
+      cr_assert_float_eq(product(i, j), i == j ? 1.0 : 0.0, EQ_APPROX,
+                         "Element (%zu, %zu) of M * M^-1 is %f", i, j,
+                         product(i, j));
+    }
+  }
+
+  Point<3> p(-4.0, 0.5, 7.0);
+  assert_point_equal(t.inverse().transformPoint(t.transformPoint(p)), p);
+}
+
+Test(TransformSuite, AffineInverseMatchesCofactorInverse) {
+  Transform t = Transform::shear(0.3, -0.7, 0.2, 0.5, 0.1, -0.4) *
+                Transform::translate(3.0, 1.0, -2.0);
+  Raytracer::Math::Matrix4 expected = t.getMatrix().toMatrix().inverse();
+  Raytracer::Math::Affine inverse = t.getMatrix().inverse();
+
+  for (size_t i = 0; i < 3; i++) {
+    for (size_t j = 0; j < 4; j++) {
+      cr_assert_float_eq(inverse(i, j), expected(i, j), EQ_APPROX);
+    }
+  }
+}
+
+Test(TransformSuite, NormalsStayPerpendicularToSurface) {
+  Transform t = Transform::shear(0.0, 0.6, 0.0, 0.0, 0.0, 0.0) *
+                Transform::scale(3.0, 1.0, 0.5);
+  Vector<3> normal = Vector<3>(1.0, 1.0, 1.0).normalize();
+  Vector<3> tangents[2] = {Vector<3>(1.0, -1.0, 0.0),
+                           Vector<3>(0.0, 1.0, -1.0)};
+
+  Vector<3> worldNormal = t.transformNormal(normal);
+  cr_assert_float_eq(worldNormal.length(), 1.0, EQ_APPROX);
+  for (const auto &tangent : tangents) {
+    cr_assert_float_eq(worldNormal.dot(t.transformVector(tangent)), 0.0,
+                       EQ_APPROX);
+  }
+}
+
+Test(TransformSuite, PrimitiveSettersRecomposeTransform) {
+  TransformTestPrimitive primitive;
+  primitive.setPosition(Point<3>(1.0, -2.0, 3.0));
+  primitive.setShear(
+      Raytracer::Math::Vector<6>(0.3, 0.0, 0.2, 0.5, 0.0, -0.4));
+  primitive.setRotation(Vector<3>(0.3, -1.1, 2.0));
+  primitive.setScale(Vector<3>(2.0, 0.5, 3.0));
+
+  assert_transform_equal(
+      primitive.getTransform(),
+      Transform::translate(1.0, -2.0, 3.0) *
+          Transform::shear(0.3, 0.0, 0.2, 0.5, 0.0, -0.4) *
+          Transform::rotate(0.3, -1.1, 2.0) * Transform::scale(2.0, 0.5, 3.0));
+
+  primitive.setScale(Vector<3>(1.0, 4.0, 0.25));
+  assert_transform_equal(
+      primitive.getTransform(),
+      Transform::translate(1.0, -2.0, 3.0) *
+          Transform::shear(0.3, 0.0, 0.2, 0.5, 0.0, -0.4) *
+          Transform::rotate(0.3, -1.1, 2.0) *
+          Transform::scale(1.0, 4.0, 0.25));
+}
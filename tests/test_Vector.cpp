@@ -1,8 +1,11 @@
 #include "../src/Math/Vector.hpp"
+#include "../src/Math/Vector3x4.hpp"
 #include <cmath>
 #include <criterion/criterion.h>
 
 using Raytracer::Math::Vector;
+using Raytracer::Math::Simd::Double4;
+using Raytracer::Math::Simd::Vector3x4;
 
 static constexpr double EQ_APPROX = 1e-9;
 
@@ -94,3 +97,44 @@ Test(VectorSuite, DotProduct) {
   cr_assert_float_eq(a.dot(b), expected, EQ_APPROX, "Expected dot %g, got %g",
                      expected, a.dot(b));
 }
+
+Test(VectorSuite, FourComponentOperations) {
+  Vector<4> a(1.0, -2.0, 3.5, 0.25);
+  Vector<4> b(0.5, 2.0, -1.5, 4.0);
+
+  assert_vector_eq(a + b, {1.5, 0.0, 2.0, 4.25});
+  assert_vector_eq(a - b, {0.5, -4.0, 5.0, -3.75});
+  assert_vector_eq(a * b, {0.5, -4.0, -5.25, 1.0});
+  assert_vector_eq(a * 2.0, {2.0, -4.0, 7.0, 0.5});
+  assert_vector_eq(a / 2.0, {0.5, -1.0, 1.75, 0.125});
+  cr_assert_float_eq(a.dot(b), 0.5 - 4.0 - 5.25 + 1.0, EQ_APPROX);
+  cr_assert_float_eq(a.squaredNorm(), 1.0 + 4.0 + 12.25 + 0.0625,
+                     EQ_APPROX);
+}
+
+Test(VectorSuite, WideLanesMatchScalarVectors) {
+  const std::array<Vector<3>, 4> lhs{
+      Vector<3>(1.0, 2.0, 3.0), Vector<3>(-0.5, 0.25, 4.0),
+      Vector<3>(0.1, -0.2, 0.3), Vector<3>(7.0, 0.0, -1.0)};
+  const Vector<3> rhs(0.3, -1.7, 2.2);
+  std::array<double, 4> xs;
+  std::array<double, 4> ys;
+  std::array<double, 4> zs;
+  for (std::size_t i = 0; i < 4; ++i) {
+    xs[i] = lhs[i].m_components[0];
+    ys[i] = lhs[i].m_components[1];
+    zs[i] = lhs[i].m_components[2];
+  }
+
+  const Vector3x4 wide = Vector3x4::load(xs.data(), ys.data(), zs.data());
+  const Vector3x4 cross = wide.cross(Vector3x4(rhs));
+  const Double4 dot = wide.dot(Vector3x4(rhs));
+  for (std::size_t i = 0; i < 4; ++i) {
+    const Vector<3> expected = lhs[i].cross(rhs);
+    cr_assert_eq(cross.x[i], expected.m_components[0]);
+    cr_assert_eq(cross.y[i], expected.m_components[1]);
+    cr_assert_eq(cross.z[i], expected.m_components[2]);
+    cr_assert_eq(dot[i], lhs[i].dot(rhs));
+  }
+  cr_assert_eq((dot > Double4(0.0)).mask(), 0b0111u);
+}